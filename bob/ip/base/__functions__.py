@@ -1,6 +1,8 @@
 import math
 import numpy
 
+from ._library import _flip, _flop
+
 def angle_to_horizontal(right, left):
   """angle_to_horizontal(right, left) -> angle
 
@@ -20,11 +22,24 @@ def angle_to_horizontal(right, left):
   return math.atan2(right[0] - left[0], right[1] - left[1]) * 180. / math.pi
 
 
+# the data types that are flipped by the C++ implementation
+_flip_types = set(numpy.dtype(t) for t in (numpy.bool_, numpy.uint8, numpy.uint16, numpy.uint32, numpy.uint64, numpy.int8, numpy.int16, numpy.int32, numpy.int64, numpy.float32, numpy.float64))
+
+def _flip_in_cxx(src, dst):
+  """Checks if the given images can be flipped by the C++ implementation"""
+  return isinstance(src, numpy.ndarray) and src.ndim in (2, 3) and src.dtype in _flip_types and \
+      (dst is None or (isinstance(dst, numpy.ndarray) and dst.ndim == src.ndim and dst.dtype == src.dtype))
+
+
 def flip(src, dst = None):
   """flip(src, [dst]) -> dst
 
   Flip a 2D or 3D array/image upside-down.
   If given, the destination array ``dst`` should have the same size and type as the source array.
+  When ``dst`` is ``src``, the image is flipped in place.
+
+  2D and 3D images of boolean, integral, float32 and float64 type are flipped in C++.
+  All other arrays are flipped using numpy; for arrays with more dimensions, the second last dimension is flipped.
 
   **Parameters**
 
@@ -39,6 +54,8 @@ def flip(src, dst = None):
   ``dst`` : *array_like (2D or 3D)*
     The flipped image
   """
+  if _flip_in_cxx(src, dst):
+    return _flip(src, dst) if dst is not None else _flip(src)
   if dst is None:
     dst = numpy.ndarray(src.shape, src.dtype)
   dst[...,:,:] = src[...,::-1,:]
@@ -50,6 +67,10 @@ def flop(src, dst = None):
 
   Flip a 2D or 3D array/image left-right.
   If given, the destination array ``dst`` should have the same size and type as the source array.
+  When ``dst`` is ``src``, the image is flipped in place.
+
+  2D and 3D images of boolean, integral, float32 and float64 type are flipped in C++.
+  All other arrays are flipped using numpy; for arrays with more dimensions, the last dimension is flipped.
 
   **Parameters**
 
@@ -64,6 +85,8 @@ def flop(src, dst = None):
   ``dst`` : *array_like (2D or 3D)*
     The flipped image
   """
+  if _flip_in_cxx(src, dst):
+    return _flop(src, dst) if dst is not None else _flop(src)
   if dst is None:
     dst = numpy.ndarray(src.shape, src.dtype)
   dst[...,:] = src[...,::-1]
@@ -10,6 +10,21 @@
 
 #include "main.h"
 
+// Scale algorithm conversion
+static const std::map<std::string, bob::ip::base::ScaleAlgorithm> A = {{"bilinear", bob::ip::base::SCALE_BILINEAR}, {"area", bob::ip::base::SCALE_AREA}};
+static inline bob::ip::base::ScaleAlgorithm a(const std::string& o){     /* converts string to scale algorithm */
+  auto it = A.find(o);
+  if (it == A.end()) throw std::runtime_error("The given scale algorithm '" + o + "' is not known; choose one of ('bilinear', 'area')");
+  else return it->second;
+}
+
+// checks that the given type is supported as output type of the geometric transformations, and sets a python error otherwise
+static inline bool check_transform_type(int type_num, const char* name){
+  if (type_num == NPY_UINT8 || type_num == NPY_FLOAT32 || type_num == NPY_FLOAT64) return true;
+  PyErr_Format(PyExc_TypeError, "%s: the dst array must be of type uint8, float32 or float64, not %s", name, PyBlitzArray_TypenumAsString(type_num));
+  return false;
+}
+
 bob::extension::FunctionDoc s_scale = bob::extension::FunctionDoc(
   "scale",
   "Scales an image.",
@@ -19,27 +34,57 @@ bob::extension::FunctionDoc s_scale = bob::extension::FunctionDoc(
   "1. Given a source image and a scale factor, the scaled image is returned in the size :py:func:`bob.ip.base.scaled_output_shape`\n\n"
   "2. Given source and destination image, the source image is scaled such that it fits into the destination image.\n\n"
   "3. Same as 2., but additionally boolean masks will be read and filled with according values.\n\n"
+  "For 1. and 2., the ``algorithm`` ``'area'`` can be selected, which is better suited for large down-scaling factors: "
+  "the image is first reduced by the largest possible integral factor by averaging blocks of pixels, and only the remaining scale is applied with bi-linear interpolation. "
+  "This avoids aliasing artifacts and is faster, since each source pixel is read only once. "
+  "For up-scaling and for down-scaling factors larger than 0.5, both algorithms produce identical results.\n\n"
   ".. note::\n\n  For 2. and 3., scale factors are computed for both directions independently. "
   "Factually, this means that the image **might be** stretched in either direction, i.e., the aspect ratio is **not** identical for the horizontal and vertical direction. "
-  "Even for 1. this might apply, e.g., when ``src.shape * scaling_factor`` does not result in integral values."
+  "Even for 1. this might apply, e.g., when ``src.shape * scaling_factor`` does not result in integral values.\n\n"
+  "The ``dst`` image can be of type numpy.uint8, numpy.float32 or numpy.float64; for numpy.uint8, the interpolated values are rounded and saturated. "
+  "For 1., the type of the returned image can be selected with the ``dtype`` parameter.\n\n"
+  "For 3D images, the color planes are stored in the first dimension by default, i.e., images have shape ``(planes, height, width)``. "
+  "With ``layout='interleaved'``, images of shape ``(height, width, planes)`` are accepted. "
+  "In both cases, all color planes are scaled in a single pass.\n\n"
+  ".. note::\n\n  The ``algorithm``, ``dtype`` and ``layout`` parameters can only be given as keyword arguments."
 )
-.add_prototype("src, scaling_factor", "dst")
-.add_prototype("src, dst")
-.add_prototype("src, src_mask, dst, dst_mask")
+.add_prototype("src, scaling_factor, [algorithm], [dtype], [layout]", "dst")
+.add_prototype("src, dst, [algorithm], [layout]")
+.add_prototype("src, src_mask, dst, dst_mask, [layout]")
 .add_parameter("src", "array_like (2D or 3D)", "The input image (gray or colored) that should be scaled")
-.add_parameter("dst", "array_like (2D or 3D, float)", "The resulting scaled gray or color image")
+.add_parameter("dst", "array_like (2D or 3D, uint8, float32 or float64)", "The resulting scaled gray or color image")
 .add_parameter("src_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``src``")
 .add_parameter("dst_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``dst``")
 .add_parameter("scaling_factor", "float", "the scaling factor that should be applied to the image; can be negative, but cannot be ``0.``")
-.add_return("dst", "array_like (2D, float)", "The resulting scaled image")
+.add_parameter("algorithm", "str", "[Default: ``'bilinear'``] The scaling algorithm, one of ``'bilinear'`` or ``'area'``")
+.add_parameter("dtype", ":py:class:`numpy.dtype`", "[Default: ``numpy.float64``] The data type of the returned ``dst`` image; one of ``numpy.uint8``, ``numpy.float32`` or ``numpy.float64``")
+.add_parameter("layout", "str", "[Default: ``'planar'``] The memory layout of 3D images, one of ``'planar'`` or ``'interleaved'``; ignored for 2D images")
+.add_return("dst", "array_like (2D or 3D)", "The resulting scaled image")
 ;
 
-template <typename T, int D>
-static void scale_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask) {
-  if (input_mask && output_mask){
-    bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask));
+template <typename T, typename U>
+static void scale_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, bob::ip::base::ScaleAlgorithm algorithm, bob::ip::base::ColorLayout layout) {
+  if (input->ndim == 2){
+    if (input_mask && output_mask){
+      bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask));
+    } else {
+      bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<U,2>(output), algorithm);
+    }
   } else {
-    bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<double,D>(output));
+    if (input_mask && output_mask){
+      bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<bool,3>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,3>(output), *PyBlitzArrayCxx_AsBlitz<bool,3>(output_mask), layout);
+    } else {
+      bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<U,3>(output), algorithm, layout);
+    }
+  }
+}
+
+template <typename T>
+static void scale_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, bob::ip::base::ScaleAlgorithm algorithm, bob::ip::base::ColorLayout layout) {
+  switch (output->type_num){
+    case NPY_UINT8:   scale_inner<T,uint8_t>(input, input_mask, output, output_mask, algorithm, layout); break;
+    case NPY_FLOAT32: scale_inner<T,float>(input, input_mask, output, output_mask, algorithm, layout); break;
+    default:          scale_inner<T,double>(input, input_mask, output, output_mask, algorithm, layout); break;
   }
 }
 
@@ -50,14 +95,20 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
   char** kwlist2 = s_scale.kwlist(1);
   char** kwlist3 = s_scale.kwlist(2);
 
-  // get the number of command line arguments
+  // get the number of command line arguments, without the optional algorithm, data type and layout
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "algorithm")) --nargs;
+  if (kwargs && PyDict_GetItemString(kwargs, "dtype")) --nargs;
+  if (kwargs && PyDict_GetItemString(kwargs, "layout")) --nargs;
 
   PyBlitzArrayObject* src,* src_mask = 0,* dst = 0,* dst_mask = 0;
   double scale_factor = 0;
+  const char* algorithm = "bilinear";
+  const char* layout = "planar";
+  int type_num = NPY_FLOAT64;
   if (nargs == 4){
     // with masks
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist3, &PyBlitzArray_Converter, &src, &PyBlitzArray_Converter, &src_mask, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &dst_mask)) return 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&|s", kwlist3, &PyBlitzArray_Converter, &src, &PyBlitzArray_Converter, &src_mask, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &dst_mask, &layout)) return 0;
   }
   else if (nargs == 2){
     PyObject* k = Py_BuildValue("s", kwlist1[1]);
@@ -65,14 +116,14 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
     // check second parameter
     if ((args && PyTuple_Size(args) == 2 && (PyInt_Check(PyTuple_GET_ITEM(args,1)) || PyFloat_Check(PyTuple_GET_ITEM(args,1)))) || (kwargs && PyDict_Contains(kwargs, k))){
       // with scale
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&d", kwlist1, &PyBlitzArray_Converter, &src, &scale_factor)) return 0;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&d|sO&s", kwlist1, &PyBlitzArray_Converter, &src, &scale_factor, &algorithm, &PyBlitzArray_TypenumConverter, &type_num, &layout)) return 0;
       if (!scale_factor){
         PyErr_SetString(PyExc_ValueError, "scaling with a scale factor of 0. is not supported.");
         return 0;
       }
     } else {
       // with input and output
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&", kwlist2, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst)) return 0;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|ss", kwlist2, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst, &algorithm, &layout)) return 0;
     }
   }
   else{
@@ -82,6 +133,9 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
 
   auto src_ = make_safe(src), src_mask_ = make_xsafe(src_mask), dst_ = make_xsafe(dst), dst_mask_ = make_xsafe(dst_mask);
 
+  const bob::ip::base::ScaleAlgorithm scale_algorithm = a(algorithm);
+  const bob::ip::base::ColorLayout color = color_layout(layout);
+
   if (src->ndim != 2 && src->ndim != 3){
     PyErr_Format(PyExc_TypeError, "only 2D and 3D images can be scaled");
     return 0;
@@ -93,25 +147,31 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
       PyErr_Format(PyExc_TypeError, "scale: the src and dst array must have the same number of dimensions");
       return 0;
     }
-    if (dst->type_num != NPY_FLOAT64){
-      PyErr_Format(PyExc_TypeError, "scale: the dst array must be of type float64");
-      return 0;
-    }
+    if (!check_transform_type(dst->type_num, "scale")) return 0;
   } else {
+    if (!check_transform_type(type_num, "scale")) return 0;
     // create output in the same dimensions as input
     switch (src->ndim){
       case 2:{
         blitz::TinyVector<int,2> orig_shape(src->shape[0], src->shape[1]);
         auto new_shape = bob::ip::base::getScaledShape(orig_shape, scale_factor);
         Py_ssize_t n[] = {new_shape[0], new_shape[1]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 2, n));
         break;
       }
       case 3:{
-        blitz::TinyVector<int,3> orig_shape(src->shape[0], src->shape[1], src->shape[2]);
-        auto new_shape = bob::ip::base::getScaledShape(orig_shape, scale_factor);
-        Py_ssize_t n[] = {new_shape[0], new_shape[1], new_shape[2]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+        if (color == bob::ip::base::LAYOUT_INTERLEAVED){
+          // the color planes are stored in the last dimension
+          blitz::TinyVector<int,2> orig_shape(src->shape[0], src->shape[1]);
+          auto new_shape = bob::ip::base::getScaledShape(orig_shape, scale_factor);
+          Py_ssize_t n[] = {new_shape[0], new_shape[1], src->shape[2]};
+          dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+        } else {
+          blitz::TinyVector<int,3> orig_shape(src->shape[0], src->shape[1], src->shape[2]);
+          auto new_shape = bob::ip::base::getScaledShape(orig_shape, scale_factor);
+          Py_ssize_t n[] = {new_shape[0], new_shape[1], new_shape[2]};
+          dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+        }
         break;
       }
       default:
@@ -127,9 +187,9 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
   }
 
   switch (src->type_num){
-    case NPY_UINT8:   if (src->ndim == 2) scale_inner<uint8_t,2>(src, src_mask, dst, dst_mask);  else scale_inner<uint8_t,3>(src, src_mask, dst, dst_mask); break;
-    case NPY_UINT16:  if (src->ndim == 2) scale_inner<uint16_t,2>(src, src_mask, dst, dst_mask); else scale_inner<uint16_t,3>(src, src_mask, dst, dst_mask); break;
-    case NPY_FLOAT64: if (src->ndim == 2) scale_inner<double,2>(src, src_mask, dst, dst_mask);   else scale_inner<double,3>(src, src_mask, dst, dst_mask); break;
+    case NPY_UINT8:   scale_inner<uint8_t>(src, src_mask, dst, dst_mask, scale_algorithm, color); break;
+    case NPY_UINT16:  scale_inner<uint16_t>(src, src_mask, dst, dst_mask, scale_algorithm, color); break;
+    case NPY_FLOAT64: scale_inner<double>(src, src_mask, dst, dst_mask, scale_algorithm, color); break;
     default:
       PyErr_Format(PyExc_TypeError, "scale: src arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(src->type_num));
       return 0;
@@ -200,25 +260,51 @@ bob::extension::FunctionDoc s_rotate = bob::extension::FunctionDoc(
   "1. Given a source image and a rotation angle, the rotated image is returned in the size :py:func:`bob.ip.base.rotated_output_shape`\n\n"
   "2. Given source and destination image and the rotation angle, the source image is rotated and filled into the destination image.\n\n"
   "3. Same as 2., but additionally boolean masks will be read and filled with according values.\n\n"
+  "The ``dst`` image can be of type numpy.uint8, numpy.float32 or numpy.float64; for numpy.uint8, the interpolated values are rounded and saturated. "
+  "For 1., the type of the returned image can be selected with the ``dtype`` parameter, which can only be given as a keyword argument.\n\n"
+  "For 3D images, the color planes are stored in the first dimension by default; with ``layout='interleaved'``, images of shape ``(height, width, planes)`` are accepted. "
+  "In both cases, all color planes are rotated in a single pass. "
+  "The ``layout`` can only be given as a keyword argument.\n\n"
+  "When the ``rotation_angle`` is an exact multiple of 90 degrees and ``dst`` has the shape of :py:func:`bob.ip.base.rotated_output_shape`, no interpolation is required and the pixels are simply copied. "
+  "In this case, ``dst`` (and ``dst_mask``) might also be ``src`` (and ``src_mask``) to rotate square images in place.\n\n"
   ".. note::\n\n  Since the implementation uses a different interpolation style than before, results might *slightly* differ."
 )
-.add_prototype("src, rotation_angle", "dst")
-.add_prototype("src, dst, rotation_angle")
-.add_prototype("src, src_mask, dst, dst_mask, rotation_angle")
+.add_prototype("src, rotation_angle, [dtype], [layout]", "dst")
+.add_prototype("src, dst, rotation_angle, [layout]")
+.add_prototype("src, src_mask, dst, dst_mask, rotation_angle, [layout]")
 .add_parameter("src", "array_like (2D or 3D)", "The input image (gray or colored) that should be rotated")
-.add_parameter("dst", "array_like (2D or 3D, float)", "The resulting scaled gray or color image, should be in size :py:func:`bob.ip.base.rotated_output_shape`")
+.add_parameter("dst", "array_like (2D or 3D, uint8, float32 or float64)", "The resulting scaled gray or color image, should be in size :py:func:`bob.ip.base.rotated_output_shape`")
 .add_parameter("src_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``src``")
 .add_parameter("dst_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``dst``")
 .add_parameter("rotation_angle", "float", "the rotation angle that should be applied to the image")
-.add_return("dst", "array_like (2D, float)", "The resulting rotated image")
+.add_parameter("dtype", ":py:class:`numpy.dtype`", "[Default: ``numpy.float64``] The data type of the returned ``dst`` image; one of ``numpy.uint8``, ``numpy.float32`` or ``numpy.float64``")
+.add_parameter("layout", "str", "[Default: ``'planar'``] The memory layout of 3D images, one of ``'planar'`` or ``'interleaved'``; ignored for 2D images")
+.add_return("dst", "array_like (2D or 3D)", "The resulting rotated image")
 ;
 
-template <typename T, int D>
-static void rotate_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, double angle) {
-  if (input_mask && output_mask){
-    bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask), angle);
+template <typename T, typename U>
+static void rotate_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, double angle, bob::ip::base::ColorLayout layout) {
+  if (input->ndim == 2){
+    if (input_mask && output_mask){
+      bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), angle);
+    } else {
+      bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<U,2>(output), angle);
+    }
   } else {
-    bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<double,D>(output), angle);
+    if (input_mask && output_mask){
+      bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<bool,3>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,3>(output), *PyBlitzArrayCxx_AsBlitz<bool,3>(output_mask), angle, layout);
+    } else {
+      bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<U,3>(output), angle, layout);
+    }
+  }
+}
+
+template <typename T>
+static void rotate_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, double angle, bob::ip::base::ColorLayout layout) {
+  switch (output->type_num){
+    case NPY_UINT8:   rotate_inner<T,uint8_t>(input, input_mask, output, output_mask, angle, layout); break;
+    case NPY_FLOAT32: rotate_inner<T,float>(input, input_mask, output, output_mask, angle, layout); break;
+    default:          rotate_inner<T,double>(input, input_mask, output, output_mask, angle, layout); break;
   }
 }
 
@@ -229,20 +315,24 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
   char** kwlist2 = s_rotate.kwlist(1);
   char** kwlist3 = s_rotate.kwlist(2);
 
-  // get the number of command line arguments
+  // get the number of command line arguments, without the optional data type and layout
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "dtype")) --nargs;
+  if (kwargs && PyDict_GetItemString(kwargs, "layout")) --nargs;
 
   PyBlitzArrayObject* src,* src_mask = 0,* dst = 0,* dst_mask = 0;
   double angle = 0.;
+  int type_num = NPY_FLOAT64;
+  const char* layout = "planar";
   switch (nargs){
     case 2: // src and angle; create the destination afterwards
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&d", kwlist1, &PyBlitzArray_Converter, &src, &angle)) return 0;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&d|O&s", kwlist1, &PyBlitzArray_Converter, &src, &angle, &PyBlitzArray_TypenumConverter, &type_num, &layout)) return 0;
       break;
     case 3: // src, dst and angle
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&d", kwlist2, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst, &angle)) return 0;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&d|s", kwlist2, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst, &angle, &layout)) return 0;
       break;
     case 5: // src, dst and angle
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&d", kwlist3, &PyBlitzArray_Converter, &src, &PyBlitzArray_Converter, &src_mask, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &dst_mask, &angle)) return 0;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&d|s", kwlist3, &PyBlitzArray_Converter, &src, &PyBlitzArray_Converter, &src_mask, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &dst_mask, &angle, &layout)) return 0;
       break;
     default:
       PyErr_Format(PyExc_ValueError, "rotate was called with a wrong number of arguments");
@@ -251,6 +341,8 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
 
   auto src_ = make_safe(src), src_mask_ = make_xsafe(src_mask), dst_ = make_xsafe(dst), dst_mask_ = make_xsafe(dst_mask);
 
+  const bob::ip::base::ColorLayout color = color_layout(layout);
+
   if (src->ndim != 2 && src->ndim != 3){
     PyErr_Format(PyExc_TypeError, "only 2D and 3D images can be scaled");
     return 0;
@@ -262,25 +354,31 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
       PyErr_Format(PyExc_TypeError, "rotate: the src and dst array must have the same number of dimensions");
       return 0;
     }
-    if (dst->type_num != NPY_FLOAT64){
-      PyErr_Format(PyExc_TypeError, "rotate: the dst array must be of type float64");
-      return 0;
-    }
+    if (!check_transform_type(dst->type_num, "rotate")) return 0;
   } else {
+    if (!check_transform_type(type_num, "rotate")) return 0;
     // create output in the same dimensions as input
     switch (src->ndim){
       case 2:{
         blitz::TinyVector<int,2> orig_shape(src->shape[0], src->shape[1]);
         auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
         Py_ssize_t n[] = {new_shape[0], new_shape[1]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 2, n));
         break;
       }
       case 3:{
-        blitz::TinyVector<int,3> orig_shape(src->shape[0], src->shape[1], src->shape[2]);
-        auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
-        Py_ssize_t n[] = {new_shape[0], new_shape[1], new_shape[2]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+        if (color == bob::ip::base::LAYOUT_INTERLEAVED){
+          // the color planes are stored in the last dimension
+          blitz::TinyVector<int,2> orig_shape(src->shape[0], src->shape[1]);
+          auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
+          Py_ssize_t n[] = {new_shape[0], new_shape[1], src->shape[2]};
+          dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+        } else {
+          blitz::TinyVector<int,3> orig_shape(src->shape[0], src->shape[1], src->shape[2]);
+          auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
+          Py_ssize_t n[] = {new_shape[0], new_shape[1], new_shape[2]};
+          dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+        }
         break;
       }
       default:
@@ -296,9 +394,9 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
   }
 
   switch (src->type_num){
-    case NPY_UINT8:   if (src->ndim == 2) rotate_inner<uint8_t,2>(src, src_mask, dst, dst_mask, angle);  else rotate_inner<uint8_t,3>(src, src_mask, dst, dst_mask, angle); break;
-    case NPY_UINT16:  if (src->ndim == 2) rotate_inner<uint16_t,2>(src, src_mask, dst, dst_mask, angle); else rotate_inner<uint16_t,3>(src, src_mask, dst, dst_mask, angle); break;
-    case NPY_FLOAT64: if (src->ndim == 2) rotate_inner<double,2>(src, src_mask, dst, dst_mask, angle);   else rotate_inner<double,3>(src, src_mask, dst, dst_mask, angle); break;
+    case NPY_UINT8:   rotate_inner<uint8_t>(src, src_mask, dst, dst_mask, angle, color); break;
+    case NPY_UINT16:  rotate_inner<uint16_t>(src, src_mask, dst, dst_mask, angle, color); break;
+    case NPY_FLOAT64: rotate_inner<double>(src, src_mask, dst, dst_mask, angle, color); break;
     default:
       PyErr_Format(PyExc_TypeError, "rotate: src arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(src->type_num));
       return 0;
@@ -359,6 +457,99 @@ PyObject* PyBobIpBase_rotatedOutputShape(PyObject*, PyObject* args, PyObject* kw
 }
 
 
+bob::extension::FunctionDoc s_flip = bob::extension::FunctionDoc(
+  "_flip",
+  "Flip a 2D or 3D array/image upside-down; this is the implementation of :py:func:`bob.ip.base.flip` for the supported data types.",
+  "The destination array ``dst`` must have the same size and type as the source array. "
+  "When ``dst`` is ``src``, the image is flipped in place. "
+  "For 3D images, the color planes are stored in the first dimension."
+)
+.add_prototype("src, [dst]", "dst")
+.add_parameter("src", "array_like (2D or 3D)", "The source image to flip.")
+.add_parameter("dst", "array_like (2D or 3D)", "If given, the destination to flip ``src`` to.")
+.add_return("dst", "array_like (2D or 3D)", "The flipped image")
+;
+
+bob::extension::FunctionDoc s_flop = bob::extension::FunctionDoc(
+  "_flop",
+  "Flip a 2D or 3D array/image left-right; this is the implementation of :py:func:`bob.ip.base.flop` for the supported data types.",
+  "The destination array ``dst`` must have the same size and type as the source array. "
+  "When ``dst`` is ``src``, the image is flipped in place. "
+  "For 3D images, the color planes are stored in the first dimension."
+)
+.add_prototype("src, [dst]", "dst")
+.add_parameter("src", "array_like (2D or 3D)", "The source image to flip.")
+.add_parameter("dst", "array_like (2D or 3D)", "If given, the destination to flip ``src`` to.")
+.add_return("dst", "array_like (2D or 3D)", "The flipped image")
+;
+
+template <typename T>
+static void flip_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* output, bool flop) {
+  if (input->ndim == 2){
+    if (flop) bob::ip::base::flop(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<T,2>(output));
+    else bob::ip::base::flip(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<T,2>(output));
+  } else {
+    if (flop) bob::ip::base::flop(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<T,3>(output));
+    else bob::ip::base::flip(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<T,3>(output));
+  }
+}
+
+static PyObject* flip_flop(PyObject* args, PyObject* kwargs, bob::extension::FunctionDoc& doc, bool flop) {
+  char** kwlist = doc.kwlist();
+
+  PyBlitzArrayObject* src,* dst = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&", kwlist, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst)) return 0;
+
+  auto src_ = make_safe(src), dst_ = make_xsafe(dst);
+
+  if (src->ndim != 2 && src->ndim != 3){
+    PyErr_Format(PyExc_TypeError, "%s: only 2D and 3D images can be flipped", doc.name());
+    return 0;
+  }
+
+  if (dst){
+    if (dst->type_num != src->type_num || dst->ndim != src->ndim){
+      PyErr_Format(PyExc_TypeError, "%s: the dst array must have the same number of dimensions and data type as the src array", doc.name());
+      return 0;
+    }
+  } else {
+    dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(src->type_num, src->ndim, src->shape));
+    dst_ = make_safe(dst);
+  }
+
+  switch (src->type_num){
+    case NPY_BOOL:    flip_inner<bool>(src, dst, flop); break;
+    case NPY_UINT8:   flip_inner<uint8_t>(src, dst, flop); break;
+    case NPY_UINT16:  flip_inner<uint16_t>(src, dst, flop); break;
+    case NPY_UINT32:  flip_inner<uint32_t>(src, dst, flop); break;
+    case NPY_UINT64:  flip_inner<uint64_t>(src, dst, flop); break;
+    case NPY_INT8:    flip_inner<int8_t>(src, dst, flop); break;
+    case NPY_INT16:   flip_inner<int16_t>(src, dst, flop); break;
+    case NPY_INT32:   flip_inner<int32_t>(src, dst, flop); break;
+    case NPY_INT64:   flip_inner<int64_t>(src, dst, flop); break;
+    case NPY_FLOAT32: flip_inner<float>(src, dst, flop); break;
+    case NPY_FLOAT64: flip_inner<double>(src, dst, flop); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "%s: src arrays of type %s are currently not supported", doc.name(), PyBlitzArray_TypenumAsString(src->type_num));
+      return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(dst,0);
+}
+
+PyObject* PyBobIpBase_flip(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  return flip_flop(args, kwargs, s_flip, false);
+  BOB_CATCH_FUNCTION("flip", 0)
+}
+
+PyObject* PyBobIpBase_flop(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  return flip_flop(args, kwargs, s_flop, true);
+  BOB_CATCH_FUNCTION("flop", 0)
+}
+
+
 bob::extension::FunctionDoc s_maxRectInMask = bob::extension::FunctionDoc(
   "max_rect_in_mask",
   "Given a 2D mask (a 2D blitz array of booleans), compute the maximum rectangle which only contains true values.",
@@ -366,23 +557,47 @@ bob::extension::FunctionDoc s_maxRectInMask = bob::extension::FunctionDoc(
   "0. The y-coordinate of the top left corner\n\n"
   "1. The x-coordinate of the top left corner\n\n"
   "2. The height of the rectangle\n\n"
-  "3. The width of the rectangle"
+  "3. The width of the rectangle\n\n"
+  "If several rectangles have the maximum area, the one with the smallest top, then left coordinate, and then height is returned.\n\n"
+  "The ``mask`` can also be given bit-packed, as a 2D array of type numpy.uint8 as returned by ``numpy.packbits(mask, axis=1)``. "
+  "In this case, the number of columns of the original mask need to be specified as ``width``."
 )
 .add_prototype("mask", "rect")
+.add_prototype("packed_mask, width", "rect")
 .add_parameter("mask", "array_like (2D, bool)", "The mask of boolean values, e.g., as a result of :py:func:`bob.ip.base.GeomNorm.process`")
+.add_parameter("packed_mask", "array_like (2D, uint8)", "The mask, where each byte contains the values of eight consecutive pixels of a row, starting with the most significant bit")
+.add_parameter("width", "int", "The number of columns of the mask before packing")
 .add_return("rect", "(int, int, int, int)", "The resulting rectangle: (top, left, height, width)")
 ;
 
 PyObject* PyBobIpBase_maxRectInMask(PyObject*, PyObject* args, PyObject* kwargs) {
   BOB_TRY
   /* Parses input arguments in a single shot */
-  char** kwlist = s_maxRectInMask.kwlist();
+  char** kwlist1 = s_maxRectInMask.kwlist(0);
+  char** kwlist2 = s_maxRectInMask.kwlist(1);
+
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
 
   PyBlitzArrayObject* mask = 0;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &mask)) return 0;
+  int width = 0;
+  if (nargs == 2){
+    // bit-packed mask
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&i", kwlist2, &PyBlitzArray_Converter, &mask, &width)) return 0;
+  } else {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist1, &PyBlitzArray_Converter, &mask)) return 0;
+  }
 
   auto mask_ = make_safe(mask);
 
+  if (nargs == 2){
+    if (mask->ndim != 2 || mask->type_num != NPY_UINT8) {
+      PyErr_Format(PyExc_TypeError, "max_rect_in_mask: the packed_mask must be 2D and of type uint8");
+      return 0;
+    }
+    auto rect = bob::ip::base::maxRectInMask(*PyBlitzArrayCxx_AsBlitz<uint8_t, 2>(mask), width);
+    return Py_BuildValue("(iiii)", rect[0], rect[1], rect[2], rect[3]);
+  }
+
   if (mask->ndim != 2 || mask->type_num != NPY_BOOL) {
     PyErr_Format(PyExc_TypeError, "max_rect_in_mask: the mask must be 2D and of boolean type");
     return 0;
@@ -415,15 +630,20 @@ bob::extension::FunctionDoc s_extrapolateMask = bob::extension::FunctionDoc(
   "3. A normal distributed random value with mean 1 and standard deviation ``random_sigma`` is added to the pixel value\n"
   "4. The pixel value is set to the image at the current position\n\n"
   "Any action considering a random number will use the given ``rng`` to create random numbers.\n\n"
-  ".. note::\n\n  For the second variant, images of type ``float`` are preferred."
+  "Both ways require a convex mask. "
+  "For arbitrary masks, ``algorithm='nearest'`` can be selected, which fills each invalid pixel with the value of the nearest valid pixel in Euclidean distance, computed with an exact distance transform in linear time. "
+  "When ``random_sigma`` is given, one of the valid pixels up to ``neighbors`` positions next to the nearest valid pixel along the border is chosen randomly, and its value is multiplied with the normal distributed random value as above.\n\n"
+  ".. note::\n\n  For the second variant, images of type ``float`` are preferred. "
+  "The ``algorithm`` can only be given as a keyword argument."
 )
-.add_prototype("mask, img")
-.add_prototype("mask, img, random_sigma, [neighbors], [rng]")
+.add_prototype("mask, img, [algorithm]")
+.add_prototype("mask, img, random_sigma, [neighbors], [rng], [algorithm]")
 .add_parameter("mask", "array_like (2D, bool)", "The mask which has the valid pixel set to ``True`` and the invalid pixel set to ``False``")
 .add_parameter("img", "array_like (2D, bool)", "The image that will be filled; must have the same shape as ``mask``")
 .add_parameter("random_sigma", "float", "The standard deviation of the random factor to multiply thevalid pixel value from the border with; must be greater than or equal to 0")
 .add_parameter("neighbors", "int", "[Default: 5] The number of neighbors of valid border pixels to choose one from; set ``neighbors=0`` to disable random selection")
 .add_parameter("rng", ":py:class:`bob.core.random.mt19937`", "[Default: rng initialized with the system time] The random number generator to consider")
+.add_parameter("algorithm", "str", "[Default: ``'convex'``] The extrapolation algorithm, one of ``'convex'`` (column/row or spiral based, as described above) or ``'nearest'`` (nearest valid pixel)")
 ;
 
 PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwargs) {
@@ -435,8 +655,9 @@ PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwarg
   double sigma = -1.;
   int neighbors = 5;
   PyBoostMt19937Object* rng = 0;
+  const char* algorithm = "convex";
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|diO&", kwlist, &PyBlitzArray_Converter, &mask, &PyBlitzArray_OutputConverter, &img, &sigma, &neighbors, &PyBoostMt19937_Converter, &rng)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|diO&s", kwlist, &PyBlitzArray_Converter, &mask, &PyBlitzArray_OutputConverter, &img, &sigma, &neighbors, &PyBoostMt19937_Converter, &rng, &algorithm)) return 0;
 
   auto mask_ = make_safe(mask), img_ = make_safe(img);
   auto rng_ = make_xsafe(rng);
@@ -455,7 +676,23 @@ PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwarg
     return 0;
   }
 
-  if (sigma < 0){
+  const std::string algo(algorithm);
+  if (algo != "convex" && algo != "nearest"){
+    PyErr_Format(PyExc_ValueError, "extrapolate_mask: the algorithm '%s' is not known; choose one of ('convex', 'nearest')", algorithm);
+    return 0;
+  }
+
+  if (algo == "nearest"){
+    // nearest valid pixel, with or without random noise
+    switch (img->type_num){
+      case NPY_UINT8:   if (sigma < 0) bob::ip::base::extrapolateMaskNearest(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<uint8_t, 2>(img));  else bob::ip::base::extrapolateMaskNearestRandom(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<uint8_t, 2>(img), *rng->rng, sigma, neighbors); break;
+      case NPY_UINT16:  if (sigma < 0) bob::ip::base::extrapolateMaskNearest(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<uint16_t, 2>(img)); else bob::ip::base::extrapolateMaskNearestRandom(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<uint16_t, 2>(img), *rng->rng, sigma, neighbors); break;
+      case NPY_FLOAT64: if (sigma < 0) bob::ip::base::extrapolateMaskNearest(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<double, 2>(img));   else bob::ip::base::extrapolateMaskNearestRandom(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<double, 2>(img), *rng->rng, sigma, neighbors); break;
+      default:
+        PyErr_Format(PyExc_TypeError, "extrapolate_mask: img arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(img->type_num));
+        return 0;
+    }
+  } else if (sigma < 0){
     // first variant
     switch (img->type_num){
       case NPY_UINT8:   bob::ip::base::extrapolateMask(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask), *PyBlitzArrayCxx_AsBlitz<uint8_t, 2>(img)); break;
@@ -23,13 +23,15 @@ bob::extension::FunctionDoc s_histogram = bob::extension::FunctionDoc(
   "This function computes a histogram of the given input image, in several ways.\n\n"
   "* (version 1 and 2, only valid for uint8 and uint16 types -- and uint32 and uint64 when ``bin_count`` is specified or ``hist`` is given as parameter): For each pixel value of the ``src`` image, a histogram bin is computed, using a fast implementation. "
   "The number of bins can be limited, and there will be a check that the source image pixels are actually in the desired range ``(0, bin_count-1)``\n\n"
-  "* (version 3 and 4, valid for many data types): The histogram is computed by defining regular bins between the provided minimum and maximum values."
+  "* (version 3 and 4, valid for many data types): The histogram is computed by defining regular bins between the provided minimum and maximum values.\n\n"
+  "When a 3D stack of images is given, a joint histogram of all images is computed. "
+  "Large images and stacks are split into parts, which are histogrammed in parallel into private histograms that are summed up afterwards."
 )
 .add_prototype("src, [bin_count]", "hist")
 .add_prototype("src, hist")
 .add_prototype("src, min_max, bin_count", "hist")
 .add_prototype("src, min_max, hist")
-.add_parameter("src", "array_like (2D)", "The source image to compute the histogram for")
+.add_parameter("src", "array_like (2D or 3D)", "The source image or stack of images to compute the histogram for")
 .add_parameter("hist", "array_like (1D, uint64)", "The histogram with the desired number of bins; the histogram will be cleaned before running the extraction")
 .add_parameter("min_max", "(scalar, scalar)", "The minimum value and the maximum value in the source image")
 .add_parameter("bin_count", "int", "[default: 256 or 65536] The number of bins in the histogram to create, defaults to the maximum number of values")
@@ -42,12 +44,18 @@ template <typename T, char C> bool inner_histogram(PyBlitzArrayObject* src, PyBl
   if (!PyArg_ParseTuple(min_max, format.c_str(), &min, &max)) {
     return false;
   }
-  bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 2>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist), min, max);
+  if (src->ndim == 2)
+    bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 2>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist), min, max);
+  else
+    bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 3>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist), min, max);
   return true;
 }
 
 template <typename T, char C> void inner_histogram(PyBlitzArrayObject* src, PyBlitzArrayObject* hist){
-  bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 2>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist));
+  if (src->ndim == 2)
+    bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 2>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist));
+  else
+    bob::ip::base::histogram(*PyBlitzArrayCxx_AsBlitz<T, 3>(src), *PyBlitzArrayCxx_AsBlitz<uint64_t, 1>(hist));
 }
 
 PyObject* PyBobIpBase_histogram(PyObject*, PyObject* args, PyObject* kwargs) {
@@ -104,8 +112,8 @@ PyObject* PyBobIpBase_histogram(PyObject*, PyObject* args, PyObject* kwargs) {
   }
 
   // check input size
-  if (src->ndim != 2){
-    PyErr_Format(PyExc_TypeError, "'histogram' : The input image must be 2D.");
+  if (src->ndim != 2 && src->ndim != 3){
+    PyErr_Format(PyExc_TypeError, "'histogram' : The input image must be 2D or 3D.");
     return 0;
   }
 
@@ -416,38 +424,39 @@ bob::extension::FunctionDoc s_integral = bob::extension::FunctionDoc(
   "When the ``sqr`` matrix is given as well, it will be filled with the squared integral image (useful to compute variances of pixels).\n\n"
   ".. note::\n\n  The ``sqr`` image is expected to have the same data type as the ``dst`` image.\n\n"
   "If ``add_zero_border`` is set to ``True``, ``dst`` (and ``sqr``) should be one pixel larger than ``src`` in each dimension. "
-  "In this case, an extra zero pixel will be added at the beginning of each row and column."
-
+  "In this case, an extra zero pixel will be added at the beginning of each row and column.\n\n"
+  "Large images are processed with several threads, the results do not depend on the number of ``threads``."
 )
-.add_prototype("src, dst, [sqr], [add_zero_border]")
+.add_prototype("src, dst, [sqr], [add_zero_border], [threads]")
 .add_parameter("src", "array_like (2D)", "The source image")
 .add_parameter("dst", "array_like (2D)", "The resulting integral image")
 .add_parameter("sqr", "array_like (2D)", "The resulting squared integral image with the same data type as ``dst``")
 .add_parameter("add_zero_border", "bool", "If enabled, an extra zero pixel will be added at the beginning of each row and column")
+.add_parameter("threads", "int", "[Default: 0] The number of threads to use; if ``0``, all available cores are used")
 ;
 
 template <typename T1, typename T2>
-static inline PyObject* integral_inner(PyBlitzArrayObject* src, PyBlitzArrayObject* dst, PyBlitzArrayObject* sqr, bool add_zero_border) {
+static inline PyObject* integral_inner(PyBlitzArrayObject* src, PyBlitzArrayObject* dst, PyBlitzArrayObject* sqr, bool add_zero_border, int threads) {
   if (sqr)
-    bob::ip::base::integral(*PyBlitzArrayCxx_AsBlitz<T1,2>(src), *PyBlitzArrayCxx_AsBlitz<T2,2>(dst), *PyBlitzArrayCxx_AsBlitz<T2,2>(sqr), add_zero_border);
+    bob::ip::base::integral(*PyBlitzArrayCxx_AsBlitz<T1,2>(src), *PyBlitzArrayCxx_AsBlitz<T2,2>(dst), *PyBlitzArrayCxx_AsBlitz<T2,2>(sqr), add_zero_border, threads);
   else
-    bob::ip::base::integral(*PyBlitzArrayCxx_AsBlitz<T1,2>(src), *PyBlitzArrayCxx_AsBlitz<T2,2>(dst), add_zero_border);
+    bob::ip::base::integral(*PyBlitzArrayCxx_AsBlitz<T1,2>(src), *PyBlitzArrayCxx_AsBlitz<T2,2>(dst), add_zero_border, threads);
   Py_RETURN_NONE;
 }
 
 template <typename T1>
-static inline PyObject* integral_middle(PyBlitzArrayObject* src, PyBlitzArrayObject* dst, PyBlitzArrayObject* sqr, bool b) {
+static inline PyObject* integral_middle(PyBlitzArrayObject* src, PyBlitzArrayObject* dst, PyBlitzArrayObject* sqr, bool b, int t) {
   switch (dst->type_num){
-    case NPY_INT8: return integral_inner<T1,int8_t>(src, dst, sqr, b);
-    case NPY_INT16: return integral_inner<T1,int16_t>(src, dst, sqr, b);
-    case NPY_INT32: return integral_inner<T1,int32_t>(src, dst, sqr, b);
-    case NPY_INT64: return integral_inner<T1,int64_t>(src, dst, sqr, b);
-    case NPY_UINT8: return integral_inner<T1,uint8_t>(src, dst, sqr, b);
-    case NPY_UINT16: return integral_inner<T1,uint16_t>(src, dst, sqr, b);
-    case NPY_UINT32: return integral_inner<T1,uint32_t>(src, dst, sqr, b);
-    case NPY_UINT64: return integral_inner<T1,uint64_t>(src, dst, sqr, b);
-    case NPY_FLOAT32: return integral_inner<T1,float>(src, dst, sqr, b);
-    case NPY_FLOAT64: return integral_inner<T1,double>(src, dst, sqr, b);
+    case NPY_INT8: return integral_inner<T1,int8_t>(src, dst, sqr, b, t);
+    case NPY_INT16: return integral_inner<T1,int16_t>(src, dst, sqr, b, t);
+    case NPY_INT32: return integral_inner<T1,int32_t>(src, dst, sqr, b, t);
+    case NPY_INT64: return integral_inner<T1,int64_t>(src, dst, sqr, b, t);
+    case NPY_UINT8: return integral_inner<T1,uint8_t>(src, dst, sqr, b, t);
+    case NPY_UINT16: return integral_inner<T1,uint16_t>(src, dst, sqr, b, t);
+    case NPY_UINT32: return integral_inner<T1,uint32_t>(src, dst, sqr, b, t);
+    case NPY_UINT64: return integral_inner<T1,uint64_t>(src, dst, sqr, b, t);
+    case NPY_FLOAT32: return integral_inner<T1,float>(src, dst, sqr, b, t);
+    case NPY_FLOAT64: return integral_inner<T1,double>(src, dst, sqr, b, t);
     default:
       PyErr_Format(PyExc_TypeError, "integral does not work on 'dst' images of type %s", PyBlitzArray_TypenumAsString(dst->type_num));
   }
@@ -461,8 +470,9 @@ PyObject* PyBobIpBase_integral(PyObject*, PyObject* args, PyObject* kwds) {
 
   PyBlitzArrayObject* src = 0,* dst = 0,* sqr = 0;
   PyObject* azb = 0;
+  int threads = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O&|O&O!", kwlist, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &sqr, &PyBool_Type, &azb)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O&|O&O!i", kwlist, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &sqr, &PyBool_Type, &azb, &threads)) return 0;
   auto src_ = make_safe(src), dst_ = make_safe(dst), sqr_ = make_xsafe(sqr);
   bool b = azb && PyObject_IsTrue(azb);
 
@@ -477,16 +487,16 @@ PyObject* PyBobIpBase_integral(PyObject*, PyObject* args, PyObject* kwds) {
   }
 
   switch (src->type_num){
-    case NPY_INT8: return integral_middle<int8_t>(src, dst, sqr, b);
-    case NPY_INT16: return integral_middle<int16_t>(src, dst, sqr, b);
-    case NPY_INT32: return integral_middle<int32_t>(src, dst, sqr, b);
-    case NPY_INT64: return integral_middle<int64_t>(src, dst, sqr, b);
-    case NPY_UINT8: return integral_middle<uint8_t>(src, dst, sqr, b);
-    case NPY_UINT16: return integral_middle<uint16_t>(src, dst, sqr, b);
-    case NPY_UINT32: return integral_middle<uint32_t>(src, dst, sqr, b);
-    case NPY_UINT64: return integral_middle<uint64_t>(src, dst, sqr, b);
-    case NPY_FLOAT32: return integral_middle<float>(src, dst, sqr, b);
-    case NPY_FLOAT64: return integral_middle<double>(src, dst, sqr, b);
+    case NPY_INT8: return integral_middle<int8_t>(src, dst, sqr, b, threads);
+    case NPY_INT16: return integral_middle<int16_t>(src, dst, sqr, b, threads);
+    case NPY_INT32: return integral_middle<int32_t>(src, dst, sqr, b, threads);
+    case NPY_INT64: return integral_middle<int64_t>(src, dst, sqr, b, threads);
+    case NPY_UINT8: return integral_middle<uint8_t>(src, dst, sqr, b, threads);
+    case NPY_UINT16: return integral_middle<uint16_t>(src, dst, sqr, b, threads);
+    case NPY_UINT32: return integral_middle<uint32_t>(src, dst, sqr, b, threads);
+    case NPY_UINT64: return integral_middle<uint64_t>(src, dst, sqr, b, threads);
+    case NPY_FLOAT32: return integral_middle<float>(src, dst, sqr, b, threads);
+    case NPY_FLOAT64: return integral_middle<double>(src, dst, sqr, b, threads);
     default:
       PyErr_Format(PyExc_TypeError, "integral does not work on 'src' images of type %s", PyBlitzArray_TypenumAsString(src->type_num));
   }
@@ -495,20 +505,89 @@ PyObject* PyBobIpBase_integral(PyObject*, PyObject* args, PyObject* kwds) {
   BOB_CATCH_FUNCTION("in integral", 0)
 }
 
+bob::extension::FunctionDoc s_tiltedIntegral = bob::extension::FunctionDoc(
+  "tilted_integral",
+  "Computes the 45 degree rotated (tilted) integral image for the given input image",
+  "The tilted integral image ``dst`` must be one pixel larger than ``src`` in each dimension. "
+  "Each pixel ``dst[Y,X]`` contains the sum of all pixels ``src[y,x]`` above row ``Y`` that lie inside the upright triangle with its apex in between ``(Y,X-1)`` and ``(Y,X)``, i.e., with ``|x-X+1| < Y-y``.\n\n"
+  "Using this image, the sum of the pixels in a rectangle rotated by 45 degrees, which starts at pixel ``(y,x)`` and extends ``w`` pixels to the lower right and ``h`` pixels to the lower left, can be computed with four lookups:\n\n"
+  ".. code-block:: python\n\n"
+  "   dst[y+w+h, x-h+w+1] - dst[y+w, x+w+1] - dst[y+h, x-h+1] + dst[y, x+1]\n\n"
+  "Here, the rectangle contains all pixels ``(y',x')`` with ``0 <= (y'-y)+(x'-x) < 2w`` and ``0 <= (y'-y)-(x'-x) < 2h``. "
+  "It is the responsibility of the user to select an appropriate type for the numpy array ``dst``."
+)
+.add_prototype("src, dst")
+.add_parameter("src", "array_like (2D)", "The source image")
+.add_parameter("dst", "array_like (2D)", "The resulting tilted integral image, which must be one pixel larger than ``src`` in each dimension")
+;
+
+template <typename T1, typename T2>
+static inline PyObject* tilted_integral_inner(PyBlitzArrayObject* src, PyBlitzArrayObject* dst) {
+  bob::ip::base::tiltedIntegral(*PyBlitzArrayCxx_AsBlitz<T1,2>(src), *PyBlitzArrayCxx_AsBlitz<T2,2>(dst));
+  Py_RETURN_NONE;
+}
+
+template <typename T1>
+static inline PyObject* tilted_integral_middle(PyBlitzArrayObject* src, PyBlitzArrayObject* dst) {
+  switch (dst->type_num){
+    case NPY_INT32: return tilted_integral_inner<T1,int32_t>(src, dst);
+    case NPY_INT64: return tilted_integral_inner<T1,int64_t>(src, dst);
+    case NPY_UINT32: return tilted_integral_inner<T1,uint32_t>(src, dst);
+    case NPY_UINT64: return tilted_integral_inner<T1,uint64_t>(src, dst);
+    case NPY_FLOAT32: return tilted_integral_inner<T1,float>(src, dst);
+    case NPY_FLOAT64: return tilted_integral_inner<T1,double>(src, dst);
+    default:
+      PyErr_Format(PyExc_TypeError, "tilted_integral does not work on 'dst' images of type %s", PyBlitzArray_TypenumAsString(dst->type_num));
+  }
+  return 0;
+}
+
+PyObject* PyBobIpBase_tiltedIntegral(PyObject*, PyObject* args, PyObject* kwds) {
+  BOB_TRY
+  /* Parses input arguments in a single shot */
+  char** kwlist = s_tiltedIntegral.kwlist();
+
+  PyBlitzArrayObject* src = 0,* dst = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O&", kwlist, &PyBlitzArray_Converter, &src, &PyBlitzArray_OutputConverter, &dst)) return 0;
+  auto src_ = make_safe(src), dst_ = make_safe(dst);
+
+  if (src->ndim != 2 || dst->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "tilted integral images can only be computed from and to 2D arrays");
+    return 0;
+  }
+
+  switch (src->type_num){
+    case NPY_UINT8: return tilted_integral_middle<uint8_t>(src, dst);
+    case NPY_UINT16: return tilted_integral_middle<uint16_t>(src, dst);
+    case NPY_INT32: return tilted_integral_middle<int32_t>(src, dst);
+    case NPY_FLOAT32: return tilted_integral_middle<float>(src, dst);
+    case NPY_FLOAT64: return tilted_integral_middle<double>(src, dst);
+    default:
+      PyErr_Format(PyExc_TypeError, "tilted_integral does not work on 'src' images of type %s", PyBlitzArray_TypenumAsString(src->type_num));
+  }
+  return 0;
+
+  BOB_CATCH_FUNCTION("in tilted_integral", 0)
+}
+
 bob::extension::FunctionDoc s_block = bob::extension::FunctionDoc(
   "block",
   "Performs a block decomposition of a 2D array/image",
   "If given, the output 3D or 4D destination array should be allocated and of the correct size, see :py:func:`bob.ip.base.block_output_shape`.",
   "Blocks are extracted such that they fit into the given image. "
   "The blocks can be split into either a 3D array of shape ``(block_index, block_height, block_width)``, or into a 4D array of shape ``(block_index_y, block_index_x, block_height, block_width)``. "
-  "To toggle between both ways, select the ``flat`` parameter accordingly."
+  "To toggle between both ways, select the ``flat`` parameter accordingly.\n\n"
+  "If ``view`` is enabled, no data is copied, but a read-only 4D view of the ``input`` is returned, in which overlapping blocks share the same memory. "
+  "The view refers to the data of ``input`` directly, when ``input`` is a C-contiguous numpy array; otherwise, it refers to a copy of it."
 )
-.add_prototype("input, block_size, [block_overlap], [output], [flat]", "output")
+.add_prototype("input, block_size, [block_overlap], [output], [flat], [view]", "output")
 .add_parameter("input", "array_like (2D)", "The source image to decompose into blocks")
 .add_parameter("block_size", "(int, int)", "The size of the blocks in which the image is decomposed")
 .add_parameter("block_overlap", "(int, int)", "[default: ``(0, 0)``] The overlap of the blocks")
 .add_parameter("output", "array_like(3D or 4D)", "[default: ``None``] If given, the resulting blocks will be saved into this parameter; must be initialized in the correct size (see :py:func:`block_output_shape`)")
 .add_parameter("flat", "bool", "[default: ``False``] If ``output`` is not specified, the ``flat`` parameter is used to decide whether 3D (``flat = True``) or 4D (``flat = False``) output is generated")
+.add_parameter("view", "bool", "[default: ``False``] Return a read-only 4D view of the blocks instead of copying them; cannot be combined with ``output`` or ``flat = True``")
 .add_return("output", "array_like(3D or 4D)", "The resulting blocks that the image is decomposed into; the same array as the ``output`` parameter, when given.")
 ;
 
@@ -525,6 +604,32 @@ static inline void block_inner(PyBlitzArrayObject* input, blitz::TinyVector<int,
   bob::ip::base::block(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<T,D>(output), block_size[0], block_size[1], block_overlap[0], block_overlap[1]);
 }
 
+// creates a read-only numpy array with overlapping strides, which refers to the data of the given input
+static PyObject* block_view(PyBlitzArrayObject* input, blitz::TinyVector<int,2> block_size, blitz::TinyVector<int,2> block_overlap){
+  bob::ip::base::_blockCheckInput(input->shape[0], input->shape[1], block_size[0], block_size[1], block_overlap[0], block_overlap[1]);
+  auto shape = block_shape4(input, block_size, block_overlap);
+
+  PyArrayObject* array = reinterpret_cast<PyArrayObject*>(PyBlitzArray_AsNumpyArray(input, 0));
+  if (!array) return 0;
+  auto array_ = make_safe(array);
+
+  const npy_intp* s = PyArray_STRIDES(array);
+  npy_intp dims[] = {shape[0], shape[1], shape[2], shape[3]};
+  npy_intp strides[] = {s[0] * (block_size[0] - block_overlap[0]), s[1] * (block_size[1] - block_overlap[1]), s[0], s[1]};
+  PyArray_Descr* descr = PyArray_DESCR(array);
+  Py_INCREF(descr);
+  // without the writeable flag, the view is read-only
+  PyObject* view = PyArray_NewFromDescr(&PyArray_Type, descr, 4, dims, strides, PyArray_DATA(array), 0, 0);
+  if (!view) return 0;
+  // the view keeps the array alive
+  Py_INCREF(array);
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(view), reinterpret_cast<PyObject*>(array)) < 0){
+    Py_DECREF(view);
+    return 0;
+  }
+  return view;
+}
+
 PyObject* PyBobIpBase_block(PyObject*, PyObject* args, PyObject* kwds) {
   BOB_TRY
   /* Parses input arguments in a single shot */
@@ -532,9 +637,9 @@ PyObject* PyBobIpBase_block(PyObject*, PyObject* args, PyObject* kwds) {
 
   PyBlitzArrayObject* input = 0,* output = 0;
   blitz::TinyVector<int,2> size, overlap(0,0);
-  PyObject* flat_ = 0;
+  PyObject* flat_ = 0,* view_ = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&(ii)|(ii)O&O!", kwlist, &PyBlitzArray_Converter, &input, &size[0], &size[1], &overlap[0], &overlap[1], &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &flat_)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&(ii)|(ii)O&O!O!", kwlist, &PyBlitzArray_Converter, &input, &size[0], &size[1], &overlap[0], &overlap[1], &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &flat_, &PyBool_Type, &view_)) return 0;
 
   auto input_ = make_safe(input), output_ = make_xsafe(output);
   bool flat = f(flat_);
@@ -543,6 +648,13 @@ PyObject* PyBobIpBase_block(PyObject*, PyObject* args, PyObject* kwds) {
     PyErr_Format(PyExc_TypeError, "blocks can only be extracted from and to 2D arrays");
     return 0;
   }
+  if (f(view_)){
+    if (output || flat){
+      PyErr_Format(PyExc_ValueError, "a view of the blocks can only be created as a new 4D array, i.e., without ``output`` and with ``flat = False``");
+      return 0;
+    }
+    return block_view(input, size, overlap);
+  }
   bool return_out = false;
   if (output){
     if (output->type_num != input->type_num){
@@ -575,6 +687,7 @@ PyObject* PyBobIpBase_block(PyObject*, PyObject* args, PyObject* kwds) {
     case NPY_FLOAT64: if (flat) block_inner<double,3>(input, size, overlap, output);   else block_inner<double,4>(input, size, overlap, output); break;
     default:
       PyErr_Format(PyExc_TypeError, "block does not work on 'input' images of type %s", PyBlitzArray_TypenumAsString(input->type_num));
+      return 0;
   }
 
   if (return_out){
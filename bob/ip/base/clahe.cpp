@@ -0,0 +1,283 @@
+/**
+ * @date Sat Oct 17 20:14:37 CEST 2026
+ *
+ * @brief Binds the CLAHE class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto CLAHE_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".CLAHE",
+  "Objects of this class, after configuration, can perform a contrast limited adaptive histogram equalization (CLAHE) of images",
+  "The image is split into a regular grid of ``tiles``. "
+  "For each tile, the histogram is clipped at ``clip_limit`` times the average bin count, the clipped counts are spread uniformly over all bins, "
+  "and the cumulative distribution of the clipped histogram defines the gray value mapping of the tile. "
+  "Each pixel is mapped by bilinearly blending the mappings of the four tiles whose centers surround it.\n\n"
+  "The mappings are kept in a workspace, which is re-used for all images of the same size."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Constructs a new CLAHE object",
+    "The object can be constructed from the number of tiles and the clip limit, or copied from another CLAHE object.",
+    true
+  )
+  .add_prototype("[tiles], [clip_limit]","")
+  .add_prototype("clahe", "")
+  .add_parameter("tiles", "(int, int)", "[default: ``(8, 8)``] The number of tiles in vertical and horizontal direction")
+  .add_parameter("clip_limit", "float", "[default: ``2.``] The maximum count of each histogram bin, relative to the average count of a bin in a tile; if not positive, the histograms are not clipped")
+  .add_parameter("clahe", ":py:class:`bob.ip.base.CLAHE`", "The CLAHE object to use for copy-construction")
+);
+
+
+static int PyBobIpBaseCLAHE_init(PyBobIpBaseCLAHEObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = CLAHE_doc.kwlist(0);
+  char** kwlist2 = CLAHE_doc.kwlist(1);
+
+  // get the number of command line arguments
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  PyObject* k = Py_BuildValue("s", kwlist2[0]);
+  auto k_ = make_safe(k);
+  if (nargs == 1 && ((args && PyTuple_Size(args) == 1 && PyBobIpBaseCLAHE_Check(PyTuple_GET_ITEM(args,0))) || (kwargs && PyDict_Contains(kwargs, k)))){
+    // copy construct
+    PyBobIpBaseCLAHEObject* clahe;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist2, &PyBobIpBaseCLAHE_Type, &clahe)) return -1;
+
+    self->cxx.reset(new bob::ip::base::CLAHE(*clahe->cxx));
+    return 0;
+  }
+
+  blitz::TinyVector<int,2> tiles(8,8);
+  double clip_limit = 2.;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|(ii)d", kwlist1, &tiles[0], &tiles[1], &clip_limit)){
+    CLAHE_doc.print_usage();
+    return -1;
+  }
+  self->cxx.reset(new bob::ip::base::CLAHE(tiles, clip_limit));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create CLAHE", -1)
+}
+
+static void PyBobIpBaseCLAHE_delete(PyBobIpBaseCLAHEObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseCLAHE_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseCLAHE_Type));
+}
+
+static PyObject* PyBobIpBaseCLAHE_RichCompare(PyBobIpBaseCLAHEObject* self, PyObject* other, int op) {
+  BOB_TRY
+
+  if (!PyBobIpBaseCLAHE_Check(other)) {
+    PyErr_Format(PyExc_TypeError, "cannot compare `%s' with `%s'", Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+    return 0;
+  }
+  auto other_ = reinterpret_cast<PyBobIpBaseCLAHEObject*>(other);
+  switch (op) {
+    case Py_EQ:
+      if (*self->cxx==*other_->cxx) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+    case Py_NE:
+      if (*self->cxx==*other_->cxx) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+    default:
+      Py_INCREF(Py_NotImplemented);
+      return Py_NotImplemented;
+  }
+  BOB_CATCH_MEMBER("cannot compare CLAHE objects", 0)
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto tiles = bob::extension::VariableDoc(
+  "tiles",
+  "(int, int)",
+  "The number of tiles in vertical and horizontal direction, with read and write access"
+);
+PyObject* PyBobIpBaseCLAHE_getTiles(PyBobIpBaseCLAHEObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("(ii)", self->cxx->getTiles()[0], self->cxx->getTiles()[1]);
+  BOB_CATCH_MEMBER("tiles could not be read", 0)
+}
+int PyBobIpBaseCLAHE_setTiles(PyBobIpBaseCLAHEObject* self, PyObject* value, void*){
+  BOB_TRY
+  blitz::TinyVector<int,2> r;
+  if (!PyArg_ParseTuple(value, "ii", &r[0], &r[1])){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a tuple of two ints", Py_TYPE(self)->tp_name, tiles.name());
+    return -1;
+  }
+  self->cxx->setTiles(r);
+  return 0;
+  BOB_CATCH_MEMBER("tiles could not be set", -1)
+}
+
+static auto clipLimit = bob::extension::VariableDoc(
+  "clip_limit",
+  "float",
+  "The maximum count of each histogram bin, relative to the average count of a bin in a tile, with read and write access",
+  "If not positive, the histograms are not clipped, i.e., a plain adaptive histogram equalization is performed."
+);
+PyObject* PyBobIpBaseCLAHE_getClipLimit(PyBobIpBaseCLAHEObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getClipLimit());
+  BOB_CATCH_MEMBER("clip_limit could not be read", 0)
+}
+int PyBobIpBaseCLAHE_setClipLimit(PyBobIpBaseCLAHEObject* self, PyObject* value, void*){
+  BOB_TRY
+  double d = PyFloat_AsDouble(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->setClipLimit(d);
+  return 0;
+  BOB_CATCH_MEMBER("clip_limit could not be set", -1)
+}
+
+static PyGetSetDef PyBobIpBaseCLAHE_getseters[] = {
+    {
+      tiles.name(),
+      (getter)PyBobIpBaseCLAHE_getTiles,
+      (setter)PyBobIpBaseCLAHE_setTiles,
+      tiles.doc(),
+      0
+    },
+    {
+      clipLimit.name(),
+      (getter)PyBobIpBaseCLAHE_getClipLimit,
+      (setter)PyBobIpBaseCLAHE_setClipLimit,
+      clipLimit.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto process = bob::extension::FunctionDoc(
+  "process",
+  "Equalizes the given 2D/grayscale image",
+  "The input array is a 2D array/grayscale image of type uint8 or uint16. "
+  "The destination array, if given, should be a 2D array of the same type and the same size as the input. "
+  "If the destination array is not given, it is generated in the required size.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("input, [output], [threads]", "output")
+.add_parameter("input", "array_like (2D, uint8 or uint16)", "The input image which should be equalized")
+.add_parameter("output", "array_like (2D, uint8 or uint16)", "[default: ``None``] If given, the output will be saved into this image; must be of the same shape and type as ``input``")
+.add_parameter("threads", "int", "[default: ``0``] The number of threads to use; if ``0``, all available cores are used")
+.add_return("output", "array_like (2D, uint8 or uint16)", "The resulting output image, which is the same as ``output`` (if given)")
+;
+
+template <typename T>
+static PyObject* process_inner(PyBobIpBaseCLAHEObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, int threads){
+  self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<T,2>(output), threads);
+  return PyBlitzArray_AsNumpyArray(output, 0);
+}
+
+static PyObject* PyBobIpBaseCLAHE_process(PyBobIpBaseCLAHEObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = process.kwlist();
+
+  PyBlitzArrayObject* input,* output = 0;
+  int threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&i", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &threads)) {
+    process.print_usage();
+    return 0;
+  }
+
+  auto input_ = make_safe(input), output_ = make_xsafe(output);
+
+  // perform checks on input and output image
+  if (input->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays", Py_TYPE(self)->tp_name);
+    process.print_usage();
+    return 0;
+  }
+
+  if (output){
+    if (output->ndim != 2 || output->type_num != input->type_num){
+      PyErr_Format(PyExc_TypeError, "`%s' only processes to 2D arrays of the same type as the input", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+  } else {
+    // create output in desired shape
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(input->type_num, 2, input->shape);
+    output_ = make_safe(output);
+  }
+
+  // finally, equalize the image
+  switch (input->type_num){
+    case NPY_UINT8:   return process_inner<uint8_t>(self, input, output, threads);
+    case NPY_UINT16:  return process_inner<uint16_t>(self, input, output, threads);
+    default:
+      process.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' processes only images of types uint8 or uint16, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      return 0;
+  }
+
+  BOB_CATCH_MEMBER("cannot perform CLAHE in image", 0)
+}
+
+
+static PyMethodDef PyBobIpBaseCLAHE_methods[] = {
+  {
+    process.name(),
+    (PyCFunction)PyBobIpBaseCLAHE_process,
+    METH_VARARGS|METH_KEYWORDS,
+    process.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the CLAHE type struct; will be initialized later
+PyTypeObject PyBobIpBaseCLAHE_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseCLAHE(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseCLAHE_Type.tp_name = CLAHE_doc.name();
+  PyBobIpBaseCLAHE_Type.tp_basicsize = sizeof(PyBobIpBaseCLAHEObject);
+  PyBobIpBaseCLAHE_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseCLAHE_Type.tp_doc = CLAHE_doc.doc();
+
+  // set the functions
+  PyBobIpBaseCLAHE_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseCLAHE_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseCLAHE_init);
+  PyBobIpBaseCLAHE_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseCLAHE_delete);
+  PyBobIpBaseCLAHE_Type.tp_richcompare = reinterpret_cast<richcmpfunc>(PyBobIpBaseCLAHE_RichCompare);
+  PyBobIpBaseCLAHE_Type.tp_methods = PyBobIpBaseCLAHE_methods;
+  PyBobIpBaseCLAHE_Type.tp_getset = PyBobIpBaseCLAHE_getseters;
+  PyBobIpBaseCLAHE_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseCLAHE_process);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseCLAHE_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseCLAHE_Type);
+  return PyModule_AddObject(module, "CLAHE", (PyObject*)&PyBobIpBaseCLAHE_Type) >= 0;
+}
@@ -10,13 +10,44 @@
 
 #include <bob.ip.base/Affine.h>
 
-static bool isTrue(const blitz::Array<bool,2>& mask, int y0, int x0, int y1, int x1)
+/**
+ * Helper function to update the best rectangle.
+ * Among rectangles of the same area, the one with the smallest top, then the smallest left and then the smallest height is selected.
+ */
+static inline void _update_rect(const int top, const int left, const int height, const int width, blitz::TinyVector<int,4>& best, int& best_area)
+{
+  const int area = height * width;
+  if (area < best_area || area == 0) return;
+  if (area == best_area){
+    if (top > best(0) || (top == best(0) && (left > best(1) || (left == best(1) && height >= best(2))))) return;
+  }
+  best_area = area;
+  best(0) = top;
+  best(1) = left;
+  best(2) = height;
+  best(3) = width;
+}
+
+/**
+ * Helper function that finds the largest rectangles with the bottom row y,
+ * given the number of consecutive true values above each pixel of this row.
+ * The histogram is processed with a monotonic stack, so that each column is visited at most twice.
+ */
+static void _max_rect_in_histogram(const std::vector<int>& heights, const int y, std::vector<int>& stack, blitz::TinyVector<int,4>& best, int& best_area)
 {
-  for(int j=y0; j<=y1; ++j)
-    for(int i=x0; i<=x1; ++i)
-      if(!mask(j,i))
-        return false;
-  return true;
+  const int width = heights.size();
+  stack.clear();
+  for (int x = 0; x <= width; ++x){
+    const int h = x < width ? heights[x] : 0;
+    while (!stack.empty() && heights[stack.back()] >= h){
+      // the rectangle with the height of the popped column extends from the column after the new top of the stack to x
+      const int height = heights[stack.back()];
+      stack.pop_back();
+      const int left = stack.empty() ? 0 : stack.back() + 1;
+      _update_rect(y - height + 1, left, height, x - left, best, best_area);
+    }
+    stack.push_back(x);
+  }
 }
 
 
@@ -26,61 +57,101 @@ const blitz::TinyVector<int,4> bob::ip::base::maxRectInMask(const blitz::Array<b
   blitz::TinyVector<int,4> cur_sol = 0;
   int cur_max_area = 0;
 
-  for( int y0=0; y0<height; ++y0)
-  {
-    // Find first true value
-    int i_min = 0;
-    bool found_true = false;
-    for(int x0=0; x0<width; ++x0)
-      if(mask(y0,x0))
-      {
-        i_min=x0;
-        found_true = true;
-        break;
-      }
-    if(!found_true)
-      continue;
-
-    // Find last true value
-    int i_max = width;
-    for(int x0=i_min+1; x0<width; ++x0)
-      if(!mask(y0,x0))
-      {
-        i_max = x0;
-        break;
-      }
+  // the number of consecutive true values ending in the current row
+  std::vector<int> heights(width, 0), stack;
+  stack.reserve(width+1);
+  for (int y = 0; y < height; ++y){
+    for (int x = 0; x < width; ++x)
+      heights[x] = mask(y,x) ? heights[x] + 1 : 0;
+    _max_rect_in_histogram(heights, y, stack, cur_sol, cur_max_area);
+  }
+
+  return cur_sol;
+}
 
-    // Find largest rectangle visiting all the possible combinations
-    for(int x0=i_min; x0<i_max; ++x0)
-    {
-      int cur_i_max = i_max;
-      for(int y1=y0; y1<height; ++y1)
-        for(int x1=x0; x1<cur_i_max; ++x1)
-        {
-          if(isTrue(mask,y1,x0,y1,x1))
-          {
-            int area = (y1-y0+1)*(x1-x0+1);
-            if( area > cur_max_area )
-            {
-              cur_max_area = area;
-              cur_sol(0) = y0;
-              cur_sol(1) = x0;
-              cur_sol(2) = y1-y0+1;
-              cur_sol(3) = x1-x0+1;
-            }
-          }
-          else
-          {
-            if(x1 < cur_i_max)
-              cur_i_max = x1;
-            break;
-          }
-        }
+const blitz::TinyVector<int,4> bob::ip::base::maxRectInMask(const blitz::Array<uint8_t,2>& packed_mask, const int width){
+  const int height = packed_mask.extent(0);
+  const int bytes = packed_mask.extent(1);
+  if (width < 0 || bytes != (width + 7) / 8)
+    throw std::runtime_error((boost::format("the bit-packed mask with %d bytes per row cannot contain %d columns") % bytes % width).str());
+
+  blitz::TinyVector<int,4> cur_sol = 0;
+  int cur_max_area = 0;
+
+  std::vector<int> heights(width, 0), stack;
+  stack.reserve(width+1);
+  for (int y = 0; y < height; ++y){
+    for (int b = 0; b < bytes; ++b){
+      const uint8_t byte = packed_mask(y,b);
+      const int x0 = 8 * b, x1 = std::min(x0 + 8, width);
+      // whole bytes of false or true values are handled at once
+      if (byte == 0x00){
+        std::fill(heights.begin() + x0, heights.begin() + x1, 0);
+      } else if (byte == 0xFF){
+        for (int x = x0; x < x1; ++x) ++heights[x];
+      } else {
+        // the first column is stored in the most significant bit
+        for (int x = x0; x < x1; ++x)
+          heights[x] = (byte & (0x80 >> (x - x0))) ? heights[x] + 1 : 0;
+      }
     }
+    _max_rect_in_histogram(heights, y, stack, cur_sol, cur_max_area);
   }
 
   return cur_sol;
 }
 
 
+void bob::ip::base::nearestValidPixel(const blitz::Array<bool,2>& mask, blitz::Array<int,2>& nearest_y, blitz::Array<int,2>& nearest_x){
+  bob::core::array::assertSameShape(mask, nearest_y);
+  bob::core::array::assertSameShape(mask, nearest_x);
+  const int height = mask.extent(0), width = mask.extent(1);
 
+  // first pass: the nearest valid pixel in the same column, or -1 if the column has no valid pixel
+  for (int x = 0; x < width; ++x){
+    int last = -1;
+    for (int y = 0; y < height; ++y){
+      if (mask(y,x)) last = y;
+      nearest_y(y,x) = last;
+    }
+    last = -1;
+    for (int y = height-1; y >= 0; --y){
+      if (mask(y,x)) last = y;
+      if (last >= 0 && (nearest_y(y,x) < 0 || last - y < y - nearest_y(y,x))) nearest_y(y,x) = last;
+    }
+  }
+
+  // second pass: the lower envelope of the parabolas (x - x')^2 + (y - nearest_y(y,x'))^2 of all columns x' with a valid pixel in each row
+  std::vector<int> v(width);
+  std::vector<double> z(width+1);
+  std::vector<int> column_y(width);
+  for (int y = 0; y < height; ++y){
+    int k = -1;
+    for (int q = 0; q < width; ++q){
+      column_y[q] = nearest_y(y,q);
+      if (column_y[q] < 0) continue;
+      const double fq = static_cast<double>(column_y[q] - y) * (column_y[q] - y) + static_cast<double>(q) * q;
+      double s = 0.;
+      while (k >= 0){
+        const int p = v[k];
+        const double fp = static_cast<double>(column_y[p] - y) * (column_y[p] - y) + static_cast<double>(p) * p;
+        s = (fq - fp) / (2. * (q - p));
+        if (s > z[k]) break;
+        --k;
+      }
+      ++k;
+      v[k] = q;
+      z[k] = k ? s : -std::numeric_limits<double>::infinity();
+      z[k+1] = std::numeric_limits<double>::infinity();
+    }
+    if (k < 0) throw std::runtime_error("The given mask is invalid as it contains only 'False' values.");
+
+    // read the nearest valid pixel from the envelope
+    k = 0;
+    for (int x = 0; x < width; ++x){
+      while (z[k+1] < x) ++k;
+      nearest_x(y,x) = v[k];
+      nearest_y(y,x) = column_y[v[k]];
+    }
+  }
+}
@@ -0,0 +1,128 @@
+/**
+ * @date Sat Oct 17 20:14:37 CEST 2026
+ *
+ * This file implements the contrast limited adaptive histogram equalization (CLAHE)
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.base/CLAHE.h>
+
+bob::ip::base::CLAHE::CLAHE(
+  const blitz::TinyVector<int,2>& tiles,
+  const double clip_limit
+):
+  m_clip_limit(clip_limit),
+  m_bins(0)
+{
+  setTiles(tiles);
+}
+
+bob::ip::base::CLAHE::CLAHE(const CLAHE& other)
+:
+  m_tiles(other.m_tiles),
+  m_clip_limit(other.m_clip_limit),
+  m_bins(0)
+{
+}
+
+bob::ip::base::CLAHE& bob::ip::base::CLAHE::operator=(const bob::ip::base::CLAHE& other)
+{
+  if (this != &other)
+  {
+    m_tiles = other.m_tiles;
+    m_clip_limit = other.m_clip_limit;
+    // the workspace is recomputed with the next image
+    m_tile_y.clear();
+  }
+  return *this;
+}
+
+bool bob::ip::base::CLAHE::operator==(const bob::ip::base::CLAHE& b) const
+{
+  return (this->m_tiles[0] == b.m_tiles[0] && this->m_tiles[1] == b.m_tiles[1] && this->m_clip_limit == b.m_clip_limit);
+}
+
+bool bob::ip::base::CLAHE::operator!=(const bob::ip::base::CLAHE& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::ip::base::CLAHE::setTiles(const blitz::TinyVector<int,2>& tiles)
+{
+  if (tiles[0] < 1 || tiles[1] < 1)
+    throw std::runtime_error((boost::format("CLAHE: the number of tiles (%d, %d) needs to be positive") % tiles[0] % tiles[1]).str());
+  m_tiles = tiles;
+  // the workspace is recomputed with the next image
+  m_tile_y.clear();
+}
+
+/** computes the tile boundaries and, for each pixel position, the two surrounding tiles and the weight of the second one */
+static void _interpolation_weights(const int size, const int tiles, std::vector<int>& boundaries, std::vector<int>& first, std::vector<int>& second, std::vector<float>& weights, const int scale)
+{
+  boundaries.resize(tiles + 1);
+  for (int i = 0; i <= tiles; ++i)
+    boundaries[i] = static_cast<int>(static_cast<long>(size) * i / tiles);
+
+  first.resize(size);
+  second.resize(size);
+  weights.resize(size);
+  int tile = 0;
+  for (int p = 0; p < size; ++p){
+    // move to the last tile whose center is not right of the current pixel
+    while (tile + 1 < tiles && (boundaries[tile+1] + boundaries[tile+2] - 1) * 0.5 <= p) ++tile;
+    const double center = (boundaries[tile] + boundaries[tile+1] - 1) * 0.5;
+    if (p < center || tile + 1 == tiles){
+      // pixels in front of the first or behind the last tile center use the table of this tile only
+      first[p] = second[p] = tile * scale;
+      weights[p] = 0.f;
+    } else {
+      const double next = (boundaries[tile+1] + boundaries[tile+2] - 1) * 0.5;
+      first[p] = tile * scale;
+      second[p] = (tile + 1) * scale;
+      weights[p] = static_cast<float>((p - center) / (next - center));
+    }
+  }
+}
+
+void bob::ip::base::CLAHE::prepare(const int height, const int width, const int bins)
+{
+  if (height < m_tiles[0] || width < m_tiles[1])
+    throw std::runtime_error((boost::format("CLAHE: the image of size (%d, %d) is smaller than the number of tiles (%d, %d)") % height % width % m_tiles[0] % m_tiles[1]).str());
+
+  if (bins == m_bins && !m_tile_y.empty() && m_tile_y.back() == height && m_tile_x.back() == width)
+    return;
+
+  m_bins = bins;
+  m_tables.resize(static_cast<size_t>(m_tiles[0]) * m_tiles[1] * bins);
+  _interpolation_weights(height, m_tiles[0], m_tile_y, m_y0, m_y1, m_wy, 1);
+  _interpolation_weights(width, m_tiles[1], m_tile_x, m_x0, m_x1, m_wx, bins);
+}
+
+void bob::ip::base::CLAHE::computeTable(uint64_t* histogram, const uint64_t pixels, float* table) const
+{
+  if (m_clip_limit > 0.){
+    // clip the histogram and spread the clipped counts uniformly over all bins
+    const uint64_t limit = std::max(static_cast<uint64_t>(m_clip_limit * pixels / m_bins), static_cast<uint64_t>(1));
+    uint64_t clipped = 0;
+    for (int i = 0; i < m_bins; ++i){
+      if (histogram[i] > limit){
+        clipped += histogram[i] - limit;
+        histogram[i] = limit;
+      }
+    }
+    const uint64_t spread = clipped / m_bins;
+    uint64_t residual = clipped - spread * m_bins;
+    for (int i = 0; i < m_bins; ++i)
+      histogram[i] += spread;
+    // the remaining counts are distributed evenly over the histogram
+    if (residual){
+      const int step = std::max(static_cast<int>(m_bins / residual), 1);
+      for (int i = 0; i < m_bins && residual; i += step, --residual)
+        ++histogram[i];
+    }
+  }
+
+  // the table maps the cumulative distribution to the full range of the image type
+  _cumulativeTable(histogram, m_bins, static_cast<double>(m_bins - 1), pixels, 0., table);
+}
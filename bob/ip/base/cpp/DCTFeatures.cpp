@@ -11,6 +11,7 @@
 #include <bob.ip.base/ZigZag.h>
 
 #include <stdexcept>
+#include <cmath>
 
 bob::ip::base::DCTFeatures::DCTFeatures(
   const size_t n_dct_coefs,
@@ -20,7 +21,6 @@ bob::ip::base::DCTFeatures::DCTFeatures(
   const bool norm_dct,
   const bool square_pattern
 ):
-  m_dct2d(block_h, block_w),
   m_block_h(block_h), m_block_w(block_w), m_overlap_h(overlap_h),
   m_overlap_w(overlap_w), m_n_dct_coefs(n_dct_coefs),
   m_norm_block(norm_block), m_norm_dct(norm_dct),
@@ -28,13 +28,12 @@ bob::ip::base::DCTFeatures::DCTFeatures(
   m_norm_epsilon(10*std::numeric_limits<double>::epsilon())
 {
   setCheckSqrtNDctCoefs();
-  resetCache();
+  resetCacheDct();
 }
 
 
 bob::ip::base::DCTFeatures::DCTFeatures(const bob::ip::base::DCTFeatures& other)
 :
-  m_dct2d(other.m_dct2d),
   m_block_h(other.m_block_h), m_block_w(other.m_block_w),
   m_overlap_h(other.m_overlap_h), m_overlap_w(other.m_overlap_w),
   m_n_dct_coefs(other.m_n_dct_coefs),
@@ -43,7 +42,7 @@ bob::ip::base::DCTFeatures::DCTFeatures(const bob::ip::base::DCTFeatures& other)
   m_norm_epsilon(other.m_norm_epsilon)
 {
   setCheckSqrtNDctCoefs();
-  resetCache();
+  resetCacheDct();
 }
 
 
@@ -58,11 +57,10 @@ bob::ip::base::DCTFeatures& bob::ip::base::DCTFeatures::operator=(const bob::ip:
     m_n_dct_coefs = other.m_n_dct_coefs;
     m_norm_block = other.m_norm_block;
     m_norm_dct = other.m_norm_dct;
-    m_dct2d.setShape(m_block_h, m_block_w);
     m_square_pattern = other.m_square_pattern;
     m_norm_epsilon = other.m_norm_epsilon;
     setCheckSqrtNDctCoefs();
-    resetCache();
+    resetCacheDct();
   }
   return *this;
 }
@@ -81,21 +79,8 @@ void bob::ip::base::DCTFeatures::setCheckSqrtNDctCoefs()
   }
 }
 
-void bob::ip::base::DCTFeatures::resetCache() const
-{
-  resetCacheBlock();
-  resetCacheDct();
-}
-
-void bob::ip::base::DCTFeatures::resetCacheBlock() const
-{
-  m_cache_block1.resize(m_block_h, m_block_w);
-  m_cache_block2.resize(m_block_h, m_block_w);
-}
-
 void bob::ip::base::DCTFeatures::resetCacheDct() const
 {
-  m_cache_dct_full.resize(m_n_dct_coefs);
   const size_t m_n_dct_coefs_norm = m_n_dct_coefs - (m_norm_block?1:0);
   m_cache_dct1.resize(m_n_dct_coefs_norm);
   m_cache_dct2.resize(m_n_dct_coefs_norm);
@@ -118,48 +103,128 @@ bool bob::ip::base::DCTFeatures::operator!=(const bob::ip::base::DCTFeatures& b)
   return !(this->operator==(b));
 }
 
-void bob::ip::base::DCTFeatures::normalizeBlock(const blitz::Array<double,2>& b) const
+/** the scaled cosine of the orthonormal DCT-II of length n, as computed by bob::sp::DCT1D */
+static inline double _dct_cos(const int k, const int x, const int n)
 {
-  // Normalize block if required and extract DCT for the current block
-  if(m_norm_block)
+  return (k ? sqrt(2. / n) : sqrt(1. / n)) * cos(M_PI * (2 * x + 1) * k / (2. * n));
+}
+
+void bob::ip::base::DCTFeatures::prepareDct() const
+{
+  const int h = m_block_h, w = m_block_w;
+
+  // get the positions y * w + x of the kept coefficients, in the order of the features
+  std::vector<int> positions;
+  if (!m_square_pattern)
   {
-    double mean = blitz::mean(b);
-    double var = blitz::sum(blitz::pow2(b - mean)) / (double)(m_block_h * m_block_w);
-    double std = 1.;
-    if(var >= m_norm_epsilon) std = sqrt(var);
-    m_cache_block1 = (b - mean) / std;
-    m_dct2d(m_cache_block1, m_cache_block2);
+    blitz::Array<int,2> index(h, w);
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+        index(y,x) = y * w + x;
+    blitz::Array<int,1> order(m_n_dct_coefs);
+    zigzag(index, order);
+    positions.assign(order.data(), order.data() + m_n_dct_coefs);
   }
   else
-    m_dct2d(bob::core::array::ccopy(b), m_cache_block2);
+  {
+    if ((int)m_sqrt_n_dct_coefs > h || (int)m_sqrt_n_dct_coefs > w)
+      throw std::runtime_error((boost::format("bob::ip::DCTFeatures: Cannot use a square pattern of %d DCT coefficients with blocks of size (%d, %d)") % m_n_dct_coefs % h % w).str());
+    for (int y = 0; y < (int)m_sqrt_n_dct_coefs; ++y)
+      for (int x = 0; x < (int)m_sqrt_n_dct_coefs; ++x)
+        positions.push_back(y * w + x);
+  }
+  // the first coefficient is always zero for normalized blocks
+  if (m_norm_block)
+    positions.erase(positions.begin());
+
+  // only the rows and columns of the DCT that contain kept coefficients are computed
+  m_dct_rows = m_dct_columns = 0;
+  for (auto it = positions.begin(); it != positions.end(); ++it)
+  {
+    m_dct_rows = std::max(m_dct_rows, *it / w + 1);
+    m_dct_columns = std::max(m_dct_columns, *it % w + 1);
+  }
+  m_dct_row_lengths.assign(m_dct_rows, 0);
+  m_dct_index.resize(positions.size());
+  for (size_t k = 0; k < positions.size(); ++k)
+  {
+    const int u = positions[k] / w, v = positions[k] % w;
+    m_dct_row_lengths[u] = std::max(m_dct_row_lengths[u], v + 1);
+    m_dct_index[k] = u * m_dct_columns + v;
+  }
+
+  m_dct_cos_h.resize(m_dct_rows * h);
+  for (int u = 0; u < m_dct_rows; ++u)
+    for (int y = 0; y < h; ++y)
+      m_dct_cos_h[u * h + y] = _dct_cos(u, y, h);
+  m_dct_cos_w.resize(w * m_dct_columns);
+  for (int x = 0; x < w; ++x)
+    for (int v = 0; v < m_dct_columns; ++v)
+      m_dct_cos_w[x * m_dct_columns + v] = _dct_cos(v, x, w);
+
+  m_cache_rows.resize(h * m_dct_columns);
+  m_cache_coefs.resize(m_dct_rows * m_dct_columns);
 }
 
-void bob::ip::base::DCTFeatures::extractRowDCTCoefs(blitz::Array<double,1>& dst_row) const
+void bob::ip::base::DCTFeatures::blockDct(const double* block, const std::ptrdiff_t stride_y, const std::ptrdiff_t stride_x, double* dst, const std::ptrdiff_t dst_stride) const
 {
-  if (!m_square_pattern)
+  const int h = m_block_h, w = m_block_w, columns = m_dct_columns;
+
+  // Normalize block if required
+  double mean = 0., scale = 1.;
+  if (m_norm_block)
   {
-    if (m_norm_block)
+    double sum = 0.;
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+        sum += block[y * stride_y + x * stride_x];
+    mean = sum / (h * w);
+    double var = 0.;
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+      {
+        const double d = block[y * stride_y + x * stride_x] - mean;
+        var += d * d;
+      }
+    var /= h * w;
+    if (var >= m_norm_epsilon) scale = 1. / sqrt(var);
+  }
+
+  // horizontal transform of all rows, for the required columns only
+  double* rows = &m_cache_rows[0];
+  std::fill(rows, rows + h * columns, 0.);
+  for (int y = 0; y < h; ++y)
+  {
+    const double* b = block + y * stride_y;
+    double* r = rows + y * columns;
+    for (int x = 0; x < w; ++x)
     {
-      zigzag(m_cache_block2, m_cache_dct_full);
-      dst_row = m_cache_dct_full(blitz::Range(1,m_n_dct_coefs-1));
+      const double p = (b[x * stride_x] - mean) * scale;
+      const double* c = &m_dct_cos_w[x * columns];
+      for (int v = 0; v < columns; ++v)
+        r[v] += p * c[v];
     }
-    else
-      zigzag(m_cache_block2, dst_row);
   }
-  else
+
+  // vertical transform of the required columns, for the required rows only
+  double* coefs = &m_cache_coefs[0];
+  for (int u = 0; u < m_dct_rows; ++u)
   {
-    int r=0;
-    int beg=0;
-    if (m_norm_block)
+    double* t = coefs + u * columns;
+    const int length = m_dct_row_lengths[u];
+    std::fill(t, t + length, 0.);
+    const double* c = &m_dct_cos_h[u * h];
+    for (int y = 0; y < h; ++y)
     {
-      dst_row(blitz::Range(0,m_sqrt_n_dct_coefs-2)) = m_cache_block2(r,blitz::Range(1,m_sqrt_n_dct_coefs-1));
-      r += 1;
-      beg = m_sqrt_n_dct_coefs-1;
+      const double* r = rows + y * columns;
+      for (int v = 0; v < length; ++v)
+        t[v] += c[y] * r[v];
     }
-    blitz::Range ra(0,m_sqrt_n_dct_coefs-1);
-    for(; r<(int)m_sqrt_n_dct_coefs; ++r, beg+=m_sqrt_n_dct_coefs)
-      dst_row(blitz::Range(beg,beg+m_sqrt_n_dct_coefs-1)) = m_cache_block2(r,ra);
   }
+
+  // copy the kept coefficients in the order of the features
+  for (size_t k = 0; k < m_dct_index.size(); ++k)
+    dst[k * dst_stride] = coefs[m_dct_index[k]];
 }
 
 void bob::ip::base::DCTFeatures::extract_(const blitz::Array<double,2>& src, blitz::Array<double,2>& dst) const
@@ -170,21 +235,14 @@ void bob::ip::base::DCTFeatures::extract_(const blitz::Array<double,2>& src, bli
   blitz::TinyVector<int,2> shape = get2DOutputShape(src.shape());
   bob::core::array::assertSameShape(dst, shape);
 
-  // get all the blocks
-  const auto blocks = blockReference(src, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
+  // get a view of all the blocks
+  const blitz::Array<double,4> blocks = blockView(src, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
+  prepareDct();
 
-  /// dct extract each block
-  int i=0;
-  for(auto it = blocks.begin(); it != blocks.end(); ++it, ++i)
-  {
-    // Normalize input block (if required)
-    normalizeBlock(*it);
-
-    // Extract the required number of coefficients using the zigzag pattern
-    // and push it in the right dst row
-    blitz::Array<double,1> dst_row = dst(i, blitz::Range::all());
-    extractRowDCTCoefs(dst_row);
-  }
+  /// dct extract each block, and write the kept coefficients into the right dst row
+  for (int i = 0; i < blocks.extent(0); ++i)
+    for (int j = 0; j < blocks.extent(1); ++j)
+      blockDct(&blocks(i,j,0,0), blocks.stride(2), blocks.stride(3), &dst(i * blocks.extent(1) + j, 0), dst.stride(1));
 
   // Normalize dct if required
   if(m_norm_dct)
@@ -207,31 +265,14 @@ void bob::ip::base::DCTFeatures::extract_(const blitz::Array<double,2>& src, bli
   blitz::TinyVector<int,3> shape = get3DOutputShape(src.shape());
   bob::core::array::assertSameShape(dst, shape);
 
-  // get all the blocks
-  const auto blocks = blockReference(src, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
-  const blitz::TinyVector<int,4> block_shape = getBlock4DOutputShape(src.extent(0), src.extent(1), m_block_h, m_block_w, m_overlap_h, m_overlap_w);
+  // get a view of all the blocks
+  const blitz::Array<double,4> blocks = blockView(src, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
+  prepareDct();
 
-  /// dct extract each block
-  int i=0;
-  int j=0;
-  for(auto  it = blocks.begin(); it != blocks.end(); ++it)
-  {
-    // Normalize block if required and extract DCT for the current block
-    normalizeBlock(*it);
-
-    // Extract the required number of coefficients using the zigzag pattern
-    // and push it in the right dst row
-    blitz::Array<double,1> dst_row = dst(i, j, blitz::Range::all());
-    extractRowDCTCoefs(dst_row);
-    // Increment block indices
-    if (j>=shape(1)-1)
-    {
-      j=0;
-      ++i;
-    }
-    else
-      ++j;
-  }
+  /// dct extract each block, and write the kept coefficients into the right dst row
+  for (int i = 0; i < blocks.extent(0); ++i)
+    for (int j = 0; j < blocks.extent(1); ++j)
+      blockDct(&blocks(i,j,0,0), blocks.stride(2), blocks.stride(3), &dst(i,j,0), dst.stride(2));
 
   // Normalize dct if required
   if(m_norm_dct)
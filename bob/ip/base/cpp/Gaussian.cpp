@@ -13,11 +13,13 @@
 bob::ip::base::Gaussian::Gaussian(
   const size_t radius_y, const size_t radius_x,
   const double sigma_y, const double sigma_x,
-  const bob::sp::Extrapolation::BorderType border_type
+  const bob::sp::Extrapolation::BorderType border_type,
+  const bob::ip::base::GaussianAlgorithm algorithm
 ):
   m_radius_y(radius_y), m_radius_x(radius_x),
   m_sigma_y(sigma_y), m_sigma_x(sigma_x),
-  m_conv_border(border_type)
+  m_conv_border(border_type),
+  m_algorithm(algorithm)
 {
   computeKernel();
 }
@@ -27,7 +29,8 @@ bob::ip::base::Gaussian::Gaussian(const Gaussian& other)
 :
   m_radius_y(other.m_radius_y), m_radius_x(other.m_radius_x),
   m_sigma_y(other.m_sigma_y), m_sigma_x(other.m_sigma_x),
-  m_conv_border(other.m_conv_border)
+  m_conv_border(other.m_conv_border),
+  m_algorithm(other.m_algorithm)
 {
   computeKernel();
 }
@@ -56,13 +59,15 @@ void bob::ip::base::Gaussian::computeKernel()
 void bob::ip::base::Gaussian::reset(
   const size_t radius_y, const size_t radius_x,
   const double sigma_y, const double sigma_x,
-  const bob::sp::Extrapolation::BorderType border_type
+  const bob::sp::Extrapolation::BorderType border_type,
+  const bob::ip::base::GaussianAlgorithm algorithm
 ){
   m_radius_y = radius_y;
   m_radius_x = radius_x;
   m_sigma_y = sigma_y;
   m_sigma_x = sigma_x;
   m_conv_border = border_type;
+  m_algorithm = algorithm;
   computeKernel();
 }
 
@@ -75,6 +80,7 @@ bob::ip::base::Gaussian& bob::ip::base::Gaussian::operator=(const bob::ip::base:
     m_sigma_y = other.m_sigma_y;
     m_sigma_x = other.m_sigma_x;
     m_conv_border = other.m_conv_border;
+    m_algorithm = other.m_algorithm;
     computeKernel();
   }
   return *this;
@@ -84,7 +90,7 @@ bool bob::ip::base::Gaussian::operator==(const bob::ip::base::Gaussian& b) const
 {
   return (this->m_radius_y == b.m_radius_y && this->m_radius_x == b.m_radius_x &&
           this->m_sigma_y == b.m_sigma_y && this->m_sigma_x == b.m_sigma_x &&
-          this->m_conv_border == b.m_conv_border);
+          this->m_conv_border == b.m_conv_border && this->m_algorithm == b.m_algorithm);
 }
 
 bool bob::ip::base::Gaussian::operator!=(const bob::ip::base::Gaussian& b) const
@@ -92,35 +98,22 @@ bool bob::ip::base::Gaussian::operator!=(const bob::ip::base::Gaussian& b) const
   return !(this->operator==(b));
 }
 
-void bob::ip::base::Gaussian::filter_(const blitz::Array<double,2>& src, blitz::Array<double,2>& dst)
+bool bob::ip::base::Gaussian::isRecursive() const
 {
-  // Checks are postponed to the convolution function.
-  if(m_conv_border == bob::sp::Extrapolation::Zero)
-  {
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Same));
-    bob::sp::convSep(src, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Same);
-    bob::sp::convSep(m_tmp_int, m_kernel_x, dst, 1, bob::sp::Conv::Same);
-  }
-  else
-  {
-    m_tmp_int1.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(src, m_tmp_int1);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(src, m_tmp_int1);
-    else
-      bob::sp::extrapolateMirror(src, m_tmp_int1);
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(m_tmp_int1, m_kernel_y, 0, bob::sp::Conv::Valid));
-    bob::sp::convSep(m_tmp_int1, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Valid);
-
-    m_tmp_int2.resize(bob::sp::getConvSepOutputSize(m_tmp_int, m_kernel_x, 1, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(m_tmp_int, m_tmp_int2);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(m_tmp_int, m_tmp_int2);
-    else
-      bob::sp::extrapolateMirror(m_tmp_int, m_tmp_int2);
-    bob::sp::convSep(m_tmp_int2, m_kernel_x, dst, 1, bob::sp::Conv::Valid);
+  switch (m_algorithm){
+    case bob::ip::base::GAUSSIAN_RECURSIVE:
+      return true;
+    case bob::ip::base::GAUSSIAN_AUTOMATIC:{
+      // below this standard deviation, the convolution with the kernel is faster
+      static const double min_sigma = 3.;
+      return m_sigma_y >= min_sigma && m_sigma_x >= min_sigma && m_radius_y + 0.5 >= 3. * m_sigma_y && m_radius_x + 0.5 >= 3. * m_sigma_x;
+    }
+    default:
+      return false;
   }
 }
 
+void bob::ip::base::Gaussian::filter_(const blitz::Array<double,2>& src, blitz::Array<double,2>& dst)
+{
+  filter(src, dst);
+}
@@ -0,0 +1,189 @@
+/**
+ * @date Sat Oct 17 21:06:43 CEST 2026
+ *
+ * This file implements the integral histogram
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.base/IntegralHistogram.h>
+
+bob::ip::base::IntegralHistogram::IntegralHistogram(
+  const int bins,
+  const bool pixel_major
+):
+  m_pixel_major(pixel_major),
+  m_height(0),
+  m_width(0)
+{
+  setBins(bins);
+}
+
+bob::ip::base::IntegralHistogram::IntegralHistogram(const IntegralHistogram& other)
+:
+  m_bins(other.m_bins),
+  m_pixel_major(other.m_pixel_major),
+  m_height(other.m_height),
+  m_width(other.m_width),
+  m_table(other.m_table)
+{
+}
+
+bob::ip::base::IntegralHistogram& bob::ip::base::IntegralHistogram::operator=(const bob::ip::base::IntegralHistogram& other)
+{
+  if (this != &other)
+  {
+    m_bins = other.m_bins;
+    m_pixel_major = other.m_pixel_major;
+    m_height = other.m_height;
+    m_width = other.m_width;
+    m_table = other.m_table;
+  }
+  return *this;
+}
+
+bool bob::ip::base::IntegralHistogram::operator==(const bob::ip::base::IntegralHistogram& b) const
+{
+  return (this->m_bins == b.m_bins && this->m_pixel_major == b.m_pixel_major &&
+          this->m_height == b.m_height && this->m_width == b.m_width && this->m_table == b.m_table);
+}
+
+bool bob::ip::base::IntegralHistogram::operator!=(const bob::ip::base::IntegralHistogram& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::ip::base::IntegralHistogram::setBins(const int bins)
+{
+  if (bins < 1)
+    throw std::runtime_error((boost::format("IntegralHistogram: the number of bins (%d) needs to be positive") % bins).str());
+  m_bins = bins;
+  m_height = m_width = 0;
+  m_table.clear();
+}
+
+void bob::ip::base::IntegralHistogram::setPixelMajor(const bool pixel_major)
+{
+  m_pixel_major = pixel_major;
+  m_height = m_width = 0;
+  m_table.clear();
+}
+
+void bob::ip::base::IntegralHistogram::build(const int threads)
+{
+  const size_t size = static_cast<size_t>(m_height + 1) * (m_width + 1) * m_bins;
+  m_table.resize(size);
+  // small tables are computed in the current thread
+  parallelFor(m_bins, size < (1u<<18) ? 1 : threads, boost::bind(&IntegralHistogram::buildBins, this, _1, _2));
+}
+
+void bob::ip::base::IntegralHistogram::buildBins(const int begin, const int end)
+{
+  const size_t row = m_width + 1, plane = (m_height + 1) * row;
+  const int* labels = m_labels.data();
+  if (!m_pixel_major){
+    // one integral image per bin: the row sums of the bin indicator are added to the previous row;
+    // the rows are processed in the outer loop, so that the bin indices of the current row stay in the cache
+    for (int b = begin; b < end; ++b)
+      std::fill(&m_table[b * plane], &m_table[b * plane] + row, 0);
+    for (int y = 0; y < m_height; ++y){
+      const int* l = labels + static_cast<size_t>(y) * m_width;
+      for (int b = begin; b < end; ++b){
+        const uint32_t* prev = &m_table[b * plane + y * row];
+        uint32_t* cur = &m_table[b * plane + (y + 1) * row];
+        uint32_t sum = 0;
+        cur[0] = 0;
+        for (int x = 0; x < m_width; ++x){
+          sum += l[x] == b;
+          cur[x+1] = prev[x+1] + sum;
+        }
+      }
+    }
+  } else {
+    // all bins of a pixel are stored together: keep the histogram of the current row, and add it to the previous row
+    const int n = end - begin;
+    const size_t pixel = m_bins;
+    std::vector<uint32_t> sums(n);
+    for (int x = 0; x <= m_width; ++x)
+      std::fill(&m_table[x * pixel + begin], &m_table[x * pixel + begin] + n, 0);
+    for (int y = 0; y < m_height; ++y){
+      const int* l = labels + static_cast<size_t>(y) * m_width;
+      const uint32_t* prev = &m_table[y * row * pixel + begin];
+      uint32_t* cur = &m_table[(y + 1) * row * pixel + begin];
+      std::fill(cur, cur + n, 0);
+      std::fill(sums.begin(), sums.end(), 0);
+      for (int x = 0; x < m_width; ++x){
+        const unsigned bin = static_cast<unsigned>(l[x] - begin);
+        if (bin < static_cast<unsigned>(n)) ++sums[bin];
+        const uint32_t* p = prev + (x + 1) * pixel;
+        uint32_t* c = cur + (x + 1) * pixel;
+        for (int i = 0; i < n; ++i)
+          c[i] = p[i] + sums[i];
+      }
+    }
+  }
+}
+
+void bob::ip::base::IntegralHistogram::checkRectangle(const int top, const int left, const int height, const int width) const
+{
+  if (m_table.empty())
+    throw std::runtime_error("IntegralHistogram: no integral histogram has been computed yet");
+  if (top < 0 || left < 0 || height < 0 || width < 0 || top > m_height - height || left > m_width - width)
+    throw std::runtime_error((boost::format("IntegralHistogram: the rectangle (%d, %d, %d, %d) is not inside the image of size (%d, %d)") % top % left % height % width % m_height % m_width).str());
+}
+
+void bob::ip::base::IntegralHistogram::rectangleHistogram(const int top, const int left, const int height, const int width, uint64_t* dst, const std::ptrdiff_t dst_stride) const
+{
+  // the four corners of the rectangle in the table, which has an extra zero row and column
+  const size_t row = m_width + 1;
+  const size_t a = top * row + left, b = top * row + left + width, c = (top + height) * row + left, d = (top + height) * row + left + width;
+  const uint32_t* t = &m_table[0];
+  if (!m_pixel_major){
+    const size_t plane = (m_height + 1) * row;
+    for (int i = 0; i < m_bins; ++i, t += plane)
+      dst[i * dst_stride] = static_cast<uint32_t>(t[d] - t[b] - t[c] + t[a]);
+  } else {
+    const size_t pixel = m_bins;
+    const uint32_t* ta = t + a * pixel,* tb = t + b * pixel,* tc = t + c * pixel,* td = t + d * pixel;
+    for (int i = 0; i < m_bins; ++i)
+      dst[i * dst_stride] = static_cast<uint32_t>(td[i] - tb[i] - tc[i] + ta[i]);
+  }
+}
+
+void bob::ip::base::IntegralHistogram::histogram(const int top, const int left, const int height, const int width, blitz::Array<uint64_t,1>& dst) const
+{
+  if (dst.extent(0) != m_bins)
+    throw std::runtime_error((boost::format("IntegralHistogram: the given histogram needs to have %d elements, but has %d") % m_bins % dst.extent(0)).str());
+  checkRectangle(top, left, height, width);
+  rectangleHistogram(top, left, height, width, &dst(dst.lbound(0)), dst.stride(0));
+}
+
+void bob::ip::base::IntegralHistogram::histogramRange(const std::vector<const int32_t*>& rectangles, const std::ptrdiff_t rectangle_stride, const std::vector<uint64_t*>& dst, const std::ptrdiff_t dst_stride, const int begin, const int end) const
+{
+  for (int i = begin; i < end; ++i){
+    const int32_t* r = rectangles[i];
+    rectangleHistogram(r[0], r[rectangle_stride], r[2*rectangle_stride], r[3*rectangle_stride], dst[i], dst_stride);
+  }
+}
+
+void bob::ip::base::IntegralHistogram::histograms(const blitz::Array<int32_t,2>& rectangles, blitz::Array<uint64_t,2>& dst, const int threads) const
+{
+  if (rectangles.extent(1) != 4)
+    throw std::runtime_error((boost::format("IntegralHistogram: the rectangles need to be given as (top, left, height, width), but %d values per rectangle are given") % rectangles.extent(1)).str());
+  if (dst.extent(0) != rectangles.extent(0) || dst.extent(1) != m_bins)
+    throw std::runtime_error((boost::format("IntegralHistogram: the given histograms need to be of size (%d, %d), but have shape (%d, %d)") % rectangles.extent(0) % m_bins % dst.extent(0) % dst.extent(1)).str());
+
+  // check all rectangles and collect the row pointers before the threads are started
+  const int count = rectangles.extent(0);
+  std::vector<const int32_t*> rows(count);
+  std::vector<uint64_t*> dst_rows(count);
+  for (int i = 0; i < count; ++i){
+    const int y = rectangles.lbound(0) + i, x = rectangles.lbound(1);
+    checkRectangle(rectangles(y,x), rectangles(y,x+1), rectangles(y,x+2), rectangles(y,x+3));
+    rows[i] = &rectangles(y,x);
+    dst_rows[i] = &dst(dst.lbound(0) + i, dst.lbound(1));
+  }
+
+  // few rectangles are processed in the current thread
+  parallelFor(count, static_cast<double>(count) * m_bins < (1 << 16) ? 1 : threads, boost::bind(&IntegralHistogram::histogramRange, this, boost::cref(rows), rectangles.stride(1), boost::cref(dst_rows), dst.stride(1), _1, _2));
+}
@@ -21,6 +21,8 @@ bob::ip::base::MultiscaleRetinex::MultiscaleRetinex(
   m_size_step(size_step),
   m_sigma(sigma),
   m_conv_border(border_type),
+  m_reduced_resolution(false),
+  m_algorithm(bob::ip::base::GAUSSIAN_CONVOLUTION),
   m_gaussians(new bob::ip::base::Gaussian[m_n_scales])
 {
   computeKernels();
@@ -34,6 +36,8 @@ bob::ip::base::MultiscaleRetinex::MultiscaleRetinex(const MultiscaleRetinex& oth
   m_size_step(other.m_size_step),
   m_sigma(other.m_sigma),
   m_conv_border(other.m_conv_border),
+  m_reduced_resolution(other.m_reduced_resolution),
+  m_algorithm(other.m_algorithm),
   m_gaussians(new bob::ip::base::Gaussian[m_n_scales])
 {
   computeKernels();
@@ -49,8 +53,32 @@ void bob::ip::base::MultiscaleRetinex::computeKernels()
     // sigma of the kernel
     double s_sigma = m_sigma * s_size / m_size_min;
     // Initialize the Gaussian
-    m_gaussians[s].reset(s_size, s_size, s_sigma, s_sigma, m_conv_border);
+    m_gaussians[s].reset(s_size, s_size, s_sigma, s_sigma, m_conv_border, m_algorithm);
   }
+  // the Gaussians of the reduced resolution mode are set up in computeLevels()
+  m_reduced_gaussians.reset(new bob::ip::base::Gaussian[m_n_scales]);
+  m_levels.clear();
+  m_pyramid_gaussian.reset(3, 3, 1., 1., m_conv_border);
+}
+
+int bob::ip::base::MultiscaleRetinex::computeLevels(const int height, const int width)
+{
+  m_levels.assign(m_n_scales, 0);
+  if (!m_reduced_resolution) return 0;
+  int max_levels = 0;
+  for (size_t s=0; s<m_n_scales; ++s)
+  {
+    // the truncated kernel is approximated by a Gaussian with the same standard deviation; the recursive approximation is not truncated
+    const double sigma = m_gaussians[s].isRecursive() ? m_gaussians[s].getSigmaY() : _truncated_sigma(m_gaussians[s].getSigmaY(), m_gaussians[s].getRadiusY());
+    m_levels[s] = _decimation_levels(sigma, height, width);
+    if (!m_levels[s]) continue;
+    // remaining smoothing, in pixels of the decimated image
+    const double s_sigma = sqrt(sigma * sigma - _pyramid_variance(m_levels[s])) / (1 << m_levels[s]);
+    const size_t s_radius = (size_t)ceil(3. * s_sigma);
+    m_reduced_gaussians[s].reset(s_radius, s_radius, s_sigma, s_sigma, m_conv_border, m_algorithm);
+    max_levels = std::max(max_levels, m_levels[s]);
+  }
+  return max_levels;
 }
 
 void bob::ip::base::MultiscaleRetinex::reset(
@@ -79,6 +107,8 @@ bob::ip::base::MultiscaleRetinex& bob::ip::base::MultiscaleRetinex::operator=(co
     m_size_step = other.m_size_step;
     m_sigma = other.m_sigma;
     m_conv_border = other.m_conv_border;
+    m_reduced_resolution = other.m_reduced_resolution;
+    m_algorithm = other.m_algorithm;
     computeKernels();
   }
   return *this;
@@ -88,7 +118,9 @@ bool bob::ip::base::MultiscaleRetinex::operator==(const bob::ip::base::Multiscal
 {
   return (this->m_n_scales == b.m_n_scales && this->m_size_min== b.m_size_min &&
           this->m_size_step == b.m_size_step && this->m_sigma == b.m_sigma &&
-          this->m_conv_border == b.m_conv_border);
+          this->m_conv_border == b.m_conv_border &&
+          this->m_reduced_resolution == b.m_reduced_resolution &&
+          this->m_algorithm == b.m_algorithm);
 }
 
 bool bob::ip::base::MultiscaleRetinex::operator!=(const bob::ip::base::MultiscaleRetinex& b) const
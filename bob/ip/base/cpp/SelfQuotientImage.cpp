@@ -7,7 +7,14 @@
  * Copyright (C) Idiap Research Institute, Martigny, Switzerland
  */
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <boost/bind.hpp>
 #include <bob.ip.base/SelfQuotientImage.h>
+#include <bob.ip.base/GaussianScaleSpace.h>
+#include <bob.ip.base/IntegralImage.h>
+#include <bob.ip.base/Parallel.h>
 
 bob::ip::base::SelfQuotientImage::SelfQuotientImage(
     const size_t n_scales,
@@ -21,6 +28,8 @@ bob::ip::base::SelfQuotientImage::SelfQuotientImage(
   m_size_step(size_step),
   m_sigma(sigma),
   m_conv_border(border_type),
+  m_threads(0),
+  m_reduced_resolution(false),
   m_wgaussians(new bob::ip::base::WeightedGaussian[m_n_scales])
 {
   computeKernels();
@@ -33,6 +42,8 @@ bob::ip::base::SelfQuotientImage::SelfQuotientImage(const bob::ip::base::SelfQuo
   m_size_step(other.m_size_step),
   m_sigma(other.m_sigma),
   m_conv_border(other.m_conv_border),
+  m_threads(other.m_threads),
+  m_reduced_resolution(other.m_reduced_resolution),
   m_wgaussians(new bob::ip::base::WeightedGaussian[m_n_scales])
 {
   computeKernels();
@@ -50,6 +61,39 @@ void bob::ip::base::SelfQuotientImage::computeKernels()
     // Initialize the Gaussian
     m_wgaussians[s].reset(s_size, s_size, s_sigma, s_sigma, m_conv_border);
   }
+  m_levels.clear();
+  m_n_reduced = 0;
+}
+
+void bob::ip::base::SelfQuotientImage::computeLevels(const int height, const int width)
+{
+  m_levels.assign(m_n_scales, 0);
+  m_n_reduced = 0;
+  if (!m_reduced_resolution) return;
+  for (size_t s=0; s<m_n_scales; ++s)
+  {
+    const double sigma = _truncated_sigma(m_wgaussians[s].getSigmaY(), m_wgaussians[s].getRadiusY());
+    m_levels[s] = _decimation_levels(sigma, height, width);
+    if (m_levels[s]) ++m_n_reduced;
+  }
+}
+
+void bob::ip::base::SelfQuotientImage::processReduced(const int height, const int width)
+{
+  if (m_reduced_log.extent(0) != height || m_reduced_log.extent(1) != width)
+    m_reduced_log.resize(height, width);
+  m_reduced_log = 0.;
+  const blitz::TinyVector<int,2> shape(height, width);
+  for (size_t s=0; s<m_n_scales; ++s)
+  {
+    if (!m_levels[s]) continue;
+    // the weighted Gaussian is evaluated exactly at the samples of the decimated image
+    const int step = 1 << m_levels[s];
+    m_tmp_reduced.resize((height - 1) / step + 1, (width - 1) / step + 1);
+    parallelFor(m_tmp_reduced.extent(0), m_threads, boost::bind(&WeightedGaussian::filterSamples, &m_wgaussians[s], boost::cref(m_src_extra), boost::cref(m_src_integral), boost::cref(shape), step, boost::ref(m_tmp_reduced), _1, _2));
+    _upsample_bilinear(m_tmp_reduced, m_levels[s], m_tmp);
+    m_reduced_log += blitz::log(m_tmp + 1.);
+  }
 }
 
 void bob::ip::base::SelfQuotientImage::reset(
@@ -78,6 +122,8 @@ bob::ip::base::SelfQuotientImage& bob::ip::base::SelfQuotientImage::operator=(co
     m_size_step = other.m_size_step;
     m_sigma = other.m_sigma;
     m_conv_border = other.m_conv_border;
+    m_threads = other.m_threads;
+    m_reduced_resolution = other.m_reduced_resolution;
     computeKernels();
   }
   return *this;
@@ -87,7 +133,8 @@ bool bob::ip::base::SelfQuotientImage::operator==(const bob::ip::base::SelfQuoti
 {
   return (this->m_n_scales == b.m_n_scales && this->m_size_min== b.m_size_min &&
           this->m_size_step == b.m_size_step && this->m_sigma == b.m_sigma &&
-          this->m_conv_border == b.m_conv_border);
+          this->m_conv_border == b.m_conv_border &&
+          this->m_reduced_resolution == b.m_reduced_resolution);
 }
 
 bool bob::ip::base::SelfQuotientImage::operator!=(const bob::ip::base::SelfQuotientImage& b) const
@@ -95,3 +142,50 @@ bool bob::ip::base::SelfQuotientImage::operator!=(const bob::ip::base::SelfQuoti
   return !(this->operator==(b));
 }
 
+void bob::ip::base::SelfQuotientImage::processExtrapolated(blitz::Array<double,2>& dst)
+{
+  m_src_integral.resize(m_src_extra.extent(0) + 1, m_src_extra.extent(1) + 1);
+  bob::ip::base::integral(m_src_extra, m_src_integral, true, m_threads);
+  if (m_tmp.extent(0) != dst.extent(0) || m_tmp.extent(1) != dst.extent(1))
+    m_tmp.resize(dst.extent(0), dst.extent(1));
+
+  // In reduced resolution mode, the large scales are computed at the samples of a decimated image
+  computeLevels(dst.extent(0), dst.extent(1));
+  if (m_n_reduced) processReduced(dst.extent(0), dst.extent(1));
+
+  // The rows are distributed over the threads; each thread evaluates all scales for its rows
+  parallelFor(dst.extent(0), m_threads, boost::bind(&SelfQuotientImage::processRows, this, boost::ref(dst), _1, _2));
+}
+
+void bob::ip::base::SelfQuotientImage::processRows(blitz::Array<double,2>& dst, const int begin, const int end)
+{
+  const int width = dst.extent(1);
+  const int offset_y = (m_src_extra.extent(0) - dst.extent(0)) / 2,
+            offset_x = (m_src_extra.extent(1) - width) / 2;
+  std::vector<double> log_src(width);
+  for (int y = begin; y < end; ++y){
+    // the log of the input image is computed once for all scales, unless it was looked up already
+    if (m_log_src.size()){
+      const double* log_row = &m_log_src(y, 0);
+      std::copy(log_row, log_row + width, log_src.begin());
+    } else {
+      const double* src = &m_src_extra(y + offset_y, offset_x);
+      for (int x = 0; x < width; ++x) log_src[x] = std::log(src[x] + 1.);
+    }
+    double* tmp = &m_tmp(y, 0);
+    for (int x = 0; x < width; ++x) dst(y,x) = 0.;
+    for (size_t s = 0; s < m_n_scales; ++s){
+      if (m_levels[s]) continue;
+      m_wgaussians[s].filterRows(m_src_extra, m_src_integral, m_tmp, y, y+1);
+      for (int x = 0; x < width; ++x)
+        dst(y,x) += (log_src[x] - std::log(tmp[x] + 1.));
+    }
+    if (m_n_reduced){
+      // scales that were computed at reduced resolution
+      const double* reduced = &m_reduced_log(y, 0);
+      for (int x = 0; x < width; ++x)
+        dst(y,x) += (m_n_reduced * log_src[x] - reduced[x]);
+    }
+    for (int x = 0; x < width; ++x) dst(y,x) /= (double)m_n_scales;
+  }
+}
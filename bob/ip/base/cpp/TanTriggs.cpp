@@ -7,6 +7,7 @@
  * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
  */
 
+#include <algorithm>
 #include <bob.ip.base/TanTriggs.h>
 
 bob::ip::base::TanTriggs::TanTriggs(
@@ -88,56 +89,75 @@ bool bob::ip::base::TanTriggs::operator!=(const bob::ip::base::TanTriggs& b) con
   return !(this->operator==(b));
 }
 
-void bob::ip::base::TanTriggs::performContrastEqualization(blitz::Array<double,2>& dst)
+void bob::ip::base::TanTriggs::performContrastEqualization(blitz::Array<double,2>& dst, blitz::Array<double,2>& outer)
 {
   const double inv_alpha = 1./m_alpha;
   const double wxh = dst.extent(0)*dst.extent(1);
-
+  const int width = dst.extent(1);
+
+  // first pass: compute the DoG image I and mean(abs(I)^a)
+  // abs(I)^a is kept in outer, so that pow() is computed only once per pixel
+  double sum_alpha = 0.;
+  for (int y = 0; y < dst.extent(0); ++y){
+    double* o = &outer(y,0);
+    for (int x = 0; x < width; ++x){
+      const double d = dst(y,x) - o[x];
+      dst(y,x) = d;
+      o[x] = pow(fabs(d), m_alpha);
+      sum_alpha += o[x];
+    }
+  }
   // first step: I:=I/mean(abs(I)^a)^(1/a)
-  blitz::Range dst_y( dst.lbound(0), dst.ubound(0)),
-               dst_x( dst.lbound(1), dst.ubound(1));
-  double norm_fact =
-    pow( sum( pow( fabs(dst(dst_y,dst_x)), m_alpha)) / wxh, inv_alpha);
-  dst(dst_y,dst_x) /= norm_fact;
+  const double mean_alpha = sum_alpha / wxh;
+  const double norm_fact1 = pow(mean_alpha, inv_alpha);
 
-  // Second step: I:=I/mean(min(threshold,abs(I))^a)^(1/a)
+  // second pass (read only): mean(min(threshold,abs(I))^a) of the normalized image,
+  // using abs(I/n)^a = abs(I)^a / n^a
   const double threshold_alpha = pow( m_threshold, m_alpha );
-  norm_fact =  pow( sum( min( threshold_alpha,
-    pow( fabs(dst(dst_y,dst_x)), m_alpha))) / wxh, inv_alpha);
-  dst(dst_y,dst_x) /= norm_fact;
+  const double inv_mean_alpha = 1. / mean_alpha;
+  double sum_min = 0.;
+  for (int y = 0; y < dst.extent(0); ++y){
+    const double* o = &outer(y,0);
+    for (int x = 0; x < width; ++x)
+      sum_min += std::min(threshold_alpha, o[x] * inv_mean_alpha);
+  }
+  // Second step: I:=I/mean(min(threshold,abs(I))^a)^(1/a)
+  const double norm_fact2 = pow( sum_min / wxh, inv_alpha);
 
-  // Last step: I:= threshold * tanh( I / threshold )
-  dst(dst_y,dst_x) = m_threshold * tanh( dst(dst_y,dst_x) / m_threshold );
+  // Last step, which applies both normalizations: I:= threshold * tanh( I / threshold )
+  const double scale = 1. / (norm_fact1 * norm_fact2 * m_threshold);
+  for (int y = 0; y < dst.extent(0); ++y)
+    for (int x = 0; x < width; ++x)
+      dst(y,x) = m_threshold * tanh( dst(y,x) * scale );
 }
 
 
 void bob::ip::base::TanTriggs::computeDoG(double sigma0, double sigma1, size_t size)
 {
-  // Generates two Gaussians with the given standard deviations
+  // Generates two 1D Gaussians with the given standard deviations
   // Warning: size should be odd
-  blitz::Array<double,2> g0(size,size);
-  blitz::Array<double,2> g1(size,size);
+  m_kernel0.resize(size);
+  m_kernel1.resize(size);
   const double inv_sigma0_2 = 0.5  / (sigma0*sigma0);
   const double inv_sigma1_2 = 0.5  / (sigma1*sigma1);
   int center = ((int)size) / 2;
-  for(int y=0; y<(int)size; ++y)
-    for(int x=0; x<(int)size; ++x)
-    {
-      int yy = y - center;
-      int xx = x - center;
-      int xx2 = xx*xx;
-      int yy2 = yy*yy;
-
-      g0(y,x) = exp( - inv_sigma0_2 * (xx2 + yy2) );
-      g1(y,x) = exp( - inv_sigma1_2 * (xx2 + yy2) );
-    }
+  for(int x=0; x<(int)size; ++x)
+  {
+    int xx = x - center;
+    int xx2 = xx*xx;
+
+    m_kernel0(x) = exp( - inv_sigma0_2 * xx2 );
+    m_kernel1(x) = exp( - inv_sigma1_2 * xx2 );
+  }
 
   // Normalize the kernels such that the sum over the area is equal to 1
-  // and compute the Difference of Gaussian filter
-  const double inv_sum0 = 1. / blitz::sum(g0);
-  const double inv_sum1 = 1. / blitz::sum(g1);
+  m_kernel0 /= blitz::sum(m_kernel0);
+  m_kernel1 /= blitz::sum(m_kernel1);
+
+  // The 2D Gaussians are the outer products of the 1D Gaussians,
+  // so that the Difference of Gaussian filter can be applied as two separable convolutions
   m_kernel.resize( size, size);
-  m_kernel = inv_sum0 * g0 - inv_sum1 * g1;
+  for(int y=0; y<(int)size; ++y)
+    for(int x=0; x<(int)size; ++x)
+      m_kernel(y,x) = m_kernel0(y) * m_kernel0(x) - m_kernel1(y) * m_kernel1(x);
 }
-
-
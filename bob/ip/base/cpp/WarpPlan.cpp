@@ -0,0 +1,148 @@
+/**
+ * @date Sat Oct 17 10:12:43 CEST 2026
+ *
+ * This file defines a class that caches the bi-linear interpolation of a geometric transformation
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <boost/format.hpp>
+#include <bob.core/array_copy.h>
+#include <bob.ip.base/WarpPlan.h>
+
+bob::ip::base::WarpPlan::WarpPlan(
+    const blitz::TinyVector<int,2>& src_shape,
+    const blitz::TinyVector<double,2>& src_center,
+    const blitz::TinyVector<int,2>& dst_shape,
+    const blitz::TinyVector<double,2>& dst_center,
+    const blitz::TinyVector<double,2>& scaling_factor,
+    const double rotation_angle
+):
+  m_src_shape(src_shape)
+{
+  init(src_center, dst_shape, dst_center, scaling_factor, rotation_angle);
+}
+
+bob::ip::base::WarpPlan::WarpPlan(
+    const GeomNorm& geomNorm,
+    const blitz::TinyVector<int,2>& src_shape,
+    const blitz::TinyVector<double,2>& center
+):
+  m_src_shape(src_shape)
+{
+  init(center, geomNorm.getCropSize(), geomNorm.getCropOffset(), blitz::TinyVector<double,2>(geomNorm.getScalingFactor(), geomNorm.getScalingFactor()), geomNorm.getRotationAngle());
+}
+
+bob::ip::base::WarpPlan::WarpPlan(
+    const FaceEyesNorm& faceEyesNorm,
+    const blitz::TinyVector<int,2>& src_shape,
+    const blitz::TinyVector<double,2>& rightEye,
+    const blitz::TinyVector<double,2>& leftEye
+):
+  m_src_shape(src_shape)
+{
+  blitz::TinyVector<double,2> center;
+  GeomNorm geomNorm = faceEyesNorm.computeGeomNorm(rightEye, leftEye, center);
+  init(center, geomNorm.getCropSize(), geomNorm.getCropOffset(), blitz::TinyVector<double,2>(geomNorm.getScalingFactor(), geomNorm.getScalingFactor()), geomNorm.getRotationAngle());
+}
+
+bob::ip::base::WarpPlan::WarpPlan(const WarpPlan& other):
+  m_src_shape(other.m_src_shape),
+  m_offsets(bob::core::array::ccopy(other.m_offsets)),
+  m_weights(bob::core::array::ccopy(other.m_weights)),
+  m_counts(bob::core::array::ccopy(other.m_counts)),
+  m_valid(bob::core::array::ccopy(other.m_valid))
+{
+}
+
+bob::ip::base::WarpPlan& bob::ip::base::WarpPlan::operator=(const bob::ip::base::WarpPlan& other)
+{
+  if (this != &other)
+  {
+    m_src_shape = other.m_src_shape;
+    m_offsets.reference(bob::core::array::ccopy(other.m_offsets));
+    m_weights.reference(bob::core::array::ccopy(other.m_weights));
+    m_counts.reference(bob::core::array::ccopy(other.m_counts));
+    m_valid.reference(bob::core::array::ccopy(other.m_valid));
+  }
+  return *this;
+}
+
+void bob::ip::base::WarpPlan::init(
+    const blitz::TinyVector<double,2>& src_center,
+    const blitz::TinyVector<int,2>& dst_shape,
+    const blitz::TinyVector<double,2>& dst_center,
+    const blitz::TinyVector<double,2>& scaling_factor,
+    const double rotation_angle
+)
+{
+  if (m_src_shape[0] < 1 || m_src_shape[1] < 1) throw std::runtime_error((boost::format("the source shape (%d, %d) of the warp plan must be positive") % m_src_shape[0] % m_src_shape[1]).str());
+
+  const int size_y = dst_shape[0], size_x = dst_shape[1];
+  m_offsets.resize(size_y, size_x, 4);
+  m_weights.resize(size_y, size_x, 4);
+  m_counts.resize(size_y, size_x);
+  m_valid.resize(size_y, size_x);
+
+  // The source positions are computed exactly as in bob::ip::base::transform, so that the results are identical
+  const double sin_angle = -sin(rotation_angle * M_PI / 180.),
+               cos_angle = cos(rotation_angle * M_PI / 180.);
+
+  const double col_dy = -sin_angle / scaling_factor[0],
+               col_dx = cos_angle / scaling_factor[1];
+  const double row_dy = cos_angle / scaling_factor[0],
+               row_dx = sin_angle / scaling_factor[1];
+
+  double origin_y = src_center[0] - (dst_center[0] * cos_angle - dst_center[1] * sin_angle) / scaling_factor[0];
+  double origin_x = src_center[1] - (dst_center[1] * cos_angle + dst_center[0] * sin_angle) / scaling_factor[1];
+
+  const int h = m_src_shape[0]-1;
+  const int w = m_src_shape[1]-1;
+  const std::ptrdiff_t width = m_src_shape[1];
+
+  std::ptrdiff_t* offsets = m_offsets.data();
+  double* weights = m_weights.data();
+  for (int y = 0; y < size_y; ++y){
+    double source_x = origin_x, source_y = origin_y;
+    for (int x = 0; x < size_x; ++x, offsets += 4, weights += 4){
+      const int ox = std::floor(source_x);
+      const int oy = std::floor(source_y);
+      const double mx = source_x - ox;
+      const double my = source_y - oy;
+
+      // the four neighbors: upper left, upper right, lower left, lower right
+      const bool inside[] = {
+        ox >= 0 && oy >= 0 && ox <= w && oy <= h,
+        ox >= -1 && oy >= 0 && ox < w && oy <= h,
+        ox >= 0 && oy >= -1 && ox <= w && oy < h,
+        ox >= -1 && oy >= -1 && ox < w && oy < h
+      };
+      const double weight[] = {(1.-mx) * (1.-my), mx * (1.-my), (1.-mx) * my, mx * my};
+      const std::ptrdiff_t offset[] = {oy * width + ox, oy * width + ox + 1, (oy+1) * width + ox, (oy+1) * width + ox + 1};
+
+      // pixels outside of the image are skipped, so that they are never accessed
+      bool valid = true;
+      int count = 0;
+      for (int i = 0; i < 4; ++i){
+        if (inside[i]){
+          offsets[count] = offset[i];
+          weights[count] = weight[i];
+          ++count;
+        } else if (weight[i] > 0.){
+          valid = false;
+        }
+      }
+      for (int i = count; i < 4; ++i){
+        offsets[i] = 0;
+        weights[i] = 0.;
+      }
+      m_counts(y,x) = count;
+      m_valid(y,x) = valid;
+
+      source_y += col_dy;
+      source_x += col_dx;
+    }
+    origin_y += row_dy;
+    origin_x += row_dx;
+  }
+}
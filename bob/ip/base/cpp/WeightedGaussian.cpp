@@ -8,9 +8,9 @@
  * Copyright (C) Idiap Research Institute, Martigny, Switzerland
  */
 
-#include <boost/format.hpp>
-#include <stdexcept>
+#include <boost/bind.hpp>
 #include <bob.ip.base/IntegralImage.h>
+#include <bob.ip.base/Parallel.h>
 #include <bob.ip.base/WeightedGaussian.h>
 
 
@@ -23,7 +23,8 @@ bob::ip::base::WeightedGaussian::WeightedGaussian(
   m_radius_x(radius_x),
   m_sigma_y(sigma_y),
   m_sigma_x(sigma_x),
-  m_conv_border(border_type)
+  m_conv_border(border_type),
+  m_threads(0)
 {
   computeKernel();
 }
@@ -35,7 +36,8 @@ bob::ip::base::WeightedGaussian::WeightedGaussian(const WeightedGaussian& other)
   m_radius_x(other.m_radius_x),
   m_sigma_y(other.m_sigma_y),
   m_sigma_x(other.m_sigma_x),
-  m_conv_border(other.m_conv_border)
+  m_conv_border(other.m_conv_border),
+  m_threads(other.m_threads)
 {
   computeKernel();
 }
@@ -44,7 +46,6 @@ bob::ip::base::WeightedGaussian::WeightedGaussian(const WeightedGaussian& other)
 void bob::ip::base::WeightedGaussian::computeKernel()
 {
   m_kernel.resize(2 * m_radius_y + 1, 2 * m_radius_x + 1);
-  m_kernel_weighted.resize(2 * m_radius_y + 1, 2 * m_radius_x + 1);
   // Computes the kernel
   const double inv_sigma_y = 1.0 / (m_sigma_y*m_sigma_y);
   const double inv_sigma_x = 1.0 / (m_sigma_x*m_sigma_x);
@@ -78,6 +79,7 @@ bob::ip::base::WeightedGaussian& bob::ip::base::WeightedGaussian::operator=(cons
     m_sigma_y = other.m_sigma_y;
     m_sigma_x = other.m_sigma_x;
     m_conv_border = other.m_conv_border;
+    m_threads = other.m_threads;
     computeKernel();
   }
   return *this;
@@ -97,69 +99,76 @@ bool bob::ip::base::WeightedGaussian::operator!=(const bob::ip::base::WeightedGa
 
 void bob::ip::base::WeightedGaussian::filter_(const blitz::Array<double,2>& src, blitz::Array<double,2>& dst)
 {
-  // Checks input
-  bob::core::array::assertZeroBase(src);
-  bob::core::array::assertZeroBase(dst);
-  bob::core::array::assertSameShape(src, dst);
-  if(src.extent(0)<m_kernel.extent(0)) {
-    boost::format m("The convolutional kernel has the first dimension larger than the corresponding one of the array to process (%d > %d). Our convolution code does not allows. You could try to revert the order of the two arrays.");
-    m % src.extent(0) % m_kernel.extent(0);
-    throw std::runtime_error(m.str());
-  }
-  if(src.extent(1)<m_kernel.extent(1)) {
-    boost::format m("The convolutional kernel has the second dimension larger than the corresponding one of the array to process (%d > %d). Our convolution code does not allows. You could try to revert the order of the two arrays.");
-    m % src.extent(1) % m_kernel.extent(1);
+  filter(src, dst);
+}
+
+void bob::ip::base::WeightedGaussian::filterExtrapolated(blitz::Array<double,2>& dst)
+{
+  // Integral image of the extrapolated src, used to compute the mean values
+  m_src_integral.resize(m_src_extra.extent(0) + 1, m_src_extra.extent(1) + 1);
+  bob::ip::base::integral(m_src_extra, m_src_integral, true, m_threads);
+
+  // Small images are not worth starting threads for
+  const double operations = (double)dst.numElements() * m_kernel.numElements();
+  const int threads = operations < (1 << 18) ? 1 : m_threads;
+  parallelFor(dst.extent(0), threads, boost::bind(&WeightedGaussian::filterRows, this, boost::cref(m_src_extra), boost::cref(m_src_integral), boost::ref(dst), _1, _2));
+}
+
+void bob::ip::base::WeightedGaussian::filterRows(const blitz::Array<double,2>& src_extra, const blitz::Array<double,2>& src_integral, blitz::Array<double,2>& dst, const int begin, const int end) const
+{
+  filterSamples(src_extra, src_integral, dst.shape(), 1, dst, begin, end);
+}
+
+void bob::ip::base::WeightedGaussian::filterSamples(const blitz::Array<double,2>& src_extra, const blitz::Array<double,2>& src_integral, const blitz::TinyVector<int,2>& shape, const int step, blitz::Array<double,2>& dst, const int begin, const int end) const
+{
+  const int kernel_height = m_kernel.extent(0), kernel_width = m_kernel.extent(1);
+  // offset of the window of this filter inside the (possibly larger) extrapolated image
+  const int offset_y = (src_extra.extent(0) - shape[0]) / 2 - (int)m_radius_y,
+            offset_x = (src_extra.extent(1) - shape[1]) / 2 - (int)m_radius_x;
+  if (offset_y < 0 || offset_x < 0) {
+    boost::format m("The extrapolated image (%dx%d) is too small for the kernel (%dx%d) and the image (%dx%d)");
+    m % src_extra.extent(0) % src_extra.extent(1) % kernel_height % kernel_width % shape[0] % shape[1];
     throw std::runtime_error(m.str());
   }
+  const double n_elem = m_kernel.numElements();
+  const double* kernel = m_kernel.data();
+  const double* extra = src_extra.data() + offset_y * src_extra.extent(1) + offset_x;
+  const int extra_width = src_extra.extent(1);
 
-  // 1/ Extrapolation of src
-  // Resize temporary extrapolated src array
-  blitz::TinyVector<int,2> shape = src.shape();
-  shape(0) += 2 * (int)m_radius_y;
-  shape(1) += 2 * (int)m_radius_x;
-  m_src_extra.resize(shape);
-
-  // Extrapolate
-  if(m_conv_border == bob::sp::Extrapolation::Zero)
-    bob::sp::extrapolateZero(src, m_src_extra);
-  else if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-    bob::sp::extrapolateNearest(src, m_src_extra);
-  else if(m_conv_border == bob::sp::Extrapolation::Circular)
-    bob::sp::extrapolateCircular(src, m_src_extra);
-  else
-    bob::sp::extrapolateMirror(src, m_src_extra);
-
-  // 2/ Integral image then mean values
-  shape += 1;
-  m_src_integral.resize(shape);
-  bob::ip::base::integral(m_src_extra, m_src_integral, true);
-
-  // 3/ Convolution
-  double n_elem = m_kernel.numElements();
-  for(int y=0; y<src.extent(0); ++y)
-    for(int x=0; x<src.extent(1); ++x)
+  for(int y=begin; y<end; ++y)
+    for(int x=0; x<dst.extent(1); ++x)
     {
       // Computes the threshold associated to the current location
       // Integral image is used to speed up the process
-      blitz::Array<double,2> src_slice = m_src_extra(
-        blitz::Range(y,y+2*(int)m_radius_y), blitz::Range(x,x+2*(int)m_radius_x));
-      double threshold = (m_src_integral(y,x) +
-          m_src_integral(y+2*(int)m_radius_y+1,x+2*(int)m_radius_x+1) -
-          m_src_integral(y,x+2*(int)m_radius_x+1) -
-          m_src_integral(y+2*(int)m_radius_y+1,x)
+      const int iy = y * step + offset_y, ix = x * step + offset_x;
+      const double threshold = (src_integral(iy,ix) +
+          src_integral(iy+kernel_height,ix+kernel_width) -
+          src_integral(iy,ix+kernel_width) -
+          src_integral(iy+kernel_height,ix)
         ) / n_elem;
-      // Computes the weighted Gaussian kernel at this location
-      // a/ M1 is the set of pixels whose values are above the threshold
-      if( blitz::sum(src_slice >= threshold) >= n_elem/2.)
-        m_kernel_weighted = blitz::where(src_slice >= threshold, m_kernel, 0.);
-      // b/ M1 is the set of pixels whose values are below the threshold
-      else
-        m_kernel_weighted = blitz::where(src_slice < threshold, m_kernel, 0.);
-      // Normalizes the kernel
-      m_kernel_weighted /= blitz::sum(m_kernel_weighted);
-      // Convolves: This is indeed not a real convolution but a multiplication,
+      // Accumulates, in a single sweep over the window, the kernel weights and the weighted sums
+      // of the pixels above (M1) and below (M2) the threshold
+      // The masks are applied arithmetically, so that the inner loop does not branch
+      double count_above = 0., weight_above = 0., weight_below = 0., sum_above = 0., sum_below = 0.;
+      for (int ky = 0; ky < kernel_height; ++ky){
+        const double* k = kernel + ky * kernel_width;
+        const double* s = extra + (y * step + ky) * extra_width + x * step;
+        for (int kx = 0; kx < kernel_width; ++kx){
+          const double above = s[kx] >= threshold ? 1. : 0.;
+          const double w = k[kx], ws = w * s[kx];
+          count_above += above;
+          weight_above += above * w;
+          weight_below += w - above * w;
+          sum_above += above * ws;
+          sum_below += ws - above * ws;
+        }
+      }
+      // Uses the weighted Gaussian kernel normalized on the larger set of pixels
+      // This is indeed not a real convolution but a multiplication,
       // as it seems that the authors aim at exclusively using the M1 part
-      dst(y,x) = blitz::sum(src_slice * m_kernel_weighted);
+      if (count_above >= n_elem/2.)
+        dst(y,x) = sum_above / weight_above;
+      else
+        dst(y,x) = sum_below / weight_below;
     }
 }
-
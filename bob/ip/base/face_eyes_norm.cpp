@@ -337,59 +337,80 @@ static auto extract = bob::extension::FunctionDoc(
   ".. note::\n\n  Instead of the eyes, any two fixed positions can be used to normalize the face. "
   "This can simply be achieved by selecting two other nodes in the constructor (see :py:class:`FaceEyesNorm`) and in this function. "
   "Just make sure that 'right' and 'left' refer to the same landmarks in both functions.\n\n"
+  "The ``output`` image can be of type numpy.uint8, numpy.float32 or numpy.float64; for numpy.uint8, the interpolated values are rounded and saturated. "
+  "When the ``output`` is returned, its type can be selected with the ``dtype`` parameter, which can only be given as a keyword argument.\n\n"
+  "For 3D color images, all color planes are normalized in a single pass. "
+  "By default, the color planes are stored in the first dimension; with ``layout='interleaved'``, images of shape ``(height, width, planes)`` are accepted. "
+  "The ``layout`` can only be given as a keyword argument.\n\n"
   ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
   true
 )
-.add_prototype("input, right_eye, left_eye", "output")
-.add_prototype("input, output, right_eye, left_eye")
-.add_prototype("input, input_mask, output, output_mask, right_eye, left_eye")
+.add_prototype("input, right_eye, left_eye, [dtype], [layout]", "output")
+.add_prototype("input, output, right_eye, left_eye, [layout]")
+.add_prototype("input, input_mask, output, output_mask, right_eye, left_eye, [layout]")
 .add_parameter("input", "array_like (2D or 3D)", "The input image to which FaceEyesNorm should be applied")
-.add_parameter("output", "array_like (2D or 3D, float)", "The output image, which must be of size :py:attr:`crop_size`")
+.add_parameter("output", "array_like (2D or 3D, uint8, float32 or float64)", "The output image, which must be of size :py:attr:`crop_size`")
 .add_parameter("right_eye", "(float, float)", "The position of the right eye (or another landmark) in ``input`` image coordinates.")
 .add_parameter("left_eye", "(float, float)", "The position of the left eye (or another landmark) in ``input`` image coordinates.")
 .add_parameter("input_mask", "array_like (2D, bool)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
 .add_parameter("output_mask", "array_like (2D, bool)", "The output mask of valid pixels after geometric normalization, must be of same size as ``output``")
-.add_return("output", "array_like(2D or 3D, float)", "The resulting normalized face image, which is of size :py:attr:`crop_size`")
+.add_parameter("dtype", ":py:class:`numpy.dtype`", "[Default: ``numpy.float64``] The data type of the returned ``output`` image; one of ``numpy.uint8``, ``numpy.float32`` or ``numpy.float64``")
+.add_parameter("layout", "str", "[Default: ``'planar'``] The memory layout of 3D images, one of ``'planar'`` or ``'interleaved'``; ignored for 2D images")
+.add_return("output", "array_like(2D or 3D)", "The resulting normalized face image, which is of size :py:attr:`crop_size`")
 ;
 
-template <typename T>
-static void extract_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& right, const blitz::TinyVector<double,2>& left){
+template <typename T, typename U>
+static void extract_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& right, const blitz::TinyVector<double,2>& left, bob::ip::base::ColorLayout layout){
   if (input->ndim == 3){
-    auto a = blitz::Range::all();
-    for (int i = 0; i < input->shape[0]; ++i){
-      const blitz::Array<T,2> in = (*PyBlitzArrayCxx_AsBlitz<T,3>(input))(i,a,a);
-      blitz::Array<double,2> out = (*PyBlitzArrayCxx_AsBlitz<double,3>(output))(i,a,a);
-      if (input_mask && output_mask){
-        self->cxx->extract(in, *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), out, *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
-      } else {
-        self->cxx->extract(in, out, right, left);
+    if (input_mask && output_mask){
+      // the same 2D masks are used for all color planes
+      auto in = PyBlitzArrayCxx_AsBlitz<T,3>(input);
+      auto out = PyBlitzArrayCxx_AsBlitz<U,3>(output);
+      for (int i = 0; i < in->extent(bob::ip::base::_plane_dim(layout)); ++i){
+        blitz::Array<U,2> out_plane = bob::ip::base::_image_plane(*out, i, layout);
+        self->cxx->extract(bob::ip::base::_image_plane(*in, i, layout), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), out_plane, *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
       }
+    } else {
+      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<U,3>(output), right, left, layout);
     }
   } else {
     if (input_mask && output_mask){
-      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
+      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
     } else {
-      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<double,2>(output), right, left);
+      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<U,2>(output), right, left);
     }
   }
 }
 
+template <typename T>
+static void extract_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& right, const blitz::TinyVector<double,2>& left, bob::ip::base::ColorLayout layout){
+  switch (output->type_num){
+    case NPY_UINT8:   extract_inner<T,uint8_t>(self, input, input_mask, output, output_mask, right, left, layout); break;
+    case NPY_FLOAT32: extract_inner<T,float>(self, input, input_mask, output, output_mask, right, left, layout); break;
+    default:          extract_inner<T,double>(self, input, input_mask, output, output_mask, right, left, layout); break;
+  }
+}
+
 static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
   char** kwlist1 = extract.kwlist(0);
   char** kwlist2 = extract.kwlist(1);
   char** kwlist3 = extract.kwlist(2);
 
-  // get the number of command line arguments
+  // get the number of command line arguments, without the optional data type and layout
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "dtype")) --nargs;
+  if (kwargs && PyDict_GetItemString(kwargs, "layout")) --nargs;
 
   PyBlitzArrayObject* input = 0,* input_mask = 0,* output = 0,* output_mask = 0;
   blitz::TinyVector<double,2> right(0,0), left(0,0);
+  int type_num = NPY_FLOAT64;
+  const char* layout = "planar";
 
   switch (nargs){
     case 3:{
       // with input only
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(dd)(dd)", kwlist1, &PyBlitzArray_Converter, &input, &right[0], &right[1], &left[0], &left[1])){
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(dd)(dd)|O&s", kwlist1, &PyBlitzArray_Converter, &input, &right[0], &right[1], &left[0], &left[1], &PyBlitzArray_TypenumConverter, &type_num, &layout)){
         extract.print_usage();
         return 0;
       }
@@ -397,7 +418,7 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
     }
     case 4:{
       // with input and output
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&(dd)(dd)", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &right[0], &right[1], &left[0], &left[1])){
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&(dd)(dd)|s", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &right[0], &right[1], &left[0], &left[1], &layout)){
         extract.print_usage();
         return 0;
       }
@@ -405,7 +426,7 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
     }
     case 6:{
       // with mask
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&(dd)(dd)", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask, &right[0], &right[1], &left[0], &left[1])){
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&(dd)(dd)|s", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask, &right[0], &right[1], &left[0], &left[1], &layout)){
         extract.print_usage();
         return 0;
       }
@@ -421,6 +442,8 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
   auto input_ = make_safe(input), output_ = make_xsafe(output);
   auto input_mask_ = make_xsafe(input_mask), output_mask_ = make_xsafe(output_mask);
 
+  const bob::ip::base::ColorLayout color = color_layout(layout);
+
   if (input->ndim != 2 and input->ndim != 3){
     extract.print_usage();
     PyErr_Format(PyExc_TypeError, "'%s' only 2D or 3D facial images can be normalized", Py_TYPE(self)->tp_name);
@@ -434,20 +457,28 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
       PyErr_Format(PyExc_TypeError, "'%s' the 'output' array must have the same number of dimensions as 'input' (2D or 3D)", Py_TYPE(self)->tp_name);
       return 0;
     }
-    if (output->type_num != NPY_FLOAT64){
+    if (output->type_num != NPY_UINT8 && output->type_num != NPY_FLOAT32 && output->type_num != NPY_FLOAT64){
       extract.print_usage();
-      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type float64", Py_TYPE(self)->tp_name);
+      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type uint8, float32 or float64", Py_TYPE(self)->tp_name);
       return 0;
     }
   } else {
+    if (type_num != NPY_UINT8 && type_num != NPY_FLOAT32 && type_num != NPY_FLOAT64){
+      extract.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s': the 'dtype' must be uint8, float32 or float64", Py_TYPE(self)->tp_name);
+      return 0;
+    }
     // create output in the desired dimensions
     auto shape = self->cxx->getCropSize();
     if (input->ndim == 2){
       Py_ssize_t n[] = {shape[0], shape[1]};
-      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 2, n));
+    } else if (color == bob::ip::base::LAYOUT_INTERLEAVED){
+      Py_ssize_t n[] = {shape[0], shape[1], input->shape[2]};
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
     } else {
       Py_ssize_t n[] = {input->shape[0], shape[0], shape[1]};
-      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
     }
     output_ = make_safe(output);
   }
@@ -467,9 +498,9 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
 
   // finally, process the data
   switch (input->type_num){
-    case NPY_UINT8:   extract_inner<uint8_t>(self, input, input_mask, output, output_mask, right, left); break;
-    case NPY_UINT16:  extract_inner<uint16_t>(self, input, input_mask, output, output_mask, right, left); break;
-    case NPY_FLOAT64: extract_inner<double>(self, input, input_mask, output, output_mask, right, left); break;
+    case NPY_UINT8:   extract_inner<uint8_t>(self, input, input_mask, output, output_mask, right, left, color); break;
+    case NPY_UINT16:  extract_inner<uint16_t>(self, input, input_mask, output, output_mask, right, left, color); break;
+    case NPY_FLOAT64: extract_inner<double>(self, input, input_mask, output, output_mask, right, left, color); break;
     default:
       PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
       extract.print_usage();
@@ -485,6 +516,172 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
   BOB_CATCH_MEMBER("cannot extract face from image", 0)
 }
 
+static auto extractBatch = bob::extension::FunctionDoc(
+  "extract_batch",
+  "This function extracts and normalizes several faces at once",
+  "The faces are defined by their eye positions, where the i'th row of ``right_eyes`` and ``left_eyes`` contain the eye positions of the i'th face. "
+  "When ``input`` is a 2D image, all faces are extracted from this image, e.g., when several faces were detected in one frame. "
+  "When ``input`` is 3D, the i'th face is extracted from the i'th 2D image ``input[i]``. "
+  "The i'th normalized face is written to ``output[i]``.\n\n"
+  "The faces are distributed over several threads. "
+  "In opposition to :py:meth:`extract`, this function does not update the :py:attr:`last_angle`, :py:attr:`last_scale`, :py:attr:`last_offset` and :py:attr:`geom_norm` of this object.\n\n"
+  "The ``output`` images can be of type numpy.uint8, numpy.float32 or numpy.float64, see :py:meth:`extract`.\n\n"
+  ".. note::\n\n  The ``threads`` and ``dtype`` parameters can only be given as keyword arguments.",
+  true
+)
+.add_prototype("input, right_eyes, left_eyes, [threads], [dtype]", "output")
+.add_prototype("input, output, right_eyes, left_eyes, [threads]")
+.add_prototype("input, input_mask, output, output_mask, right_eyes, left_eyes, [threads]")
+.add_parameter("input", "array_like (2D or 3D)", "The gray image containing all faces, or a stack of gray images with one face each")
+.add_parameter("output", "array_like (3D, uint8, float32 or float64)", "The output images, which must be of size ``(N,) + crop_size``")
+.add_parameter("right_eyes", "array_like (2D, float)", "The positions of the right eyes (or other landmarks) of the N faces in ``input`` image coordinates, of shape ``(N, 2)``")
+.add_parameter("left_eyes", "array_like (2D, float)", "The positions of the left eyes (or other landmarks) of the N faces in ``input`` image coordinates, of shape ``(N, 2)``")
+.add_parameter("input_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
+.add_parameter("output_mask", "array_like (bool, 3D)", "The output masks of valid pixels after geometric normalization, must be of same size as ``output``")
+.add_parameter("threads", "int", "[Default: 0] The number of threads to use; if ``0``, all available cores are used")
+.add_parameter("dtype", ":py:class:`numpy.dtype`", "[Default: ``numpy.float64``] The data type of the returned ``output`` images; one of ``numpy.uint8``, ``numpy.float32`` or ``numpy.float64``")
+.add_return("output", "array_like(3D)", "The resulting normalized face images, which is of size ``(N,) + crop_size``")
+;
+
+template <typename T, typename U, int D>
+static void extract_batch_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, PyBlitzArrayObject* right, PyBlitzArrayObject* left, int threads){
+  if (input_mask && output_mask){
+    self->cxx->extractBatch(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,3>(output), *PyBlitzArrayCxx_AsBlitz<bool,3>(output_mask), *PyBlitzArrayCxx_AsBlitz<double,2>(right), *PyBlitzArrayCxx_AsBlitz<double,2>(left), threads);
+  } else {
+    self->cxx->extractBatch(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,3>(output), *PyBlitzArrayCxx_AsBlitz<double,2>(right), *PyBlitzArrayCxx_AsBlitz<double,2>(left), threads);
+  }
+}
+
+template <typename T, int D>
+static void extract_batch_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, PyBlitzArrayObject* right, PyBlitzArrayObject* left, int threads){
+  switch (output->type_num){
+    case NPY_UINT8:   extract_batch_inner<T,uint8_t,D>(self, input, input_mask, output, output_mask, right, left, threads); break;
+    case NPY_FLOAT32: extract_batch_inner<T,float,D>(self, input, input_mask, output, output_mask, right, left, threads); break;
+    default:          extract_batch_inner<T,double,D>(self, input, input_mask, output, output_mask, right, left, threads); break;
+  }
+}
+
+static PyObject* PyBobIpBaseFaceEyesNorm_extractBatch(PyBobIpBaseFaceEyesNormObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist1 = extractBatch.kwlist(0);
+  char** kwlist2 = extractBatch.kwlist(1);
+  char** kwlist3 = extractBatch.kwlist(2);
+
+  // get the number of command line arguments, without the optional number of threads and data type
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "threads")) --nargs;
+  if (kwargs && PyDict_GetItemString(kwargs, "dtype")) --nargs;
+
+  PyBlitzArrayObject* input = 0,* input_mask = 0,* output = 0,* output_mask = 0,* right = 0,* left = 0;
+  int threads = 0;
+  int type_num = NPY_FLOAT64;
+
+  switch (nargs){
+    case 3:{
+      // with input only
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&|iO&", kwlist1, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &right, &PyBlitzArray_Converter, &left, &threads, &PyBlitzArray_TypenumConverter, &type_num)){
+        extractBatch.print_usage();
+        return 0;
+      }
+      break;
+    }
+    case 4:{
+      // with input and output
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&|i", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_Converter, &right, &PyBlitzArray_Converter, &left, &threads)){
+        extractBatch.print_usage();
+        return 0;
+      }
+      break;
+    }
+    case 6:{
+      // with mask
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&O&O&|i", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask, &PyBlitzArray_Converter, &right, &PyBlitzArray_Converter, &left, &threads)){
+        extractBatch.print_usage();
+        return 0;
+      }
+      break;
+    }
+    default:{
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' extract_batch called with wrong number of parameters", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } // switch
+
+  auto input_ = make_safe(input), output_ = make_xsafe(output);
+  auto input_mask_ = make_xsafe(input_mask), output_mask_ = make_xsafe(output_mask);
+  auto right_ = make_safe(right), left_ = make_safe(left);
+
+  if (input->ndim != 2 and input->ndim != 3){
+    extractBatch.print_usage();
+    PyErr_Format(PyExc_TypeError, "'%s' only 2D images or 3D image stacks can be normalized", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (right->ndim != 2 || left->ndim != 2 || right->type_num != NPY_FLOAT64 || left->type_num != NPY_FLOAT64 || right->shape[0] != left->shape[0] || right->shape[1] != 2 || left->shape[1] != 2){
+    extractBatch.print_usage();
+    PyErr_Format(PyExc_TypeError, "'%s' the eye positions must be 2D arrays of type float64 and shape (N, 2)", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (output){
+    // check that data type is correct and dimensions fit
+    if (output->ndim != 3){
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s' the 'output' array must be 3D", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (output->type_num != NPY_UINT8 && output->type_num != NPY_FLOAT32 && output->type_num != NPY_FLOAT64){
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type uint8, float32 or float64", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    if (type_num != NPY_UINT8 && type_num != NPY_FLOAT32 && type_num != NPY_FLOAT64){
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s': the 'dtype' must be uint8, float32 or float64", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    // create output in the desired dimensions
+    auto shape = self->cxx->getCropSize();
+    Py_ssize_t n[] = {right->shape[0], shape[0], shape[1]};
+    output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+    output_ = make_safe(output);
+  }
+
+  if (input_mask && output_mask){
+    if (input_mask->ndim != input->ndim || output_mask->ndim != 3){
+      PyErr_Format(PyExc_TypeError, "`%s' masks must have the same shape as the input or output matrix", Py_TYPE(self)->tp_name);
+      extractBatch.print_usage();
+      return 0;
+    }
+    if (input_mask->type_num != NPY_BOOL || output_mask->type_num != NPY_BOOL){
+      PyErr_Format(PyExc_TypeError, "`%s' masks must be of boolean type", Py_TYPE(self)->tp_name);
+      extractBatch.print_usage();
+      return 0;
+    }
+  }
+
+  // finally, process the data
+  switch (input->type_num){
+    case NPY_UINT8:   if (input->ndim == 2) extract_batch_inner<uint8_t,2>(self, input, input_mask, output, output_mask, right, left, threads);  else extract_batch_inner<uint8_t,3>(self, input, input_mask, output, output_mask, right, left, threads); break;
+    case NPY_UINT16:  if (input->ndim == 2) extract_batch_inner<uint16_t,2>(self, input, input_mask, output, output_mask, right, left, threads); else extract_batch_inner<uint16_t,3>(self, input, input_mask, output, output_mask, right, left, threads); break;
+    case NPY_FLOAT64: if (input->ndim == 2) extract_batch_inner<double,2>(self, input, input_mask, output, output_mask, right, left, threads);   else extract_batch_inner<double,3>(self, input, input_mask, output, output_mask, right, left, threads); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      extractBatch.print_usage();
+      return 0;
+  }
+
+  if (nargs == 3){
+    return PyBlitzArray_AsNumpyArray(output,0);
+  } else {
+    Py_RETURN_NONE;
+  }
+
+  BOB_CATCH_MEMBER("cannot extract faces from image", 0)
+}
+
 static PyMethodDef PyBobIpBaseFaceEyesNorm_methods[] = {
   {
     extract.name(),
@@ -492,6 +689,12 @@ static PyMethodDef PyBobIpBaseFaceEyesNorm_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     extract.doc()
   },
+  {
+    extractBatch.name(),
+    (PyCFunction)PyBobIpBaseFaceEyesNorm_extractBatch,
+    METH_VARARGS|METH_KEYWORDS,
+    extractBatch.doc()
+  },
   {0} /* Sentinel */
 };
 
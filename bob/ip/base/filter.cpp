@@ -19,7 +19,10 @@ bob::extension::FunctionDoc s_median = bob::extension::FunctionDoc(
   "Both gray-level and color images are supported, and the input and output datatype must be identical.\n\n"
   "Median filtering iterates with a mask of size ``(2*radius[0]+1, 2*radius[1]+1)`` over the input image. "
   "For each input region, the pixels under the mask are sorted and the median value (the middle element of the sorted list) is written into the ``dst`` image. "
-  "Therefore, the ``dst`` is smaller than the ``src`` image, i.e., by ``2*radius`` pixels."
+  "Therefore, the ``dst`` is smaller than the ``src`` image, i.e., by ``2*radius`` pixels.\n\n"
+  "For masks of size ``(3,3)`` and ``(5,5)``, the median is selected with sorting networks. "
+  "Larger masks of ``uint8`` and ``uint16`` images are filtered with sliding histograms, where the time per pixel of ``uint8`` images does not depend on the radius. "
+  "The layers of color images are processed in parallel."
 )
 .add_prototype("src, radius, [dst]", "dst")
 .add_parameter("src", "array_like (2D or 3D)", "The source image to filter, might be a gray level image or a color image")
@@ -69,7 +72,7 @@ PyObject* PyBobIpBase_median(PyObject*, PyObject* args, PyObject* kwargs) {
   switch (src->type_num){
     case NPY_UINT8:   if (src->ndim == 2) return inner_median<uint8_t,2>(src, dst, radius);  else return inner_median<uint8_t,3>(src, dst, radius);
     case NPY_UINT16:  if (src->ndim == 2) return inner_median<uint16_t,2>(src, dst, radius); else return inner_median<uint16_t,3>(src, dst, radius);
-    case NPY_FLOAT16: if (src->ndim == 2) return inner_median<double,2>(src, dst, radius);   else return inner_median<double,3>(src, dst, radius);
+    case NPY_FLOAT64: if (src->ndim == 2) return inner_median<double,2>(src, dst, radius);   else return inner_median<double,3>(src, dst, radius);
     default:
       PyErr_Format(PyExc_ValueError, "'median' of %s arrays is currently not supported, only uint8, uint16 or float64 arrays are", PyBlitzArray_TypenumAsString(src->type_num));
       return 0;
@@ -86,34 +89,47 @@ bob::extension::FunctionDoc s_sobel = bob::extension::FunctionDoc(
   "The two filter are given as: \n\n"
   ".. math:: S_y =  \\left\\lgroup\\begin{array}{ccc} -1 & -2 & -1 \\\\ 0 & 0 & 0 \\\\ 1 & 2 & 1 \\end{array}\\right\\rgroup \\qquad S_x = \\left\\lgroup\\begin{array}{ccc} -1 & 0 & 1 \\\\ -2 & 0 & 2 \\\\ -1 & 0 & 1 \\end{array}\\right\\rgroup\n\n"
   "If given, the dst array should have the expected type (numpy.float64) and two layers of the same size as the input image. "
-  "Finally, the result of the vertical filter will be put into the first layer of ``dst[0]``, while the result of the horizontal filter will be written to ``dst[1]``."
+  "For ``uint8`` and ``uint16`` images, the dst array might also be of type numpy.int32, in which case the filters are computed exactly in integer arithmetic. "
+  "Finally, the result of the vertical filter will be put into the first layer of ``dst[0]``, while the result of the horizontal filter will be written to ``dst[1]``.\n\n"
+  "Both filters are computed together in a single sweep over the image. "
+  "If the ``magnitude`` and ``orientation`` arrays are given, the gradient magnitude :math:`\\sqrt{S_y^2 + S_x^2}` and the gradient orientation :math:`\\operatorname{atan2}(S_y, S_x)` are computed in the same sweep."
 )
-.add_prototype("src, [border], [dst]", "dst")
-.add_parameter("src", "array_like (2D, float)", "The source image to filter")
+.add_prototype("src, [border], [dst], [magnitude], [orientation]", "dst")
+.add_parameter("src", "array_like (2D, uint8, uint16 or float)", "The source image to filter")
 .add_parameter("border", ":py:class:`bob.sp.BorderType`", "[default: ``bob.sp.BorderType.Mirror``] The extrapolation method used by the convolution at the border")
-.add_parameter("dst", "array_like (3D, float)", "The Sobel-filtered image to write; need to be of size ``[2] + src.shape``; if not specified, it will be created")
-.add_return("dst", "array_like (3D, float)", "The Sobel-filtered image; the same as the ``dst`` parameter, if specified")
+.add_parameter("dst", "array_like (3D, float or int32)", "The Sobel-filtered image to write; need to be of size ``[2] + src.shape``; if not specified, it will be created with type float")
+.add_parameter("magnitude", "array_like (2D, float)", "If given, the gradient magnitude will be written into this array, which needs to have the same size as ``src``; requires ``orientation`` to be given as well")
+.add_parameter("orientation", "array_like (2D, float)", "If given, the gradient orientation in radians will be written into this array, which needs to have the same size as ``src``; requires ``magnitude`` to be given as well")
+.add_return("dst", "array_like (3D, float or int32)", "The Sobel-filtered image; the same as the ``dst`` parameter, if specified")
 ;
 
+template <typename T, typename U> PyObject* inner_sobel(PyBlitzArrayObject* src, PyBlitzArrayObject* dst, PyBlitzArrayObject* magnitude, PyBlitzArrayObject* orientation, bob::sp::Extrapolation::BorderType border) {
+  if (magnitude)
+    bob::ip::base::sobel(*PyBlitzArrayCxx_AsBlitz<T,2>(src), *PyBlitzArrayCxx_AsBlitz<U,3>(dst), *PyBlitzArrayCxx_AsBlitz<double,2>(magnitude), *PyBlitzArrayCxx_AsBlitz<double,2>(orientation), border);
+  else
+    bob::ip::base::sobel(*PyBlitzArrayCxx_AsBlitz<T,2>(src), *PyBlitzArrayCxx_AsBlitz<U,3>(dst), border);
+  return PyBlitzArray_AsNumpyArray(dst, 0);
+}
+
 PyObject* PyBobIpBase_sobel(PyObject*, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
   char** kwlist = s_sobel.kwlist();
 
-  PyBlitzArrayObject* src,* dst = 0;
+  PyBlitzArrayObject* src,* dst = 0,* magnitude = 0,* orientation = 0;
   bob::sp::Extrapolation::BorderType border = bob::sp::Extrapolation::Mirror;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&O&", kwlist, &PyBlitzArray_Converter, &src, &PyBobSpExtrapolationBorder_Converter, &border, &PyBlitzArray_OutputConverter, &dst)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&O&O&O&", kwlist, &PyBlitzArray_Converter, &src, &PyBobSpExtrapolationBorder_Converter, &border, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &magnitude, &PyBlitzArray_OutputConverter, &orientation)) return 0;
 
-  auto src_ = make_safe(src), dst_ = make_xsafe(dst);
+  auto src_ = make_safe(src), dst_ = make_xsafe(dst), magnitude_ = make_xsafe(magnitude), orientation_ = make_xsafe(orientation);
 
-  if (src->ndim != 2 || src->type_num != NPY_FLOAT64){
-    PyErr_Format(PyExc_TypeError, "'sobel' : 'src' must be 2D and of type float, but it is %dD and of type %s.", (int)src->ndim, PyBlitzArray_TypenumAsString(src->type_num));
+  if (src->ndim != 2 || (src->type_num != NPY_UINT8 && src->type_num != NPY_UINT16 && src->type_num != NPY_FLOAT64)){
+    PyErr_Format(PyExc_TypeError, "'sobel' : 'src' must be 2D and of type uint8, uint16 or float, but it is %dD and of type %s.", (int)src->ndim, PyBlitzArray_TypenumAsString(src->type_num));
     return 0;
   }
   if (dst){
-    if (dst->ndim != 3 || dst->type_num != NPY_FLOAT64){
-      PyErr_Format(PyExc_TypeError, "'sobel' : 'dst' must be 3D and of type float, but it is %dD and of type %s.", (int)dst->ndim, PyBlitzArray_TypenumAsString(dst->type_num));
+    if (dst->ndim != 3 || (dst->type_num != NPY_FLOAT64 && (dst->type_num != NPY_INT32 || src->type_num == NPY_FLOAT64))){
+      PyErr_Format(PyExc_TypeError, "'sobel' : 'dst' must be 3D and of type float (or int32 for integral 'src' images), but it is %dD and of type %s.", (int)dst->ndim, PyBlitzArray_TypenumAsString(dst->type_num));
       return 0;
     }
   } else {
@@ -121,11 +137,21 @@ PyObject* PyBobIpBase_sobel(PyObject*, PyObject* args, PyObject* kwargs) {
     dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
     dst_ = make_safe(dst);
   }
+  if (!magnitude != !orientation){
+    PyErr_Format(PyExc_ValueError, "'sobel' : 'magnitude' and 'orientation' must be given together.");
+    return 0;
+  }
+  if (magnitude && (magnitude->ndim != 2 || magnitude->type_num != NPY_FLOAT64 || orientation->ndim != 2 || orientation->type_num != NPY_FLOAT64)){
+    PyErr_Format(PyExc_TypeError, "'sobel' : 'magnitude' and 'orientation' must be 2D and of type float, but they are %dD and %dD and of type %s and %s.", (int)magnitude->ndim, (int)orientation->ndim, PyBlitzArray_TypenumAsString(magnitude->type_num), PyBlitzArray_TypenumAsString(orientation->type_num));
+    return 0;
+  }
 
   // perform Sobel filtering
-  bob::ip::base::sobel(*PyBlitzArrayCxx_AsBlitz<double,2>(src), *PyBlitzArrayCxx_AsBlitz<double,3>(dst), border);
-
-  return PyBlitzArray_AsNumpyArray(dst, 0);
+  switch (src->type_num){
+    case NPY_UINT8:  if (dst->type_num == NPY_INT32) return inner_sobel<uint8_t, int32_t>(src, dst, magnitude, orientation, border); else return inner_sobel<uint8_t, double>(src, dst, magnitude, orientation, border);
+    case NPY_UINT16: if (dst->type_num == NPY_INT32) return inner_sobel<uint16_t, int32_t>(src, dst, magnitude, orientation, border); else return inner_sobel<uint16_t, double>(src, dst, magnitude, orientation, border);
+    default:         return inner_sobel<double, double>(src, dst, magnitude, orientation, border);
+  }
 
   BOB_CATCH_FUNCTION("in sobel", 0)
 }
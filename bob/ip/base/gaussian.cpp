@@ -23,14 +23,18 @@ static auto Gaussian_doc = bob::extension::ClassDoc(
     "Constructs a new Gaussian filter",
     "The Gaussian kernel is generated in both directions independently, using the given standard deviation and the given radius, where the size of the kernels is actually ``2*radius+1``. "
     "When the radius is not given or negative, it will be automatically computed ad ``3*sigma``.\n\n"
-    ".. note::\n\n  Since the Gaussian smoothing is done by convolution, a larger radius will lead to longer execution time.",
+    "With the default ``algorithm='convolution'``, the Gaussian smoothing is done by convolution, so that a larger radius will lead to longer execution time. "
+    "With ``algorithm='recursive'``, a recursive approximation of the Gaussian by Deriche is used instead, whose execution time does not depend on the standard deviation, and which ignores the ``radius``. "
+    "The approximation requires standard deviations of at least 0.5 pixels, and its impulse response differs by less than 0.05% from the (not truncated) Gaussian. "
+    "With ``algorithm='automatic'``, the recursive approximation is used when both ``sigma`` are at least 3 pixels and the ``radius`` is at least ``3*sigma`` (as chosen by default), where it is faster than the convolution.",
     true
   )
-  .add_prototype("sigma, [radius], [border]","")
+  .add_prototype("sigma, [radius], [border], [algorithm]","")
   .add_prototype("gaussian", "")
   .add_parameter("sigma", "(double, double)", "The standard deviation of the Gaussian along the y- and x-axes in pixels")
   .add_parameter("radius", "(int, int)", "[default: (-1, -1) -> ``3*sigma`` ] The radius of the Gaussian in both directions -- the size of the kernel is ``2*radius+1``")
   .add_parameter("border", ":py:class:`bob.sp.BorderType`", "[default: ``bob.sp.BorderType.Mirror``] The extrapolation method used by the convolution at the border")
+  .add_parameter("algorithm", "str", "[default: ``'convolution'``] The algorithm used for smoothing, one of ``'convolution'``, ``'recursive'`` or ``'automatic'``")
   .add_parameter("gaussian", ":py:class:`bob.ip.base.Gaussian`", "The Gaussian object to use for copy-construction")
 );
 
@@ -57,15 +61,16 @@ static int PyBobIpBaseGaussian_init(PyBobIpBaseGaussianObject* self, PyObject* a
   blitz::TinyVector<double,2> sigma;
   blitz::TinyVector<int,2> radius (-1, -1);
   bob::sp::Extrapolation::BorderType border = bob::sp::Extrapolation::Mirror;
+  const char* algorithm = "convolution";
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(dd)|(ii)O&", kwlist1, &sigma[0], &sigma[1], &radius[0], &radius[1], &PyBobSpExtrapolationBorder_Converter, &border)){
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(dd)|(ii)O&s", kwlist1, &sigma[0], &sigma[1], &radius[0], &radius[1], &PyBobSpExtrapolationBorder_Converter, &border, &algorithm)){
     Gaussian_doc.print_usage();
     return -1;
   }
   // set the radius
   for (int i = 0; i < 2; ++i) if (radius[i] < 0) radius[i] = std::max(int(sigma[i] * 3 + 0.5), 1);
 
-  self->cxx.reset(new bob::ip::base::Gaussian(radius[0], radius[1], sigma[0], sigma[1], border));
+  self->cxx.reset(new bob::ip::base::Gaussian(radius[0], radius[1], sigma[0], sigma[1], border, gaussian_algorithm(algorithm)));
   return 0;
 
   BOB_CATCH_MEMBER("cannot create Gaussian", -1)
@@ -172,6 +177,28 @@ int PyBobIpBaseGaussian_setBorder(PyBobIpBaseGaussianObject* self, PyObject* val
   BOB_CATCH_MEMBER("border could not be set", -1)
 }
 
+static auto algorithm = bob::extension::VariableDoc(
+  "algorithm",
+  "str",
+  "The algorithm used for smoothing, one of ``'convolution'``, ``'recursive'`` or ``'automatic'``; with read and write access"
+);
+PyObject* PyBobIpBaseGaussian_getAlgorithm(PyBobIpBaseGaussianObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("s", gaussian_algorithm(self->cxx->getAlgorithm()));
+  BOB_CATCH_MEMBER("algorithm could not be read", 0)
+}
+int PyBobIpBaseGaussian_setAlgorithm(PyBobIpBaseGaussianObject* self, PyObject* value, void*){
+  BOB_TRY
+  const char* a;
+  if (!PyArg_Parse(value, "s", &a)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a str", Py_TYPE(self)->tp_name, algorithm.name());
+    return -1;
+  }
+  self->cxx->setAlgorithm(gaussian_algorithm(a));
+  return 0;
+  BOB_CATCH_MEMBER("algorithm could not be set", -1)
+}
+
 static auto kernelY = bob::extension::VariableDoc(
   "kernel_y",
   "array_like (1D, float)",
@@ -216,6 +243,13 @@ static PyGetSetDef PyBobIpBaseGaussian_getseters[] = {
       border.doc(),
       0
     },
+    {
+      algorithm.name(),
+      (getter)PyBobIpBaseGaussian_getAlgorithm,
+      (setter)PyBobIpBaseGaussian_setAlgorithm,
+      algorithm.doc(),
+      0
+    },
     {
       kernelY.name(),
       (getter)PyBobIpBaseGaussian_getKernelY,
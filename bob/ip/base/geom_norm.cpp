@@ -237,42 +237,65 @@ static auto process = bob::extension::FunctionDoc(
   "process",
   "This function geometrically normalizes an image or a position in the image",
   "The function rotates and scales the given image, or a position in image coordinates, such that the result is **visually** rotated and scaled with the :py:attr:`rotation_angle` and :py:attr:`scaling_factor`.\n\n"
+  "For 3D images, all color planes are processed in a single pass. "
+  "By default, the color planes are stored in the first dimension; with ``layout='interleaved'``, images of shape ``(height, width, planes)`` are accepted. "
+  "The ``layout`` can only be given as a keyword argument.\n\n"
   ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
   true
 )
-.add_prototype("input, output, center")
-.add_prototype("input, input_mask, output, output_mask, center")
+.add_prototype("input, output, center, [layout]")
+.add_prototype("input, input_mask, output, output_mask, center, [layout]")
 .add_prototype("position, center", "transformed")
 .add_parameter("input", "array_like (2D or 3D)", "The input image to which GeomNorm should be applied")
-.add_parameter("output", "array_like (2D or 3D, float)", "The output image, which must be of size :py:attr:`crop_size`")
+.add_parameter("output", "array_like (2D or 3D, uint8, float32 or float64)", "The output image, which must be of size :py:attr:`crop_size`; for ``numpy.uint8``, the interpolated values are rounded and saturated")
 .add_parameter("center", "(float, float)", "The transformation center in the given image; this will be placed to :py:attr:`crop_offset` in the output image")
 .add_parameter("input_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
 .add_parameter("output_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``output``")
 .add_parameter("position", "(float, float)", "A position in input image space that will be transformed to output image space (might be outside of the crop area)")
+.add_parameter("layout", "str", "[Default: ``'planar'``] The memory layout of 3D images, one of ``'planar'`` or ``'interleaved'``; ignored for 2D images")
 .add_return("transformed", "uint16", "The resulting GeomNorm code at the given position in the image")
 ;
 
-template <typename T>
-static PyObject* process_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset){
-  if (input_mask && output_mask){
-    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), offset);
+template <typename T, typename U>
+static PyObject* process_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset, bob::ip::base::ColorLayout layout){
+  if (input->ndim == 2){
+    if (input_mask && output_mask){
+      self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), offset);
+    } else {
+      self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<U,2>(output), offset);
+    }
   } else {
-    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<double,2>(output), offset);
+    if (input_mask && output_mask){
+      self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<bool,3>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,3>(output), *PyBlitzArrayCxx_AsBlitz<bool,3>(output_mask), offset, layout);
+    } else {
+      self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<U,3>(output), offset, layout);
+    }
   }
   Py_RETURN_NONE;
 }
 
+template <typename T>
+static PyObject* process_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset, bob::ip::base::ColorLayout layout){
+  switch (output->type_num){
+    case NPY_UINT8:   return process_inner<T,uint8_t>(self, input, input_mask, output, output_mask, offset, layout);
+    case NPY_FLOAT32: return process_inner<T,float>(self, input, input_mask, output, output_mask, offset, layout);
+    default:          return process_inner<T,double>(self, input, input_mask, output, output_mask, offset, layout);
+  }
+}
+
 static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
   char** kwlist1 = process.kwlist(0);
   char** kwlist2 = process.kwlist(1);
   char** kwlist3 = process.kwlist(2);
 
-  // get the number of command line arguments
+  // get the number of command line arguments, without the optional layout
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "layout")) --nargs;
 
   PyBlitzArrayObject* input = 0,* input_mask = 0,* output = 0,* output_mask = 0;
   blitz::TinyVector<double,2> center(0,0), position(0,0);
+  const char* layout = "planar";
 
   switch (nargs){
     case 2:{
@@ -287,7 +310,7 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
     }
     case 3:{
       // with input and output array
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&(dd)", kwlist1, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &center[0], &center[1])){
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&(dd)|s", kwlist1, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &center[0], &center[1], &layout)){
         process.print_usage();
         return 0;
       }
@@ -295,7 +318,7 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
     }
     case 5:{
       // with mask
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&(dd)", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask, &center[0], &center[1])){
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&(dd)|s", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask, &center[0], &center[1], &layout)){
         process.print_usage();
         return 0;
       }
@@ -311,6 +334,8 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
   auto input_ = make_safe(input), output_ = make_safe(output);
   auto input_mask_ = make_xsafe(input_mask), output_mask_ = make_xsafe(output_mask);
 
+  const bob::ip::base::ColorLayout color = color_layout(layout);
+
   // perform checks on input and output image
   if (input->ndim != 2 && input->ndim != 3){
     PyErr_Format(PyExc_TypeError, "`%s' only processes 2D or 3D arrays", Py_TYPE(self)->tp_name);
@@ -322,8 +347,8 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
     process.print_usage();
     return 0;
   }
-  if (output->type_num != NPY_FLOAT64){
-    PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type float", Py_TYPE(self)->tp_name);
+  if (output->type_num != NPY_UINT8 && output->type_num != NPY_FLOAT32 && output->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type uint8, float32 or float64", Py_TYPE(self)->tp_name);
     process.print_usage();
     return 0;
   }
@@ -343,9 +368,9 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
 
   // finally, process the data
   switch (input->type_num){
-    case NPY_UINT8:   return process_inner<uint8_t>(self, input, input_mask, output, output_mask, center);
-    case NPY_UINT16:  return process_inner<uint16_t>(self, input, input_mask, output, output_mask, center);
-    case NPY_FLOAT64: return process_inner<double>(self, input, input_mask, output, output_mask, center);
+    case NPY_UINT8:   return process_inner<uint8_t>(self, input, input_mask, output, output_mask, center, color);
+    case NPY_UINT16:  return process_inner<uint16_t>(self, input, input_mask, output, output_mask, center, color);
+    case NPY_FLOAT64: return process_inner<double>(self, input, input_mask, output, output_mask, center, color);
     default:
       PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
       process.print_usage();
@@ -10,10 +10,16 @@
 #ifndef BOB_IP_BASE_AFFINE_H
 #define BOB_IP_BASE_AFFINE_H
 
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <boost/format.hpp>
 #include <boost/shared_ptr.hpp>
 #include <bob.core/assert.h>
 #include <bob.core/check.h>
 #include <bob.core/logging.h>
+#include <bob.ip.base/Convolution.h>
 
 #include <boost/random.hpp>
 #include <bob.core/random.h>
@@ -21,14 +27,60 @@
 
 namespace bob { namespace ip { namespace base {
 
-  /** Implementation of the bi-linear interpolation of a source to a target image. */
+  /**
+   * @brief Helper function that computes the range [begin, end) of target pixels in one row,
+   * for which the source position origin + x * delta stays inside [lower, upper].
+   * A margin is kept at both ends so that the rounding errors of the incremental
+   * computation of the source positions never leave the range.
+   */
+  static inline void _restrict_interior(const double origin, const double delta, const double lower, const double upper, int& begin, int& end){
+    static const double margin = 1e-6;
+    const double lo = lower + margin, hi = upper - margin;
+    // degenerated transformations (e.g., scaling to a single pixel) are handled by the bound-checked code only
+    if (lo > hi || !std::isfinite(origin) || !std::isfinite(delta)){
+      end = begin;
+      return;
+    }
+    if (delta == 0.){
+      if (origin < lo || origin > hi) end = begin;
+      return;
+    }
+    double first = (lo - origin) / delta, last = (hi - origin) / delta;
+    if (delta < 0.) std::swap(first, last);
+    // restrict the range, guarding against integer overflow
+    if (first > begin) begin = first >= end ? end : static_cast<int>(std::ceil(first));
+    if (last < end - 1) end = last < begin ? begin : static_cast<int>(std::floor(last)) + 1;
+    if (end < begin) end = begin;
+  }
 
-  template <typename T, bool mask>
+  /**
+   * @brief Helper function to convert an interpolated value to the type of the target image.
+   * Floating point values are simply casted, while for integral types the value is rounded and saturated to the range of the type.
+   */
+  template <typename U>
+  static inline U _to_target(const double value){
+    if (!std::numeric_limits<U>::is_integer) return static_cast<U>(value);
+    if (!(value > std::numeric_limits<U>::min())) return std::numeric_limits<U>::min();
+    if (value >= std::numeric_limits<U>::max()) return std::numeric_limits<U>::max();
+    return static_cast<U>(std::floor(value + 0.5));
+  }
+
+  /**
+   * Implementation of the bi-linear interpolation of a source to a target image.
+   *
+   * Each row of the target image is split into the border segments, in which some of the four source pixels might lie outside the source image,
+   * and the interior segment, in which all four source pixels are known to be valid.
+   * Only the border segments use the bound checks, while the interior segment accesses the memory directly.
+   * As the source positions are accumulated identically in both segments, the result is identical to processing each pixel with bound checks.
+   *
+   * The interpolated values are converted to the type of the target image using _to_target.
+   */
+  template <typename T, bool mask, typename U>
   void transform(
       const blitz::Array<T,2>& source,
       const blitz::Array<bool,2>& source_mask,
       const blitz::TinyVector<double,2>& source_center,
-      blitz::Array<double,2>& target,
+      blitz::Array<U,2>& target,
       blitz::Array<bool,2>& target_mask,
       const blitz::TinyVector<double,2>& target_center,
       const blitz::TinyVector<double,2>& scaling_factor,
@@ -73,66 +125,110 @@ namespace bob { namespace ip { namespace base {
 
     int size_y = target.extent(0), size_x = target.extent(1);
 
+    // direct memory access for the interior part
+    U* dst_data = target.dataZero();
+    const long dst_stride_y = target.stride(0), dst_stride_x = target.stride(1);
+    const T* src_data = source.dataZero();
+    const long src_stride_y = source.stride(0), src_stride_x = source.stride(1);
+    const bool* src_mask_data = mask ? source_mask.dataZero() : 0;
+    const long mask_stride_y = mask ? source_mask.stride(0) : 0, mask_stride_x = mask ? source_mask.stride(1) : 0;
+
     // Ok, so let's do it.
     for (int y = 0; y < size_y; ++y){
       // set the source image point to first point in row
       double source_x = origin_x, source_y = origin_y;
+
+      // compute the interior part of the row, where all four pixels are inside the source image
+      int interior_begin = 0, interior_end = size_x;
+      _restrict_interior(origin_x, col_dx, 0., w, interior_begin, interior_end);
+      _restrict_interior(origin_y, col_dy, 0., h, interior_begin, interior_end);
+
+      U* dst_row = dst_data + y * dst_stride_y;
+
       // iterate over the row
       for (int x = 0; x < size_x; ++x){
 
-        // We are at the desired pixel in the new image. Interpolate the old image's pixels:
-        double& res = target(y,x) = 0.;
-
         // split each source x and y in integral and decimal digits
         ox = std::floor(source_x);
         oy = std::floor(source_y);
         mx = source_x - ox;
         my = source_y - oy;
 
-        // add the four values bi-linearly interpolated
-        if (mask){
-          bool& new_mask = target_mask(y,x) = true;
-          // upper left
-          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
-            res += (1.-mx) * (1.-my) * source(oy,ox);
-          } else if ((1.-mx) * (1.-my) > 0.){
-            new_mask = false;
+        if (x >= interior_begin && x < interior_end){
+          // interior: no bound checks required
+          const T* s = src_data + oy * src_stride_y + ox * src_stride_x;
+          double res = 0.;
+          if (mask){
+            const bool* m = src_mask_data + oy * mask_stride_y + ox * mask_stride_x;
+            bool new_mask = true;
+            if (m[0]) res += (1.-mx) * (1.-my) * s[0];
+            else if ((1.-mx) * (1.-my) > 0.) new_mask = false;
+            if (m[mask_stride_x]) res += mx * (1.-my) * s[src_stride_x];
+            else if (mx * (1.-my) > 0.) new_mask = false;
+            if (m[mask_stride_y]) res += (1.-mx) * my * s[src_stride_y];
+            else if ((1.-mx) * my > 0.) new_mask = false;
+            if (m[mask_stride_y + mask_stride_x]) res += mx * my * s[src_stride_y + src_stride_x];
+            else if (mx * my > 0.) new_mask = false;
+            target_mask(y,x) = new_mask;
+          } else {
+            res += (1.-mx) * (1.-my) * s[0];
+            res += mx * (1.-my) * s[src_stride_x];
+            res += (1.-mx) * my * s[src_stride_y];
+            res += mx * my * s[src_stride_y + src_stride_x];
           }
+          dst_row[x * dst_stride_x] = _to_target<U>(res);
 
-          // upper right
-          if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
-            res += mx * (1.-my) * source(oy,ox+1);
-          } else if (mx * (1.-my) > 0.){
-            new_mask = false;
-          }
-          // lower left
-          if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
-            res += (1.-mx) * my * source(oy+1,ox);
-          } else if ((1.-mx) * my > 0.){
-            new_mask = false;
-          }
-          // lower right
-          if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
-            res += mx * my * source(oy+1,ox+1);
-          } else if (mx * my > 0.){
-            new_mask = false;
-          }
         } else {
-          // upper left
-          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
-            res += (1.-mx) * (1.-my) * source(oy,ox);
-
-          // upper right
-          if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
-            res += mx * (1.-my) * source(oy,ox+1);
-
-          // lower left
-          if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
-            res += (1.-mx) * my * source(oy+1,ox);
+          // border: check each of the four pixels
+          // We are at the desired pixel in the new image. Interpolate the old image's pixels:
+          double res = 0.;
+
+          // add the four values bi-linearly interpolated
+          if (mask){
+            bool& new_mask = target_mask(y,x) = true;
+            // upper left
+            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
+              res += (1.-mx) * (1.-my) * source(oy,ox);
+            } else if ((1.-mx) * (1.-my) > 0.){
+              new_mask = false;
+            }
 
-          // lower right
-          if (ox >= -1 && oy >= -1 && ox < w && oy < h)
-            res += mx * my * source(oy+1,ox+1);
+            // upper right
+            if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
+              res += mx * (1.-my) * source(oy,ox+1);
+            } else if (mx * (1.-my) > 0.){
+              new_mask = false;
+            }
+            // lower left
+            if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
+              res += (1.-mx) * my * source(oy+1,ox);
+            } else if ((1.-mx) * my > 0.){
+              new_mask = false;
+            }
+            // lower right
+            if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
+              res += mx * my * source(oy+1,ox+1);
+            } else if (mx * my > 0.){
+              new_mask = false;
+            }
+          } else {
+            // upper left
+            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
+              res += (1.-mx) * (1.-my) * source(oy,ox);
+
+            // upper right
+            if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
+              res += mx * (1.-my) * source(oy,ox+1);
+
+            // lower left
+            if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
+              res += (1.-mx) * my * source(oy+1,ox);
+
+            // lower right
+            if (ox >= -1 && oy >= -1 && ox < w && oy < h)
+              res += mx * my * source(oy+1,ox+1);
+          }
+          target(y,x) = _to_target<U>(res);
         }
 
         // done with this pixel...
@@ -147,12 +243,163 @@ namespace bob { namespace ip { namespace base {
     // done!
   }
 
+  /** The memory layouts of color images */
+  typedef enum {
+    LAYOUT_PLANAR = 0,      //!< the color planes are stored in the first dimension, i.e., the image has shape (planes, height, width)
+    LAYOUT_INTERLEAVED = 1  //!< the color planes are stored in the last dimension, i.e., the image has shape (height, width, planes)
+  } ColorLayout;
+
+  /** helper function to get the index of the dimension that contains the color planes */
+  static inline int _plane_dim(const ColorLayout layout){
+    return layout == LAYOUT_PLANAR ? 0 : 2;
+  }
+
+  /** helper function to get the (height, width) of a color image in the given layout */
+  static inline blitz::TinyVector<int,2> _image_shape(const blitz::TinyVector<int,3>& shape, const ColorLayout layout){
+    return layout == LAYOUT_PLANAR ? blitz::TinyVector<int,2>(shape[1], shape[2]) : blitz::TinyVector<int,2>(shape[0], shape[1]);
+  }
+
+  /** helper function to get the 2D plane with the given index of a color image in the given layout */
+  template <typename T>
+  static inline blitz::Array<T,2> _image_plane(const blitz::Array<T,3>& image, const int plane, const ColorLayout layout){
+    if (layout == LAYOUT_PLANAR) return image(plane, blitz::Range::all(), blitz::Range::all());
+    return image(blitz::Range::all(), blitz::Range::all(), plane);
+  }
+
+  /**
+   * Implementation of the bi-linear interpolation of a color source to a color target image.
+   *
+   * The source positions, the bi-linear weights and the bound checks are computed only once per target pixel and applied to all color planes,
+   * which can either be stored in planar or in interleaved layout.
+   * The results are identical to transforming each color plane separately with the 2D version of this function.
+   * When masks are used, each color plane has its own mask.
+   */
+  template <typename T, bool mask, typename U>
+  void transform(
+      const blitz::Array<T,3>& source,
+      const blitz::Array<bool,3>& source_mask,
+      const blitz::TinyVector<double,2>& source_center,
+      blitz::Array<U,3>& target,
+      blitz::Array<bool,3>& target_mask,
+      const blitz::TinyVector<double,2>& target_center,
+      const blitz::TinyVector<double,2>& scaling_factor,
+      const double& rotation_angle,
+      const ColorLayout layout
+   ){
+    // the dimensions of planes, rows and columns
+    const int pd = _plane_dim(layout), yd = layout == LAYOUT_PLANAR ? 1 : 0, xd = yd + 1;
+    const int planes = source.extent(pd);
+    bob::core::array::assertSameDimensionLength(planes, target.extent(pd));
+    if (mask){
+      bob::core::array::assertSameShape(source, source_mask);
+      bob::core::array::assertSameShape(target, target_mask);
+    }
+
+    // the mapping from the target to the source image is computed exactly as in the 2D version
+    const double sin_angle = -sin(rotation_angle * M_PI / 180.),
+                 cos_angle = cos(rotation_angle * M_PI / 180.);
+
+    const double col_dy = -sin_angle / scaling_factor[0],
+                 col_dx = cos_angle / scaling_factor[1];
+    const double row_dy = cos_angle / scaling_factor[0],
+                 row_dx = sin_angle / scaling_factor[1];
+
+    double origin_y = source_center[0] - (target_center[0] * cos_angle - target_center[1] * sin_angle) / scaling_factor[0];
+    double origin_x = source_center[1] - (target_center[1] * cos_angle + target_center[0] * sin_angle) / scaling_factor[1];
+
+    const int h = source.extent(yd)-1;
+    const int w = source.extent(xd)-1;
+    const int size_y = target.extent(yd), size_x = target.extent(xd);
+
+    // direct memory access for all pixels
+    const T* src_data = source.dataZero();
+    const long src_stride_p = source.stride(pd), src_stride_y = source.stride(yd), src_stride_x = source.stride(xd);
+    U* dst_data = target.dataZero();
+    const long dst_stride_p = target.stride(pd), dst_stride_y = target.stride(yd), dst_stride_x = target.stride(xd);
+    const bool* src_mask_data = mask ? source_mask.dataZero() : 0;
+    const long mask_stride_p = mask ? source_mask.stride(pd) : 0, mask_stride_y = mask ? source_mask.stride(yd) : 0, mask_stride_x = mask ? source_mask.stride(xd) : 0;
+    bool* dst_mask_data = mask ? target_mask.dataZero() : 0;
+    const long dst_mask_stride_p = mask ? target_mask.stride(pd) : 0, dst_mask_stride_y = mask ? target_mask.stride(yd) : 0, dst_mask_stride_x = mask ? target_mask.stride(xd) : 0;
+
+    // the offsets of the four neighbors (upper left, upper right, lower left, lower right) relative to the upper left pixel
+    const long src_neighbors[] = {0, src_stride_x, src_stride_y, src_stride_y + src_stride_x};
+    const long mask_neighbors[] = {0, mask_stride_x, mask_stride_y, mask_stride_y + mask_stride_x};
+
+    for (int y = 0; y < size_y; ++y){
+      double source_x = origin_x, source_y = origin_y;
+
+      int interior_begin = 0, interior_end = size_x;
+      _restrict_interior(origin_x, col_dx, 0., w, interior_begin, interior_end);
+      _restrict_interior(origin_y, col_dy, 0., h, interior_begin, interior_end);
+
+      for (int x = 0; x < size_x; ++x){
+        const int ox = std::floor(source_x);
+        const int oy = std::floor(source_y);
+        const double mx = source_x - ox;
+        const double my = source_y - oy;
+
+        // compute weights and bound checks once for all planes
+        const double weight[] = {(1.-mx) * (1.-my), mx * (1.-my), (1.-mx) * my, mx * my};
+        const bool interior = x >= interior_begin && x < interior_end;
+        const bool inside[] = {
+          interior || (ox >= 0 && oy >= 0 && ox <= w && oy <= h),
+          interior || (ox >= -1 && oy >= 0 && ox < w && oy <= h),
+          interior || (ox >= 0 && oy >= -1 && ox <= w && oy < h),
+          interior || (ox >= -1 && oy >= -1 && ox < w && oy < h)
+        };
+        const long src_offset = oy * src_stride_y + ox * src_stride_x;
+        const long mask_offset = oy * mask_stride_y + ox * mask_stride_x;
+        const long dst_offset = y * dst_stride_y + x * dst_stride_x;
+        const long dst_mask_offset = y * dst_mask_stride_y + x * dst_mask_stride_x;
+
+        // apply them to all planes
+        for (int p = 0; p < planes; ++p){
+          const long s = src_offset + p * src_stride_p;
+          double res = 0.;
+          if (mask){
+            const long m = mask_offset + p * mask_stride_p;
+            bool new_mask = true;
+            for (int i = 0; i < 4; ++i){
+              if (inside[i] && src_mask_data[m + mask_neighbors[i]]){
+                res += weight[i] * src_data[s + src_neighbors[i]];
+              } else if (weight[i] > 0.){
+                new_mask = false;
+              }
+            }
+            dst_mask_data[dst_mask_offset + p * dst_mask_stride_p] = new_mask;
+          } else if (interior){
+            res += weight[0] * src_data[s];
+            res += weight[1] * src_data[s + src_neighbors[1]];
+            res += weight[2] * src_data[s + src_neighbors[2]];
+            res += weight[3] * src_data[s + src_neighbors[3]];
+          } else {
+            for (int i = 0; i < 4; ++i){
+              if (inside[i]) res += weight[i] * src_data[s + src_neighbors[i]];
+            }
+          }
+          dst_data[dst_offset + p * dst_stride_p] = _to_target<U>(res);
+        }
+
+        source_y += col_dy;
+        source_x += col_dx;
+      }
+      origin_y += row_dy;
+      origin_x += row_dx;
+    }
+  }
+
 
 /************************************************************************
 **************  Scaling functionality  **********************************
 ************************************************************************/
 
 
+  /** The algorithms that can be used to scale images */
+  typedef enum {
+    SCALE_BILINEAR = 0, //!< bi-linear interpolation
+    SCALE_AREA = 1      //!< averaging of integral blocks of pixels, followed by bi-linear interpolation of the remaining scale
+  } ScaleAlgorithm;
+
   /** helper function to compute the scale required by bob.ip.base.GeomNorm for the given image shapes */
   static inline blitz::TinyVector<double,2> _get_scale_factor(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape){
     double y_scale = (dst_shape[0]-1.) / (src_shape[0]-1.);
@@ -168,14 +415,89 @@ namespace bob { namespace ip { namespace base {
    * @param dst The output blitz array. The new array is resized according
    *   to the dimensions of this dst array.
    */
-  template <typename T>
-  void scale(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst){
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst){
     blitz::TinyVector<double,2> offset(0,0);
     blitz::Array<bool,2> src_mask, dst_mask;
     // .. apply scale with (0,0) as offset and 0 as rotation angle
     transform<T,false>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(src.shape(), dst.shape()), 0.);
   }
 
+  /**
+   * @brief Averages non-overlapping blocks of factor[0] x factor[1] pixels of a 2D blitz::array/image.
+   *   The dst image needs to have the shape src.shape() / factor (rounded down).
+   *   Rows and columns that do not fill a complete block are distributed evenly to both borders and ignored.
+   * @param src The input blitz array
+   * @param dst The output blitz array of reduced size
+   * @param factor The integral reduction factor in y and x direction
+   */
+  template <typename T>
+  void boxReduce(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const blitz::TinyVector<int,2>& factor){
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    if (factor[0] < 1 || factor[1] < 1) throw std::runtime_error((boost::format("the reduction factor (%d, %d) must be positive") % factor[0] % factor[1]).str());
+    bob::core::array::assertSameShape(dst, blitz::TinyVector<int,2>(src.extent(0) / factor[0], src.extent(1) / factor[1]));
+
+    const int offset_y = (src.extent(0) - dst.extent(0) * factor[0]) / 2,
+              offset_x = (src.extent(1) - dst.extent(1) * factor[1]) / 2;
+    const int width = dst.extent(1) * factor[1];
+    const int stride = src.stride(1);
+    const double norm = 1. / (factor[0] * factor[1]);
+
+    // sum up the rows of one block first, so that the source image is read only once and row by row
+    std::vector<double> row(width);
+    for (int y = 0; y < dst.extent(0); ++y){
+      std::fill(row.begin(), row.end(), 0.);
+      for (int dy = 0; dy < factor[0]; ++dy){
+        const T* s = &src(offset_y + y * factor[0] + dy, offset_x);
+        for (int x = 0; x < width; ++x, s += stride)
+          row[x] += *s;
+      }
+      const double* r = &row[0];
+      for (int x = 0; x < dst.extent(1); ++x){
+        double sum = 0.;
+        for (int dx = 0; dx < factor[1]; ++dx, ++r)
+          sum += *r;
+        dst(y,x) = sum * norm;
+      }
+    }
+  }
+
+  /** helper function to compute the largest integral reduction factor that keeps the reduced image at least as large as the target image */
+  static inline blitz::TinyVector<int,2> _get_reduction_factor(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape){
+    blitz::TinyVector<int,2> factor;
+    for (int d = 0; d < 2; ++d){
+      // keep at least two pixels, so that the bi-linear scale factor stays defined
+      factor[d] = std::max(dst_shape[d] > 1 ? src_shape[d] / dst_shape[d] : src_shape[d] / 2, 1);
+    }
+    return factor;
+  }
+
+  /**
+   * @brief Function which rescales a 2D blitz::array/image of a given type using the given algorithm.
+   *   For SCALE_AREA, the image is first reduced by the largest integral factor using boxReduce,
+   *   and the remaining scale (which is smaller than 2) is applied with bi-linear interpolation.
+   *   This avoids aliasing artifacts for large down-scaling factors, and reduces the number of pixels that need to be interpolated.
+   *   When no reduction is possible, i.e., for up-scaling or down-scaling by less than 2, both algorithms are identical.
+   * @param src The input blitz array
+   * @param dst The output blitz array. The new array is resized according
+   *   to the dimensions of this dst array.
+   * @param algorithm The algorithm to use for scaling
+   */
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const ScaleAlgorithm algorithm){
+    if (algorithm == SCALE_AREA){
+      const blitz::TinyVector<int,2> factor = _get_reduction_factor(src.shape(), dst.shape());
+      if (factor[0] > 1 || factor[1] > 1){
+        blitz::Array<double,2> reduced(src.extent(0) / factor[0], src.extent(1) / factor[1]);
+        boxReduce(src, reduced, factor);
+        scale(reduced, dst);
+        return;
+      }
+    }
+    scale(src, dst);
+  }
+
   /**
    * @brief Function which rescales a 2D blitz::array/image of a given type.
    *   The first dimension is the height (y-axis), whereas the second
@@ -186,8 +508,8 @@ namespace bob { namespace ip { namespace base {
    *   to the dimensions of this dst array.
    * @param dst_mask The output blitz boolean mask array
    */
-  template <typename T>
-  void scale(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask){
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask){
     blitz::TinyVector<double,2> offset(0,0);
     // .. apply scale with (0,0) as offset and 0 as rotation angle
     transform<T,true>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(src.shape(), dst.shape()), 0.);
@@ -195,40 +517,51 @@ namespace bob { namespace ip { namespace base {
 
   /**
    * @brief Function which rescales a 3D blitz::array/image of a given type.
-   *   The first dimension is the number of color plane, the second is the
+   *   For LAYOUT_PLANAR, the first dimension is the number of color plane, the second is the
    * height (y-axis), whereas the third one is the width (x-axis).
+   *   For LAYOUT_INTERLEAVED, the color planes are stored in the third dimension.
+   *   All color planes are processed in a single pass.
    * @param src The input blitz array
    * @param dst The output blitz array. The new array is resized according
    *   to the dimensions of this dst array.
+   * @param layout The memory layout of the color planes of src and dst
    */
-  template <typename T>
-  void scale(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst)
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const ColorLayout layout = LAYOUT_PLANAR)
   {
-    // Check number of planes
-    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
-    for (int p = 0; p < dst.extent(0); ++p){
-      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice =dst(p, blitz::Range::all(), blitz::Range::all());
-      // Process one plane
-      scale(src_slice, dst_slice);
-    }
+    blitz::TinyVector<double,2> offset(0,0);
+    blitz::Array<bool,3> src_mask, dst_mask;
+    transform<T,false>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(_image_shape(src.shape(), layout), _image_shape(dst.shape(), layout)), 0., layout);
   }
 
-  template <typename T>
-  void scale(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask)
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const ScaleAlgorithm algorithm, const ColorLayout layout = LAYOUT_PLANAR)
   {
-    // Check number of planes
-    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
-    bob::core::array::assertSameDimensionLength(src.extent(0), src_mask.extent(0));
-    bob::core::array::assertSameDimensionLength(src_mask.extent(0), dst_mask.extent(0));
-    for (int p = 0; p < dst.extent(0); ++p){
-      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      const blitz::Array<bool,2> src_mask_slice = src_mask(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<bool,2> dst_mask_slice = dst_mask(p, blitz::Range::all(), blitz::Range::all());
-      // Process one plane
-      scale(src_slice, src_mask_slice, dst_slice, dst_mask_slice);
+    if (algorithm == SCALE_AREA){
+      const blitz::TinyVector<int,2> factor = _get_reduction_factor(_image_shape(src.shape(), layout), _image_shape(dst.shape(), layout));
+      if (factor[0] > 1 || factor[1] > 1){
+        // reduce each plane separately, and scale all planes of the reduced image at once
+        const int yd = layout == LAYOUT_PLANAR ? 1 : 0, xd = yd + 1;
+        blitz::TinyVector<int,3> shape = src.shape();
+        shape[yd] /= factor[0];
+        shape[xd] /= factor[1];
+        blitz::Array<double,3> reduced(shape);
+        for (int p = 0; p < src.extent(_plane_dim(layout)); ++p){
+          blitz::Array<double,2> reduced_slice = _image_plane(reduced, p, layout);
+          boxReduce(_image_plane(src, p, layout), reduced_slice, factor);
+        }
+        scale(reduced, dst, layout);
+        return;
+      }
     }
+    scale(src, dst, layout);
+  }
+
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const ColorLayout layout = LAYOUT_PLANAR)
+  {
+    blitz::TinyVector<double,2> offset(0,0);
+    transform<T,true>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(_image_shape(src.shape(), layout), _image_shape(dst.shape(), layout)), 0., layout);
   }
 
   /**
@@ -247,6 +580,249 @@ namespace bob { namespace ip { namespace base {
   }
 
 
+/************************************************************************
+**************  Exact rotations and flipping  ***************************
+************************************************************************/
+
+  /**
+   * @brief The mapping of a target pixel (y, x) to the source pixel (y0 + y * yy + x * xy, x0 + y * yx + x * xx)
+   * of an exact rotation by a multiple of 90 degrees or of a flip.
+   */
+  struct _PixelMap {
+    int y0, yy, xy;
+    int x0, yx, xx;
+  };
+
+  /** helper function to get the pixel map of a counter-clockwise rotation of an image with the given shape by the given number of quarter turns */
+  static inline _PixelMap _quarter_turn_map(const blitz::TinyVector<int,2>& src_shape, const int quarter_turns){
+    const int h = src_shape[0] - 1, w = src_shape[1] - 1;
+    switch (quarter_turns){
+      case 1:  {_PixelMap m = {0, 0, 1, w, -1, 0}; return m;}
+      case 2:  {_PixelMap m = {h, -1, 0, w, 0, -1}; return m;}
+      case 3:  {_PixelMap m = {h, 0, -1, 0, 1, 0}; return m;}
+      default: {_PixelMap m = {0, 1, 0, 0, 0, 1}; return m;}
+    }
+  }
+
+  /** helper function to get the number of counter-clockwise quarter turns in [0, 3] of the given angle in degrees, or -1 if the angle is not an exact multiple of 90 degrees */
+  static inline int _quarter_turns(const double rotation_angle){
+    if (!std::isfinite(rotation_angle) || std::fmod(rotation_angle, 90.) != 0.) return -1;
+    return (static_cast<int>(std::fmod(rotation_angle / 90., 4.)) + 4) % 4;
+  }
+
+  /** helper function to get the shape of an image after rotating it by the given number of quarter turns */
+  static inline blitz::TinyVector<int,2> _quarter_turn_shape(const blitz::TinyVector<int,2>& shape, const int quarter_turns){
+    return quarter_turns % 2 ? blitz::TinyVector<int,2>(shape[1], shape[0]) : shape;
+  }
+
+  /** helper function to get the number of quarter turns, if rotating an image of src_shape to dst_shape with the given angle can be done without interpolation, or -1 otherwise */
+  static inline int _exact_quarter_turns(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape, const double rotation_angle){
+    const int quarter_turns = _quarter_turns(rotation_angle);
+    if (quarter_turns < 0) return -1;
+    const blitz::TinyVector<int,2> shape = _quarter_turn_shape(src_shape, quarter_turns);
+    return shape[0] == dst_shape[0] && shape[1] == dst_shape[1] ? quarter_turns : -1;
+  }
+
+  /** helper class to copy a pixel to the type of the target image; pixels of the same type are copied unchanged */
+  template <typename T, typename U>
+  struct _PixelCopy {
+    static U apply(const T value){ return _to_target<U>(value); }
+  };
+
+  template <typename T>
+  struct _PixelCopy<T,T> {
+    static T apply(const T value){ return value; }
+  };
+
+  /**
+   * Copies the source pixels as given by the pixel map to the target image.
+   *
+   * The target image is processed in square tiles.
+   * For rotations by 90 and 270 degrees, which read the source image column-wise, all cache lines of the source that are touched by a tile are reused before they are evicted.
+   */
+  template <typename T, typename U>
+  static inline void _copy_tiled(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const _PixelMap& m){
+    static const int tile = 32;
+    const std::ptrdiff_t s0 = src.stride(0), s1 = src.stride(1);
+    const std::ptrdiff_t src_dy = m.yy * s0 + m.yx * s1, src_dx = m.xy * s0 + m.xx * s1;
+    const std::ptrdiff_t dst_dy = dst.stride(0), dst_dx = dst.stride(1);
+    const T* src_origin = src.data() + m.y0 * s0 + m.x0 * s1;
+    U* dst_origin = dst.data();
+    const int height = dst.extent(0), width = dst.extent(1);
+    for (int ty = 0; ty < height; ty += tile){
+      const int ey = std::min(ty + tile, height);
+      for (int tx = 0; tx < width; tx += tile){
+        const int ex = std::min(tx + tile, width);
+        for (int y = ty; y < ey; ++y){
+          const T* s = src_origin + y * src_dy + tx * src_dx;
+          U* d = dst_origin + y * dst_dy + tx * dst_dx;
+          for (int x = tx; x < ex; ++x, s += src_dx, d += dst_dx){
+            *d = _PixelCopy<T,U>::apply(*s);
+          }
+        }
+      }
+    }
+  }
+
+  /** in-place processing is only possible for images of the same type */
+  template <typename T, typename U>
+  static inline bool _permute_in_place(const blitz::Array<T,2>&, blitz::Array<U,2>&, const _PixelMap&){
+    return false;
+  }
+
+  /**
+   * Permutes the pixels of the image in place, if src and dst are the same image.
+   * Each cycle of the permutation (which has at most four pixels) is processed once, starting at its pixel with the lowest index.
+   */
+  template <typename T>
+  static inline bool _permute_in_place(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst, const _PixelMap& m){
+    if (src.data() != dst.data() || src.stride(0) != dst.stride(0) || src.stride(1) != dst.stride(1) || src.extent(0) != dst.extent(0) || src.extent(1) != dst.extent(1)) return false;
+    T* data = dst.data();
+    const std::ptrdiff_t s0 = dst.stride(0), s1 = dst.stride(1);
+    const int width = dst.extent(1);
+    for (int y = 0; y < dst.extent(0); ++y){
+      for (int x = 0; x < width; ++x){
+        const int index = y * width + x;
+        // follow the cycle to check whether (y,x) is its first pixel
+        int cy = y, cx = x;
+        bool first = true;
+        while (true){
+          const int ny = m.y0 + cy * m.yy + cx * m.xy, nx = m.x0 + cy * m.yx + cx * m.xx;
+          const int next = ny * width + nx;
+          if (next == index) break;
+          if (next < index){
+            first = false;
+            break;
+          }
+          cy = ny; cx = nx;
+        }
+        if (!first) continue;
+        // shift the pixels along the cycle
+        const T value = data[y * s0 + x * s1];
+        cy = y; cx = x;
+        while (true){
+          const int ny = m.y0 + cy * m.yy + cx * m.xy, nx = m.x0 + cy * m.yx + cx * m.xx;
+          if (ny == y && nx == x){
+            data[cy * s0 + cx * s1] = value;
+            break;
+          }
+          data[cy * s0 + cx * s1] = data[ny * s0 + nx * s1];
+          cy = ny; cx = nx;
+        }
+      }
+    }
+    return true;
+  }
+
+  /** helper function that applies the given pixel map to the source image, handling source and target images that share memory */
+  template <typename T, typename U>
+  static inline void _permute(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const _PixelMap& m){
+    if (_permute_in_place(src, dst, m)) return;
+    if (_share_memory(src, dst)){
+      // the images overlap partially; work on a copy of the source image
+      blitz::Array<T,2> copy(src.shape());
+      copy = src;
+      _copy_tiled(copy, dst, m);
+    } else {
+      _copy_tiled(src, dst, m);
+    }
+  }
+
+  /**
+   * @brief Function which rotates a 2D blitz::array/image counter-clockwise by the given number of quarter turns, i.e., by a multiple of 90 degrees.
+   *   The pixels are copied without interpolation, in the same orientation as used by rotate().
+   *   The dst image must have the shape of the rotated image, i.e., width and height are exchanged for odd numbers of quarter turns.
+   *   If dst and src are the same image (which is only possible for square images or even numbers of quarter turns), the image is rotated in place.
+   * @param src The input blitz array
+   * @param dst The output blitz array; the pixel values are rounded and saturated if its type is integral and differs from the type of src
+   * @param quarter_turns The number of counter-clockwise quarter turns; might be negative
+   */
+  template <typename T, typename U>
+  void rotateQuarterTurns(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const int quarter_turns){
+    const int turns = (quarter_turns % 4 + 4) % 4;
+    bob::core::array::assertSameShape(dst, _quarter_turn_shape(src.shape(), turns));
+    _permute(src, dst, _quarter_turn_map(src.shape(), turns));
+  }
+
+  /**
+   * @brief Function which rotates a 3D blitz::array/image counter-clockwise by the given number of quarter turns.
+   *   For LAYOUT_PLANAR, the first dimension is the number of color plane, the second is the
+   * height (y-axis), whereas the third one is the width (x-axis).
+   *   For LAYOUT_INTERLEAVED, the color planes are stored in the third dimension.
+   * @param src The input blitz array
+   * @param dst The output blitz array
+   * @param quarter_turns The number of counter-clockwise quarter turns; might be negative
+   * @param layout The memory layout of the color planes of src and dst
+   */
+  template <typename T, typename U>
+  void rotateQuarterTurns(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const int quarter_turns, const ColorLayout layout = LAYOUT_PLANAR){
+    const int pd = _plane_dim(layout);
+    bob::core::array::assertSameDimensionLength(src.extent(pd), dst.extent(pd));
+    for (int p = 0; p < src.extent(pd); ++p){
+      blitz::Array<U,2> dst_plane = _image_plane(dst, p, layout);
+      rotateQuarterTurns(_image_plane(src, p, layout), dst_plane, quarter_turns);
+    }
+  }
+
+  /**
+   * @brief Function which flips a 2D blitz::array/image upside-down.
+   *   If dst and src are the same image, the image is flipped in place.
+   * @param src The input blitz array
+   * @param dst The output blitz array of the same shape
+   */
+  template <typename T>
+  void flip(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst){
+    bob::core::array::assertSameShape(src, dst);
+    const _PixelMap m = {src.extent(0) - 1, -1, 0, 0, 0, 1};
+    _permute(src, dst, m);
+  }
+
+  /**
+   * @brief Function which flips a 3D blitz::array/image upside-down.
+   *   The first dimension is the number of color plane, the second is the
+   * height (y-axis), whereas the third one is the width (x-axis).
+   * @param src The input blitz array
+   * @param dst The output blitz array of the same shape
+   */
+  template <typename T>
+  void flip(const blitz::Array<T,3>& src, blitz::Array<T,3>& dst){
+    bob::core::array::assertSameShape(src, dst);
+    for (int p = 0; p < src.extent(0); ++p){
+      blitz::Array<T,2> dst_plane = dst(p, blitz::Range::all(), blitz::Range::all());
+      flip(src(p, blitz::Range::all(), blitz::Range::all()), dst_plane);
+    }
+  }
+
+  /**
+   * @brief Function which flips a 2D blitz::array/image left-right.
+   *   If dst and src are the same image, the image is flipped in place.
+   * @param src The input blitz array
+   * @param dst The output blitz array of the same shape
+   */
+  template <typename T>
+  void flop(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst){
+    bob::core::array::assertSameShape(src, dst);
+    const _PixelMap m = {0, 1, 0, src.extent(1) - 1, 0, -1};
+    _permute(src, dst, m);
+  }
+
+  /**
+   * @brief Function which flips a 3D blitz::array/image left-right.
+   *   The first dimension is the number of color plane, the second is the
+   * height (y-axis), whereas the third one is the width (x-axis).
+   * @param src The input blitz array
+   * @param dst The output blitz array of the same shape
+   */
+  template <typename T>
+  void flop(const blitz::Array<T,3>& src, blitz::Array<T,3>& dst){
+    bob::core::array::assertSameShape(src, dst);
+    for (int p = 0; p < src.extent(0); ++p){
+      blitz::Array<T,2> dst_plane = dst(p, blitz::Range::all(), blitz::Range::all());
+      flop(src(p, blitz::Range::all(), blitz::Range::all()), dst_plane);
+    }
+  }
+
+
 /************************************************************************
 **************  Rotating functionality  *********************************
 ************************************************************************/
@@ -255,12 +831,19 @@ namespace bob { namespace ip { namespace base {
    * @brief Function which rotates a 2D blitz::array/image of a given type with the given angle in degrees.
    *   The first dimension is the height (y-axis), whereas the second
    *   one is the width (x-axis).
+   *   If the angle is a multiple of 90 degrees and dst has the shape of the rotated image, the pixels are copied using rotateQuarterTurns.
    * @param src The input blitz array
    * @param dst The output blitz array
    * @param rotation_angle The angle in degrees to rotate the image with
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const double rotation_angle){
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const double rotation_angle){
+    // rotations by multiples of 90 degrees are performed without interpolation
+    const int quarter_turns = _exact_quarter_turns(src.shape(), dst.shape(), rotation_angle);
+    if (quarter_turns >= 0){
+      rotateQuarterTurns(src, dst, quarter_turns);
+      return;
+    }
     // rotation offset is the center of the image
     blitz::TinyVector<double,2> src_offset((src.extent(0)-1.)/2.,(src.extent(1)-1.)/2.);
     blitz::TinyVector<double,2> dst_offset((dst.extent(0)-1.)/2.,(dst.extent(1)-1.)/2.);
@@ -279,8 +862,17 @@ namespace bob { namespace ip { namespace base {
    * @param dst_mask The output blitz boolean mask array
    * @param rotation_angle The angle in degrees to rotate the image with
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const double rotation_angle){
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const double rotation_angle){
+    // rotations by multiples of 90 degrees are performed without interpolation
+    const int quarter_turns = _exact_quarter_turns(src.shape(), dst.shape(), rotation_angle);
+    if (quarter_turns >= 0){
+      bob::core::array::assertSameShape(src, src_mask);
+      bob::core::array::assertSameShape(dst, dst_mask);
+      rotateQuarterTurns(src, dst, quarter_turns);
+      rotateQuarterTurns(src_mask, dst_mask, quarter_turns);
+      return;
+    }
     // rotation offset is the center of the image
     blitz::TinyVector<double,2> src_offset((src.extent(0)-1.)/2.,(src.extent(1)-1.)/2.);
     blitz::TinyVector<double,2> dst_offset((dst.extent(0)-1.)/2.,(dst.extent(1)-1.)/2.);
@@ -290,40 +882,45 @@ namespace bob { namespace ip { namespace base {
 
   /**
    * @brief Function which rotates a 3D blitz::array/image of a given type.
-   *   The first dimension is the number of color plane, the second is the
+   *   For LAYOUT_PLANAR, the first dimension is the number of color plane, the second is the
    * height (y-axis), whereas the third one is the width (x-axis).
+   *   For LAYOUT_INTERLEAVED, the color planes are stored in the third dimension.
+   *   All color planes are processed in a single pass.
    * @param src The input blitz array
    * @param dst The output blitz array
    * @param rotation_angle The angle in degrees to rotate the image with
+   * @param layout The memory layout of the color planes of src and dst
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const double rotation_angle)
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const double rotation_angle, const ColorLayout layout = LAYOUT_PLANAR)
   {
-    // Check number of planes
-    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
-    for (int p = 0; p < dst.extent(0); ++p){
-      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
-      // Process one plane
-      rotate(src_slice, dst_slice, rotation_angle);
+    const blitz::TinyVector<int,2> src_shape = _image_shape(src.shape(), layout), dst_shape = _image_shape(dst.shape(), layout);
+    const int quarter_turns = _exact_quarter_turns(src_shape, dst_shape, rotation_angle);
+    if (quarter_turns >= 0){
+      rotateQuarterTurns(src, dst, quarter_turns, layout);
+      return;
     }
+    blitz::TinyVector<double,2> src_offset((src_shape[0]-1.)/2.,(src_shape[1]-1.)/2.);
+    blitz::TinyVector<double,2> dst_offset((dst_shape[0]-1.)/2.,(dst_shape[1]-1.)/2.);
+    blitz::Array<bool,3> src_mask, dst_mask;
+    transform<T,false>(src, src_mask, src_offset, dst, dst_mask, dst_offset, blitz::TinyVector<double,2>(1., 1.), rotation_angle, layout);
   }
 
-  template <typename T>
-  void rotate(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const double rotation_angle)
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const double rotation_angle, const ColorLayout layout = LAYOUT_PLANAR)
   {
-    // Check number of planes
-    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
-    bob::core::array::assertSameDimensionLength(src.extent(0), src_mask.extent(0));
-    bob::core::array::assertSameDimensionLength(src_mask.extent(0), dst_mask.extent(0));
-    for (int p = 0; p < dst.extent(0); ++p){
-      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      const blitz::Array<bool,2> src_mask_slice = src_mask(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<bool,2> dst_mask_slice = dst_mask(p, blitz::Range::all(), blitz::Range::all());
-      // Process one plane
-      rotate(src_slice, src_mask_slice, dst_slice, dst_mask_slice, rotation_angle);
+    const blitz::TinyVector<int,2> src_shape = _image_shape(src.shape(), layout), dst_shape = _image_shape(dst.shape(), layout);
+    const int quarter_turns = _exact_quarter_turns(src_shape, dst_shape, rotation_angle);
+    if (quarter_turns >= 0){
+      bob::core::array::assertSameShape(src, src_mask);
+      bob::core::array::assertSameShape(dst, dst_mask);
+      rotateQuarterTurns(src, dst, quarter_turns, layout);
+      rotateQuarterTurns(src_mask, dst_mask, quarter_turns, layout);
+      return;
     }
+    blitz::TinyVector<double,2> src_offset((src_shape[0]-1.)/2.,(src_shape[1]-1.)/2.);
+    blitz::TinyVector<double,2> dst_offset((dst_shape[0]-1.)/2.,(dst_shape[1]-1.)/2.);
+    transform<T,true>(src, src_mask, src_offset, dst, dst_mask, dst_offset, blitz::TinyVector<double,2>(1., 1.), rotation_angle, layout);
   }
 
   /**
@@ -354,8 +951,10 @@ namespace bob { namespace ip { namespace base {
   /**
     * @brief Function which extracts a rectangle of maximal area from a
     *   2D mask of booleans (i.e. a 2D blitz array).
-    * @warning The function assumes that the true values on the mask form
-    *   a convex area.
+    *   The rectangle is found in O(height * width) by computing the largest rectangle
+    *   in the histogram of consecutive true values of each row.
+    *   When several rectangles have the maximal area, the one with the smallest
+    *   top, then smallest left coordinate, and then smallest height is returned.
     * @param mask The 2D input blitz array mask.
     * @result A blitz::TinyVector which contains in the following order:
     *   0/ The y-coordinate of the top left corner
@@ -365,6 +964,16 @@ namespace bob { namespace ip { namespace base {
     */
   const blitz::TinyVector<int,4> maxRectInMask(const blitz::Array<bool,2>& mask);
 
+  /**
+    * @brief Function which extracts a rectangle of maximal area from a
+    *   bit-packed 2D mask, where each byte contains eight consecutive pixels of a row,
+    *   the first one stored in the most significant bit (as produced by numpy.packbits).
+    * @param packed_mask The bit-packed mask with (width + 7) / 8 bytes per row.
+    * @param width The number of columns of the mask.
+    * @result The rectangle as for the boolean mask
+    */
+  const blitz::TinyVector<int,4> maxRectInMask(const blitz::Array<uint8_t,2>& packed_mask, const int width);
+
 
   /**
     * @brief Function which extracts an image with a nearest neighbour
@@ -378,7 +987,7 @@ namespace bob { namespace ip { namespace base {
     * @param src_mask The 2D input blitz array mask.
     * @param img The 2D input/output blitz array/image.
     * @warning The function assumes that the true values on the mask form
-    *   a convex area.
+    *   a convex area; for arbitrary masks, use extrapolateMaskNearest.
     * @warning img is used as both an input and output, in order to provide
     *   high performance. A copy might be done by the user before calling
     *   the function if required.
@@ -448,7 +1057,7 @@ namespace bob { namespace ip { namespace base {
     * @param random_factor The standard deviation of a normal distribution to multiply pixel values with
     * @param neighbors The (maximum) number of additional neighboring border values to choose from
     * @warning The function assumes that the true values on the mask form
-    *   a convex area.
+    *   a convex area; for arbitrary masks, use extrapolateMaskNearestRandom.
     * @warning img is used as both an input and output, in order to provide
     *   high performance. A copy might be done by the user before calling
     *   the function if required.
@@ -572,6 +1181,88 @@ namespace bob { namespace ip { namespace base {
   }
 
 
+  /**
+    * @brief Function which computes, for each pixel, the position of the nearest pixel (in Euclidean distance) for which the mask is true.
+    *   The exact Euclidean distance transform of Felzenszwalb and Huttenlocher is used,
+    *   which propagates the positions in two separable passes in O(height * width) for arbitrary masks.
+    *   For valid pixels, the pixel itself is returned.
+    * @param mask The 2D input blitz array mask, which needs to contain at least one true value.
+    * @param nearest_y The y-coordinate of the nearest valid pixel, must have the same shape as mask.
+    * @param nearest_x The x-coordinate of the nearest valid pixel, must have the same shape as mask.
+    */
+  void nearestValidPixel(const blitz::Array<bool,2>& mask, blitz::Array<int,2>& nearest_y, blitz::Array<int,2>& nearest_x);
+
+  /**
+    * @brief Function which fills the pixels of an image, for which the mask is false, with the value of the nearest valid pixel.
+    *   In opposition to extrapolateMask, the mask does not need to be convex.
+    * @param mask The 2D input blitz array mask.
+    * @param img The 2D input/output blitz array/image.
+    */
+  template <typename T>
+  void extrapolateMaskNearest(const blitz::Array<bool,2>& mask, blitz::Array<T,2>& img){
+    // Check input and output size
+    bob::core::array::assertSameShape(mask, img);
+
+    blitz::Array<int,2> nearest_y(mask.shape()), nearest_x(mask.shape());
+    nearestValidPixel(mask, nearest_y, nearest_x);
+
+    for (int y = 0; y < mask.extent(0); ++y)
+      for (int x = 0; x < mask.extent(1); ++x)
+        if (!mask(y,x))
+          img(y,x) = img(nearest_y(y,x), nearest_x(y,x));
+  }
+
+  /**
+    * @brief Function which fills the pixels of an image, for which the mask is false, with the values of the nearest valid pixels
+    *   by adding some random noise; the noise model is the one of extrapolateMaskRandom.
+    *   For each invalid pixel, one of the valid pixels up to neighbors positions next to the nearest valid pixel
+    *   (along the border, i.e., perpendicular to the direction towards the nearest valid pixel) is randomly chosen,
+    *   and its value is multiplied with a normal distributed random value with mean 1 and standard deviation random_factor.
+    *   In opposition to extrapolateMaskRandom, the mask does not need to be convex, and only values of the originally valid pixels are used.
+    * @param mask The 2D input blitz array mask.
+    * @param img The 2D input/output blitz array/image.
+    * @param rng The random number generator to consider
+    * @param random_factor The standard deviation of a normal distribution to multiply pixel values with
+    * @param neighbors The (maximum) number of additional neighboring border values to choose from
+    */
+  template <typename T>
+  void extrapolateMaskNearestRandom(const blitz::Array<bool,2>& mask, blitz::Array<T,2>& img, boost::mt19937& rng, double random_factor = 0.01, int neighbors = 5){
+    // Check input and output size
+    bob::core::array::assertSameShape(mask, img);
+
+    blitz::Array<int,2> nearest_y(mask.shape()), nearest_x(mask.shape());
+    nearestValidPixel(mask, nearest_y, nearest_x);
+
+    // only valid pixels are used as candidates, so the filled values do not propagate
+    const int height = mask.extent(0), width = mask.extent(1);
+    std::vector<int> candidates;
+    candidates.reserve(2*std::max(neighbors,0)+1);
+    for (int y = 0; y < height; ++y)
+      for (int x = 0; x < width; ++x){
+        if (mask(y,x)) continue;
+        const int valid_y = nearest_y(y,x), valid_x = nearest_x(y,x);
+        T value = img(valid_y, valid_x);
+        if (neighbors >= 1){
+          // go along the border, i.e., perpendicular to the main direction towards the nearest valid pixel
+          const bool vertical_border = std::abs(valid_y - y) < std::abs(valid_x - x);
+          const int dir_y = vertical_border ? 1 : 0, dir_x = vertical_border ? 0 : 1;
+          candidates.clear();
+          for (int c = -neighbors; c <= neighbors; ++c){
+            const int pos_y = valid_y + c * dir_y, pos_x = valid_x + c * dir_x;
+            if (pos_y >= 0 && pos_y < height && pos_x >= 0 && pos_x < width && mask(pos_y, pos_x))
+              candidates.push_back(pos_y * width + pos_x);
+          }
+          // the nearest valid pixel itself is always a candidate
+          const int chosen = candidates[boost::uniform_int<int>(0, candidates.size()-1)(rng)];
+          value = img(chosen / width, chosen % width);
+        }
+        if (random_factor){
+          value = static_cast<T>(bob::core::random::normal_distribution<double>(1., random_factor)(rng) * value);
+        }
+        img(y,x) = value;
+      }
+  }
+
 } } } // namespaces
 
 #endif // BOB_IP_BASE_AFFINE_H
@@ -238,6 +238,42 @@ namespace bob { namespace ip { namespace base {
     return blocks;
   }
 
+  /**
+    * @brief Function which returns a view of all blocks of a 2D
+    *   blitz::array/image of a given type, without copying any data.
+    *   The view is a 4D blitz array of shape
+    *   (N_blocks_y,N_blocks_x,block_h,block_w), whose strides are chosen
+    *   such that overlapping blocks share the same pixels of the input.
+    * @warning The returned view refers to the data of the input 2D blitz
+    *   array, but does not keep it alive; the input array must not be
+    *   destroyed or resized while the view is in use. Since the blocks
+    *   overlap, writing into the view modifies several blocks at once.
+    * @param src The input blitz array
+    * @param block_h The desired height of the blocks.
+    * @param block_w The desired width of the blocks.
+    * @param overlap_h The overlap between each block along the y axis.
+    * @param overlap_w The overlap between each block along the x axis.
+    */
+  template<typename T>
+  blitz::Array<T,4> blockView(
+    const blitz::Array<T,2>& src,
+    const size_t block_h, const size_t block_w,
+    const size_t overlap_h, const size_t overlap_w
+  ){
+    // Check input
+    _blockCheckInput(src.extent(0), src.extent(1), block_h, block_w, overlap_h, overlap_w);
+    const blitz::TinyVector<int,4> shape = getBlock4DOutputShape(src.extent(0), src.extent(1), block_h, block_w, overlap_h, overlap_w);
+
+    // the next block starts (block - overlap) pixels further in each direction
+    const blitz::TinyVector<blitz::diffType,4> stride(
+      src.stride(0) * static_cast<blitz::diffType>(block_h - overlap_h),
+      src.stride(1) * static_cast<blitz::diffType>(block_w - overlap_w),
+      src.stride(0),
+      src.stride(1)
+    );
+    return blitz::Array<T,4>(const_cast<T*>(&src(src.lbound(0), src.lbound(1))), shape, stride, blitz::neverDeleteData);
+  }
+
 } } } // namespaces
 
 #endif /* BOB_IP_BASE_BLOCK_H */
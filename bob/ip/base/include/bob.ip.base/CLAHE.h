@@ -0,0 +1,184 @@
+/**
+ * @date Sat Oct 17 20:14:37 CEST 2026
+ *
+ * This file defines a class to perform contrast limited adaptive histogram equalization (CLAHE)
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_CLAHE_H
+#define BOB_IP_BASE_CLAHE_H
+
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <bob.core/assert.h>
+
+#include <bob.ip.base/Histogram.h>
+#include <bob.ip.base/Parallel.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class performs a contrast limited adaptive histogram equalization (CLAHE) of uint8 and uint16 images.
+   *
+   * The image is split into a regular grid of tiles.
+   * For each tile, the histogram is clipped at the given limit, the clipped counts are spread uniformly over all bins,
+   * and the cumulative distribution of the clipped histogram is used as the lookup table of this tile.
+   * Each pixel is mapped by bilinearly blending the lookup tables of the four tiles whose centers surround it.
+   *
+   * The lookup tables and the interpolation weights are kept in a workspace, which is re-used for all images of the same size.
+   * The tiles and the image rows are processed in parallel.
+   */
+  class CLAHE
+  {
+    public:
+
+      /**
+       * @brief Creates an object to perform CLAHE
+       * @param tiles The number of tiles in vertical and horizontal direction
+       * @param clip_limit The maximum count of each histogram bin, relative to the average count of a bin in a tile;
+       *   if not positive, the histograms are not clipped, i.e., a plain adaptive histogram equalization is performed
+       */
+      CLAHE(
+        const blitz::TinyVector<int,2>& tiles = blitz::TinyVector<int,2>(8,8),
+        const double clip_limit = 2.
+      );
+
+      /**
+       * @brief Copy constructor
+       */
+      CLAHE(const CLAHE& other);
+
+      /**
+        * @brief Destructor
+        */
+      virtual ~CLAHE() { }
+
+      /**
+       * @brief Assignment operator
+       */
+      CLAHE& operator=(const CLAHE& other);
+
+      /**
+       * @brief Equal to
+       */
+      bool operator==(const CLAHE& b) const;
+      /**
+       * @brief Not equal to
+       */
+      bool operator!=(const CLAHE& b) const;
+
+      /**
+       * @brief Getters
+       */
+      const blitz::TinyVector<int,2>& getTiles() const { return m_tiles; }
+      double getClipLimit() const { return m_clip_limit; }
+
+      /**
+       * @brief Setters
+       */
+      void setTiles(const blitz::TinyVector<int,2>& tiles);
+      void setClipLimit(const double clip_limit) { m_clip_limit = clip_limit; }
+
+      /**
+        * @brief Processes a 2D blitz Array/Image of type uint8 or uint16
+        * @param src The input image
+        * @param dst The output image of the same shape and type
+        * @param threads The number of threads to use; see getNumberOfThreads
+        */
+      template <typename T> void process(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst, const int threads = 0)
+      {
+        // Check input and output arrays
+        bob::core::array::assertZeroBase(src);
+        bob::core::array::assertZeroBase(dst);
+        bob::core::array::assertSameShape(src, dst);
+        const int bins = _lookup_table_size<T>::value;
+        if (!bins)
+          throw std::runtime_error((boost::format("CLAHE: data type `%s' is not supported; only uint8 and uint16 images can be processed") % bob::io::base::array::stringize<T>()).str());
+
+        // compute the tile grid and the interpolation weights, if the image size has changed
+        prepare(src.extent(0), src.extent(1), bins);
+
+        // the row pointers are collected before the threads are started
+        std::vector<const T*> src_rows(src.extent(0));
+        std::vector<T*> dst_rows(dst.extent(0));
+        for (int y = 0; y < src.extent(0); ++y){
+          src_rows[y] = &src(y,0);
+          dst_rows[y] = &dst(y,0);
+        }
+
+        // small images are processed in the current thread
+        const int t = src.numElements() < (1u<<16) ? 1 : threads;
+        parallelFor(m_tiles[0] * m_tiles[1], t, boost::bind(&CLAHE::computeTables<T>, this, boost::cref(src_rows), src.stride(1), _1, _2));
+        parallelFor(src.extent(0), t, boost::bind(&CLAHE::remap<T>, this, boost::cref(src_rows), src.stride(1), boost::cref(dst_rows), dst.stride(1), _1, _2));
+      }
+
+    private:
+
+      /**
+       * @brief Computes the tile boundaries, the lookup table workspace and the interpolation weights for the given image size
+       */
+      void prepare(const int height, const int width, const int bins);
+
+      /**
+       * @brief Clips the given histogram of a tile with the given number of pixels, and computes the lookup table of the tile
+       */
+      void computeTable(uint64_t* histogram, const uint64_t pixels, float* table) const;
+
+      /**
+       * @brief Computes the lookup tables of the tiles [begin, end)
+       */
+      template <typename T>
+      void computeTables(const std::vector<const T*>& src_rows, const std::ptrdiff_t stride, const int begin, const int end)
+      {
+        std::vector<uint64_t> histogram(m_bins);
+        for (int tile = begin; tile < end; ++tile){
+          const int ty = tile / m_tiles[1], tx = tile % m_tiles[1];
+          const int y0 = m_tile_y[ty], y1 = m_tile_y[ty+1], x0 = m_tile_x[tx], x1 = m_tile_x[tx+1];
+          std::vector<const T*> rows(y1 - y0);
+          for (int y = y0; y < y1; ++y) rows[y - y0] = src_rows[y] + x0 * stride;
+          std::fill(histogram.begin(), histogram.end(), 0);
+          _histogramRows(rows, x1 - x0, stride, _DirectBins<T>(m_bins), &histogram[0], 0, y1 - y0);
+          computeTable(&histogram[0], static_cast<uint64_t>(y1 - y0) * (x1 - x0), &m_tables[static_cast<size_t>(tile) * m_bins]);
+        }
+      }
+
+      /**
+       * @brief Maps the rows [begin, end) by blending the lookup tables of the four surrounding tiles
+       */
+      template <typename T>
+      void remap(const std::vector<const T*>& src_rows, const std::ptrdiff_t src_stride, const std::vector<T*>& dst_rows, const std::ptrdiff_t dst_stride, const int begin, const int end) const
+      {
+        const int width = m_tile_x.back();
+        const size_t row_size = static_cast<size_t>(m_tiles[1]) * m_bins;
+        for (int y = begin; y < end; ++y){
+          const T* s = src_rows[y];
+          T* d = dst_rows[y];
+          const float* top = &m_tables[m_y0[y] * row_size];
+          const float* bottom = &m_tables[m_y1[y] * row_size];
+          const float wy = m_wy[y];
+          for (int x = 0; x < width; ++x){
+            const int v = s[x * src_stride], a = m_x0[x] + v, b = m_x1[x] + v;
+            const float t = top[a] + m_wx[x] * (top[b] - top[a]);
+            const float u = bottom[a] + m_wx[x] * (bottom[b] - bottom[a]);
+            d[x * dst_stride] = static_cast<T>(t + wy * (u - t) + 0.5f);
+          }
+        }
+      }
+
+      // parameters
+      blitz::TinyVector<int,2> m_tiles;
+      double m_clip_limit;
+
+      // workspace
+      int m_bins;
+      std::vector<int> m_tile_y, m_tile_x;
+      std::vector<float> m_tables;
+      std::vector<int> m_y0, m_y1, m_x0, m_x1;
+      std::vector<float> m_wy, m_wx;
+  };
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_CLAHE_H
@@ -0,0 +1,352 @@
+/**
+ * @date Sat Oct 17 16:05:21 CEST 2026
+ *
+ * This file defines a separable convolution and a recursive Gaussian filter that handle the image borders by remapping the pixel indices
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_CONVOLUTION_H
+#define BOB_IP_BASE_CONVOLUTION_H
+
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <bob.core/assert.h>
+#include <bob.sp/extrapolate.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief Maps the given index, which might lie outside of [0, size), to the index of the pixel that bob::sp::extrapolate* would copy to this position.
+   * For bob::sp::Extrapolation::Zero, -1 is returned for indices outside the image.
+   * All other border types that are not NearestNeighbour or Circular are handled as Mirror.
+   */
+  static inline int _border_index(int index, const int size, const bob::sp::Extrapolation::BorderType border_type){
+    if (index >= 0 && index < size) return index;
+    switch (border_type){
+      case bob::sp::Extrapolation::Zero:
+        return -1;
+      case bob::sp::Extrapolation::NearestNeighbour:
+        return index < 0 ? 0 : size - 1;
+      case bob::sp::Extrapolation::Circular:
+        index %= size;
+        return index < 0 ? index + size : index;
+      default:{
+        // mirroring repeats the edge pixels, i.e., it has a period of twice the size
+        const int period = 2 * size;
+        index %= period;
+        if (index < 0) index += period;
+        return index < size ? index : period - 1 - index;
+      }
+    }
+  }
+
+  /**
+   * @brief Extrapolates the src image by radius_y rows and radius_x columns on each side and writes the result into the (contiguous) dst image,
+   * which is resized accordingly; the values are cast to double on the fly.
+   */
+  template <typename T>
+  void _extrapolate(const blitz::Array<T,2>& src, const int radius_y, const int radius_x, const bob::sp::Extrapolation::BorderType border_type, blitz::Array<double,2>& dst){
+    const int height = src.extent(0), width = src.extent(1);
+    dst.resize(height + 2*radius_y, width + 2*radius_x);
+    std::vector<int> columns(width + 2*radius_x);
+    for (int x = 0; x < (int)columns.size(); ++x)
+      columns[x] = _border_index(x - radius_x, width, border_type);
+    for (int y = 0; y < dst.extent(0); ++y){
+      double* out = &dst(y,0);
+      const int sy = _border_index(y - radius_y, height, border_type);
+      for (int x = 0; x < (int)columns.size(); ++x)
+        out[x] = sy < 0 || columns[x] < 0 ? 0. : static_cast<double>(src(sy, columns[x]));
+    }
+  }
+
+  /** helper function to get the range of memory [begin, end) that is covered by the given array */
+  template <typename T>
+  static inline std::pair<const char*, const char*> _memory_range(const blitz::Array<T,2>& array){
+    const T* first = array.data(),* last = array.data();
+    for (int d = 0; d < 2; ++d){
+      const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(array.extent(d) - 1) * array.stride(d);
+      if (offset < 0) first += offset; else last += offset;
+    }
+    return std::make_pair(reinterpret_cast<const char*>(first), reinterpret_cast<const char*>(last + 1));
+  }
+
+  /** helper function to check whether the memory of the two given arrays overlaps */
+  template <typename T, typename U>
+  static inline bool _share_memory(const blitz::Array<T,2>& a, const blitz::Array<U,2>& b){
+    const std::pair<const char*, const char*> range_a = _memory_range(a), range_b = _memory_range(b);
+    return range_a.first < range_b.second && range_b.first < range_a.second;
+  }
+
+  /**
+   * @brief Convolves the rows start, ..., start + rows - 1 of the src image vertically with the given kernel and writes them into the buffer,
+   * starting at the given offset in each row of the buffer.
+   * The borders are handled by remapping the indices of the source rows, which is only required for the first and last radius rows of the image.
+   */
+  template <typename T>
+  void _convolve_rows(const blitz::Array<T,2>& src, const blitz::Array<double,1>& kernel, const bob::sp::Extrapolation::BorderType border_type, const int start, const int rows, blitz::Array<double,2>& buffer, const int offset){
+    const int height = src.extent(0), width = src.extent(1);
+    const int size = kernel.extent(0), radius = size / 2;
+    const std::ptrdiff_t src_stride = src.stride(0), src_dx = src.stride(1);
+    for (int r = 0; r < rows; ++r){
+      double* row = &buffer(r, offset);
+      std::fill(row, row + width, 0.);
+      for (int k = 0; k < size; ++k){
+        // the kernel is mirrored in a convolution
+        const int y = _border_index(start + r + radius - k, height, border_type);
+        if (y < 0) continue;
+        const double weight = kernel(k);
+        const T* in = src.data() + y * src_stride;
+        if (src_dx == 1){
+          for (int x = 0; x < width; ++x) row[x] += weight * in[x];
+        } else {
+          for (int x = 0; x < width; ++x) row[x] += weight * in[x * src_dx];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Convolves the given src image with the separable kernel given by kernel_y and kernel_x, and writes the result into dst.
+   *
+   * The image is processed in strips of rows, which are first convolved vertically into the buffer and afterwards convolved horizontally into dst.
+   * The height of the strips is chosen such that the buffer fits into the cache, so that no intermediate image of the full size is required.
+   * The pixels outside of the image are obtained by remapping the pixel indices according to the border_type,
+   * which gives the same result as extrapolating the image with the according bob::sp::extrapolate* function before applying a valid convolution.
+   * Both kernels must have an odd number of elements, and the size of dst must be identical to the size of src.
+   *
+   * @param src The image to convolve, which is read in its own data type
+   * @param kernel_y The kernel to convolve the columns of the image with
+   * @param kernel_x The kernel to convolve the rows of the image with
+   * @param dst The convolved image
+   * @param border_type The way the pixels outside of the image are handled
+   * @param buffer A buffer that is resized as required, which can be re-used between several calls
+   */
+  template <typename T>
+  void convolveSeparable(const blitz::Array<T,2>& src, const blitz::Array<double,1>& kernel_y, const blitz::Array<double,1>& kernel_x, blitz::Array<double,2>& dst, const bob::sp::Extrapolation::BorderType border_type, blitz::Array<double,2>& buffer){
+    bob::core::array::assertSameShape(src, dst);
+    if (kernel_y.extent(0) % 2 == 0 || kernel_x.extent(0) % 2 == 0)
+      throw std::runtime_error((boost::format("convolveSeparable: the kernel sizes (%d, %d) must be odd") % kernel_y.extent(0) % kernel_x.extent(0)).str());
+    const int height = src.extent(0), width = src.extent(1);
+    if (!height || !width) return;
+
+    // dst is written before all rows of src are read, so src must be copied when both share memory
+    if (_share_memory(src, dst)){
+      blitz::Array<T,2> copy(src.shape());
+      copy = src;
+      convolveSeparable(copy, kernel_y, kernel_x, dst, border_type, buffer);
+      return;
+    }
+
+    // the strips of rows are padded with radius elements at both sides of each row
+    static const int cache_size = 1 << 15;
+    const int size = kernel_x.extent(0), radius = size / 2, padded_width = width + 2 * radius;
+    const int strip = std::max(1, std::min(height, cache_size / padded_width));
+    if (buffer.extent(0) != strip || buffer.extent(1) != padded_width) buffer.resize(strip, padded_width);
+
+    // the mirrored horizontal kernel
+    std::vector<double> kernel(size);
+    for (int k = 0; k < size; ++k) kernel[k] = kernel_x(size - 1 - k);
+
+    // the indices that are copied into the left and right border of each row
+    std::vector<int> border(2 * radius);
+    for (int i = 0; i < radius; ++i){
+      border[i] = _border_index(i - radius, width, border_type);
+      border[radius + i] = _border_index(width + i, width, border_type);
+    }
+
+    for (int start = 0; start < height; start += strip){
+      const int rows = std::min(strip, height - start);
+      _convolve_rows(src, kernel_y, border_type, start, rows, buffer, radius);
+      for (int r = 0; r < rows; ++r){
+        double* row = &buffer(r, 0);
+        for (int i = 0; i < radius; ++i){
+          row[i] = border[i] < 0 ? 0. : row[radius + border[i]];
+          row[radius + width + i] = border[radius + i] < 0 ? 0. : row[radius + border[radius + i]];
+        }
+        double* out = &dst(start + r, 0);
+        const std::ptrdiff_t dst_dx = dst.stride(1);
+        for (int x = 0; x < width; ++x){
+          const double* in = row + x;
+          double sum = 0.;
+          for (int k = 0; k < size; ++k) sum += kernel[k] * in[k];
+          out[x * dst_dx] = sum;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief The coefficients of the fourth-order recursive approximation of the Gaussian by Deriche, normalized to unit gain.
+   * The causal part filters the signal forward, the anti-causal part filters it backward, and the result is the sum of both.
+   */
+  struct _RecursiveGaussian {
+    double causal[4], anticausal[4], feedback[4];
+    double causal_gain, anticausal_gain;
+
+    explicit _RecursiveGaussian(const double sigma){
+      if (!(sigma >= 0.5)) throw std::runtime_error((boost::format("the recursive Gaussian requires a standard deviation of at least 0.5, but %g was given") % sigma).str());
+      const double a0 = 1.680, a1 = 3.735, b0 = 1.783, b1 = 1.723, c0 = -0.6803, c1 = -0.2598, w0 = 0.6318, w1 = 1.997;
+      const double cos0 = cos(w0 / sigma), sin0 = sin(w0 / sigma), cos1 = cos(w1 / sigma), sin1 = sin(w1 / sigma);
+      const double exp0 = exp(-b0 / sigma), exp1 = exp(-b1 / sigma);
+
+      causal[0] = a0 + c0;
+      causal[1] = exp1 * (c1 * sin1 - (c0 + 2. * a0) * cos1) + exp0 * (a1 * sin0 - (2. * c0 + a0) * cos0);
+      causal[2] = 2. * exp0 * exp1 * ((a0 + c0) * cos1 * cos0 - a1 * cos1 * sin0 - c1 * cos0 * sin1) + c0 * exp0 * exp0 + a0 * exp1 * exp1;
+      causal[3] = exp1 * exp0 * exp0 * (c1 * sin1 - c0 * cos1) + exp0 * exp1 * exp1 * (a1 * sin0 - a0 * cos0);
+
+      feedback[0] = -2. * exp1 * cos1 - 2. * exp0 * cos0;
+      feedback[1] = 4. * cos1 * cos0 * exp0 * exp1 + exp1 * exp1 + exp0 * exp0;
+      feedback[2] = -2. * cos0 * exp0 * exp1 * exp1 - 2. * cos1 * exp1 * exp0 * exp0;
+      feedback[3] = exp0 * exp0 * exp1 * exp1;
+
+      for (int i = 0; i < 3; ++i) anticausal[i] = causal[i+1] - feedback[i] * causal[0];
+      anticausal[3] = -feedback[3] * causal[0];
+
+      // normalize the filter such that a constant signal is not altered
+      const double denominator = 1. + feedback[0] + feedback[1] + feedback[2] + feedback[3];
+      causal_gain = (causal[0] + causal[1] + causal[2] + causal[3]) / denominator;
+      anticausal_gain = (anticausal[0] + anticausal[1] + anticausal[2] + anticausal[3]) / denominator;
+      const double gain = causal_gain + anticausal_gain;
+      for (int i = 0; i < 4; ++i){
+        causal[i] /= gain;
+        anticausal[i] /= gain;
+      }
+      causal_gain /= gain;
+      anticausal_gain /= gain;
+    }
+  };
+
+  /**
+   * @brief The number of pixels that the signal is extended by at both sides before filtering it recursively.
+   * For Zero and NearestNeighbour borders, the initial state of the recursion is exact, so no extension is needed.
+   * For the other borders, the signal is extended until the influence of the initial state has decayed.
+   */
+  static inline int _recursive_padding(const double sigma, const bob::sp::Extrapolation::BorderType border_type){
+    if (border_type == bob::sp::Extrapolation::Zero || border_type == bob::sp::Extrapolation::NearestNeighbour) return 0;
+    return static_cast<int>(std::ceil(5. * sigma)) + 4;
+  }
+
+  /**
+   * @brief Filters the given signal recursively, where the signal is assumed to be constant before the first and after the last element.
+   * The in and out arrays must not overlap.
+   */
+  static inline void _recursive_line(const _RecursiveGaussian& g, const double* in, double* out, const int size, const double first, const double last){
+    const double* c = g.causal,* a = g.anticausal,* d = g.feedback;
+    // causal part
+    double x1 = first, x2 = first, x3 = first;
+    double y1 = g.causal_gain * first, y2 = y1, y3 = y1, y4 = y1;
+    for (int i = 0; i < size; ++i){
+      const double x0 = in[i];
+      const double y0 = c[0] * x0 + c[1] * x1 + c[2] * x2 + c[3] * x3 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+      out[i] = y0;
+      x3 = x2; x2 = x1; x1 = x0;
+      y4 = y3; y3 = y2; y2 = y1; y1 = y0;
+    }
+    // anti-causal part
+    double x4 = x1 = x2 = x3 = last;
+    y1 = y2 = y3 = y4 = g.anticausal_gain * last;
+    for (int i = size - 1; i >= 0; --i){
+      const double y0 = a[0] * x1 + a[1] * x2 + a[2] * x3 + a[3] * x4 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+      out[i] += y0;
+      x4 = x3; x3 = x2; x2 = x1; x1 = in[i];
+      y4 = y3; y3 = y2; y2 = y1; y1 = y0;
+    }
+  }
+
+  /**
+   * @brief Smooths the given src image with a Gaussian using the recursive (IIR) approximation of Deriche,
+   * and writes the result into dst.
+   *
+   * In opposition to convolveSeparable, the execution time per pixel does not depend on the standard deviation.
+   * The Gaussian is not truncated, and the approximation error of the impulse response is below 0.05% of its maximum.
+   * The rows of the image are filtered into the buffer, whose columns are filtered into dst afterwards, processing whole rows at a time.
+   * The border types are handled as in convolveSeparable.
+   *
+   * @param src The image to smooth, which is read in its own data type; might be identical to dst
+   * @param sigma_y The standard deviation of the Gaussian along the y-axis, must be at least 0.5
+   * @param sigma_x The standard deviation of the Gaussian along the x-axis, must be at least 0.5
+   * @param dst The smoothed image
+   * @param border_type The way the pixels outside of the image are handled
+   * @param buffer A buffer that is resized as required, which can be re-used between several calls
+   */
+  template <typename T>
+  void recursiveGaussian(const blitz::Array<T,2>& src, const double sigma_y, const double sigma_x, blitz::Array<double,2>& dst, const bob::sp::Extrapolation::BorderType border_type, blitz::Array<double,2>& buffer){
+    bob::core::array::assertSameShape(src, dst);
+    const _RecursiveGaussian gauss_y(sigma_y), gauss_x(sigma_x);
+    const int height = src.extent(0), width = src.extent(1);
+    if (!height || !width) return;
+    if (buffer.extent(0) != height || buffer.extent(1) != width) buffer.resize(height, width);
+
+    // filter the rows into the buffer; src is not read afterwards, so it might share memory with dst
+    const int pad_x = _recursive_padding(sigma_x, border_type), padded_width = width + 2 * pad_x;
+    // the source columns of the extended rows, including the constant elements before and after
+    std::vector<int> columns(padded_width + 2);
+    for (int i = 0; i < padded_width + 2; ++i) columns[i] = _border_index(i - pad_x - 1, width, border_type);
+    std::vector<double> line(padded_width + 2), filtered(padded_width);
+    const std::ptrdiff_t src_dx = src.stride(1);
+    for (int y = 0; y < height; ++y){
+      const T* in = &src(y,0);
+      for (int i = 0; i < padded_width + 2; ++i) line[i] = columns[i] < 0 ? 0. : static_cast<double>(in[columns[i] * src_dx]);
+      _recursive_line(gauss_x, &line[1], &filtered[0], padded_width, line[0], line[padded_width + 1]);
+      std::copy(filtered.begin() + pad_x, filtered.begin() + pad_x + width, &buffer(y,0));
+    }
+
+    // filter the columns of the buffer into dst, processing whole rows at a time
+    const int pad_y = _recursive_padding(sigma_y, border_type), padded_height = height + 2 * pad_y;
+    const std::vector<double> zeros(width, 0.);
+    std::vector<const double*> rows(padded_height + 2);
+    for (int i = 0; i < padded_height + 2; ++i){
+      const int r = _border_index(i - pad_y - 1, height, border_type);
+      rows[i] = r < 0 ? &zeros[0] : &buffer(r,0);
+    }
+    // the current and the last four results of the recursion
+    std::vector<double> history(5 * width);
+    const std::ptrdiff_t dst_dx = dst.stride(1);
+    const double* c = gauss_y.causal,* a = gauss_y.anticausal,* d = gauss_y.feedback;
+
+    // causal part
+    const double* x1 = rows[0],* x2 = rows[0],* x3 = rows[0];
+    for (int x = 0; x < width; ++x) history[x] = gauss_y.causal_gain * rows[0][x];
+    for (int k = 1; k < 5; ++k) std::copy(history.begin(), history.begin() + width, history.begin() + k * width);
+    for (int i = 0; i < padded_height; ++i){
+      const double* x0 = rows[i+1];
+      double* y0 = &history[(i % 5) * width];
+      const double* y1 = &history[((i + 4) % 5) * width],* y2 = &history[((i + 3) % 5) * width],* y3 = &history[((i + 2) % 5) * width],* y4 = &history[((i + 1) % 5) * width];
+      for (int x = 0; x < width; ++x){
+        y0[x] = c[0] * x0[x] + c[1] * x1[x] + c[2] * x2[x] + c[3] * x3[x] - d[0] * y1[x] - d[1] * y2[x] - d[2] * y3[x] - d[3] * y4[x];
+      }
+      const int r = i - pad_y;
+      if (r >= 0 && r < height){
+        double* out = &dst(r,0);
+        for (int x = 0; x < width; ++x) out[x * dst_dx] = y0[x];
+      }
+      x3 = x2; x2 = x1; x1 = x0;
+    }
+
+    // anti-causal part
+    const double* x4 = x1 = x2 = x3 = rows[padded_height + 1];
+    for (int x = 0; x < width; ++x) history[x] = gauss_y.anticausal_gain * x1[x];
+    for (int k = 1; k < 5; ++k) std::copy(history.begin(), history.begin() + width, history.begin() + k * width);
+    for (int i = padded_height - 1, j = 0; i >= 0; --i, ++j){
+      double* y0 = &history[(j % 5) * width];
+      const double* y1 = &history[((j + 4) % 5) * width],* y2 = &history[((j + 3) % 5) * width],* y3 = &history[((j + 2) % 5) * width],* y4 = &history[((j + 1) % 5) * width];
+      for (int x = 0; x < width; ++x){
+        y0[x] = a[0] * x1[x] + a[1] * x2[x] + a[2] * x3[x] + a[3] * x4[x] - d[0] * y1[x] - d[1] * y2[x] - d[2] * y3[x] - d[3] * y4[x];
+      }
+      const int r = i - pad_y;
+      if (r >= 0 && r < height){
+        double* out = &dst(r,0);
+        for (int x = 0; x < width; ++x) out[x * dst_dx] += y0[x];
+      }
+      x4 = x3; x3 = x2; x2 = x1; x1 = rows[i+1];
+    }
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_CONVOLUTION_H
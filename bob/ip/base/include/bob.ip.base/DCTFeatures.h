@@ -10,9 +10,9 @@
 
 #include <bob.core/cast.h>
 #include <bob.core/array_copy.h>
-#include <bob.sp/DCT2D.h>
 #include <list>
 #include <limits>
+#include <vector>
 
 #include <bob.ip.base/Block.h>
 
@@ -26,6 +26,10 @@ namespace bob { namespace ip { namespace base {
     *   IEEE International Conference on Image Processing 2002.
     *   In addition, it support pre- and post-normalization (zero mean and
     *   unit variance, at the block level, or DCT coefficient level)
+    *
+    *   The DCT of the blocks is pruned: only the DCT coefficients that are
+    *   kept are computed, using separable row and column transforms with
+    *   precomputed cosine tables.
     */
   class DCTFeatures
   {
@@ -108,9 +112,9 @@ namespace bob { namespace ip { namespace base {
       /**
         * @brief Setters
         */
-      void setBlockH(const size_t block_h) { m_block_h = block_h; m_dct2d.setHeight(block_h); resetCacheBlock(); }
-      void setBlockW(const size_t block_w) { m_block_w = block_w; m_dct2d.setWidth(block_w); resetCacheBlock(); }
-      void setBlockSize(const blitz::TinyVector<int,2>& size) {m_block_h = size[0]; m_block_w = size[1]; m_dct2d.setHeight(m_block_h); m_dct2d.setWidth(m_block_w); resetCacheBlock();}
+      void setBlockH(const size_t block_h) { m_block_h = block_h; }
+      void setBlockW(const size_t block_w) { m_block_w = block_w; }
+      void setBlockSize(const blitz::TinyVector<int,2>& size) {m_block_h = size[0]; m_block_w = size[1];}
       void setOverlapH(const size_t overlap_h) { m_overlap_h = overlap_h; }
       void setOverlapW(const size_t overlap_w) { m_overlap_w = overlap_w; }
       void setBlockOverlap(const blitz::TinyVector<int,2>& overlap) {m_overlap_h = overlap[0]; m_overlap_w = overlap[1];}
@@ -190,7 +194,6 @@ namespace bob { namespace ip { namespace base {
       /**
         * Attributes
         */
-      bob::sp::DCT2D m_dct2d;
       size_t m_block_h;
       size_t m_block_w;
       size_t m_overlap_h;
@@ -203,19 +206,36 @@ namespace bob { namespace ip { namespace base {
       double m_norm_epsilon;
 
       void setCheckSqrtNDctCoefs();
-      void normalizeBlock(const blitz::Array<double,2>& src) const;
-      void extractRowDCTCoefs(blitz::Array<double,1>& coefs) const;
+
+      /**
+        * @brief Computes the cosine tables and the positions of the kept
+        *   DCT coefficients for the current parameters
+        */
+      void prepareDct() const;
+
+      /**
+        * @brief Normalizes the given block (if required) and computes its
+        *   kept DCT coefficients
+        */
+      void blockDct(const double* block, const std::ptrdiff_t stride_y, const std::ptrdiff_t stride_x, double* dst, const std::ptrdiff_t dst_stride) const;
 
       /**
         * Working arrays/variables in cache
         */
-      void resetCache() const;
-      void resetCacheBlock() const;
       void resetCacheDct() const;
 
-      mutable blitz::Array<double,2> m_cache_block1;
-      mutable blitz::Array<double,2> m_cache_block2;
-      mutable blitz::Array<double,1> m_cache_dct_full;
+      // the number of DCT rows and columns that contain kept coefficients,
+      // and the number of columns that are computed in each of these rows
+      mutable int m_dct_rows;
+      mutable int m_dct_columns;
+      mutable std::vector<int> m_dct_row_lengths;
+      // the positions of the kept coefficients in the (m_dct_rows, m_dct_columns) coefficient table
+      mutable std::vector<int> m_dct_index;
+      // the cosine tables of the vertical (u, y) and the horizontal (x, v) transform
+      mutable std::vector<double> m_dct_cos_h;
+      mutable std::vector<double> m_dct_cos_w;
+      mutable std::vector<double> m_cache_rows;
+      mutable std::vector<double> m_cache_coefs;
       mutable blitz::Array<double,1> m_cache_dct1;
       mutable blitz::Array<double,1> m_cache_dct2;
   };
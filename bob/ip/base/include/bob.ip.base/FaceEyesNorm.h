@@ -14,7 +14,11 @@
 #include <bob.core/assert.h>
 #include <bob.core/check.h>
 
+#include <vector>
+#include <boost/bind.hpp>
+
 #include <bob.ip.base/GeomNorm.h>
+#include <bob.ip.base/Parallel.h>
 
 static inline double _sqr(double x){return x*x;}
 
@@ -92,25 +96,88 @@ namespace bob { namespace ip { namespace base {
       /**
         * @brief Process a 2D face image by applying the geometric
         * normalization
+        *
+        * For integral dst types, the interpolated values are rounded and saturated.
         */
-      template <typename T>
+      template <typename T, typename U>
       void extract(
         const blitz::Array<T,2>& src,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
       ) const;
 
-      template <typename T>
+      template <typename T, typename U>
       void extract(
         const blitz::Array<T,2>& src,
         const blitz::Array<bool,2>& srcMask,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         blitz::Array<bool,2>& dstMask,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
       ) const;
 
+      /**
+        * @brief Process a 3D color face image by applying the geometric
+        * normalization to all color planes in a single pass
+        *
+        * The color planes of src and dst are stored in the given layout.
+        */
+      template <typename T, typename U>
+      void extract(
+        const blitz::Array<T,3>& src,
+        blitz::Array<U,3>& dst,
+        const blitz::TinyVector<double,2>& rightEye,
+        const blitz::TinyVector<double,2>& leftEye,
+        const ColorLayout layout = LAYOUT_PLANAR
+      ) const;
+
+      /**
+        * @brief Normalizes several faces at once, distributing them over several threads.
+        *
+        * The i'th rows of rightEyes and leftEyes contain the (y,x) positions of the eyes of the i'th face.
+        * For a 2D src image, all faces are extracted from this image, while for a 3D src, the i'th face is extracted from src(i,:,:).
+        * The i'th normalized face is written to dst(i,:,:).
+        *
+        * In opposition to extract(), this function does not modify this object, and it can be called concurrently.
+        *
+        * @param threads  The number of threads to use; with 0, all available cores are used
+        */
+      template <typename T, int N, typename U>
+      void extractBatch(
+        const blitz::Array<T,N>& src,
+        blitz::Array<U,3>& dst,
+        const blitz::Array<double,2>& rightEyes,
+        const blitz::Array<double,2>& leftEyes,
+        const int threads = 0
+      ) const;
+
+      template <typename T, int N, typename U>
+      void extractBatch(
+        const blitz::Array<T,N>& src,
+        const blitz::Array<bool,N>& srcMask,
+        blitz::Array<U,3>& dst,
+        blitz::Array<bool,3>& dstMask,
+        const blitz::Array<double,2>& rightEyes,
+        const blitz::Array<double,2>& leftEyes,
+        const int threads = 0
+      ) const;
+
+      /**
+       * @brief Computes the geometric normalization for the given eye positions
+       * without modifying this object.
+       *
+       * @param rightEye  The position of the right eye in the source image
+       * @param leftEye  The position of the left eye in the source image
+       * @param center  Will contain the transformation center in the source image, i.e., the center between the eyes
+       * @return  The GeomNorm object that transforms the source image with the given eye positions
+       */
+      GeomNorm computeGeomNorm(
+        const blitz::TinyVector<double,2>& rightEye,
+        const blitz::TinyVector<double,2>& leftEye,
+        blitz::TinyVector<double,2>& center
+      ) const;
+
       /**
        * @brief Getter function for the bob::ip::GeomNorm object that is doing the job.
        *
@@ -122,16 +189,28 @@ namespace bob { namespace ip { namespace base {
 
     private:
 
-      template <typename T, bool mask>
+      template <typename T, bool mask, typename U>
       void processNoCheck(
         const blitz::Array<T,2>& src,
         const blitz::Array<bool,2>& srcMask,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         blitz::Array<bool,2>& dstMask,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
       ) const;
 
+      template <typename T, bool mask, typename U>
+      void extractBatchNoCheck(
+        const std::vector<blitz::Array<T,2> >& src,
+        const std::vector<blitz::Array<bool,2> >& srcMask,
+        std::vector<blitz::Array<U,2> >& dst,
+        std::vector<blitz::Array<bool,2> >& dstMask,
+        const blitz::Array<double,2>& rightEyes,
+        const blitz::Array<double,2>& leftEyes,
+        const int begin,
+        const int end
+      ) const;
+
       /**
         * Attributes
         */
@@ -142,10 +221,10 @@ namespace bob { namespace ip { namespace base {
       mutable boost::shared_ptr<GeomNorm> m_geomNorm;
   };
 
-  template <typename T>
+  template <typename T, typename U>
   inline void FaceEyesNorm::extract(
     const blitz::Array<T,2>& src,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
   ) const
@@ -162,11 +241,11 @@ namespace bob { namespace ip { namespace base {
     processNoCheck<T,false>(src, srcMask, dst, dstMask, rightEye, leftEye);
   }
 
-  template <typename T>
+  template <typename T, typename U>
   inline void FaceEyesNorm::extract(
     const blitz::Array<T,2>& src,
     const blitz::Array<bool,2>& srcMask,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     blitz::Array<bool,2>& dstMask,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
@@ -187,29 +266,34 @@ namespace bob { namespace ip { namespace base {
     processNoCheck<T,true>(src, srcMask, dst, dstMask, rightEye, leftEye);
   }
 
-  template <typename T, bool mask>
+  template <typename T, typename U>
+  inline void FaceEyesNorm::extract(
+    const blitz::Array<T,3>& src,
+    blitz::Array<U,3>& dst,
+    const blitz::TinyVector<double,2>& rightEye,
+    const blitz::TinyVector<double,2>& leftEye,
+    const ColorLayout layout
+  ) const
+  {
+    // Get angle, scale and center of the eyes
+    *m_geomNorm = computeGeomNorm(rightEye, leftEye, m_lastCenter);
+
+    // Perform the normalization; the checks are done by GeomNorm
+    m_geomNorm->process(src, dst, m_lastCenter, layout);
+  }
+
+  template <typename T, bool mask, typename U>
   inline void FaceEyesNorm::processNoCheck(
     const blitz::Array<T,2>& src,
     const blitz::Array<bool,2>& srcMask,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     blitz::Array<bool,2>& dstMask,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
   ) const
   {
-    // Get angle to horizontal
-    double dy = leftEye[0] - rightEye[0], dx = leftEye[1] - rightEye[1];
-    double angle = std::atan2(dy, dx);
-    m_geomNorm->setRotationAngle(angle * 180. / M_PI - m_eyesAngle);
-
-    // Get scaling factor
-    m_geomNorm->setScalingFactor(m_eyesDistance / sqrt(_sqr(leftEye[0]-rightEye[0]) + _sqr(leftEye[1]-rightEye[1])));
-
-    // Get the center (of the eye centers segment)
-    m_lastCenter = blitz::TinyVector<double,2>(
-      (rightEye[0] + leftEye[0]) / 2.,
-      (rightEye[1] + leftEye[1]) / 2.
-    );
+    // Get angle, scale and center of the eyes
+    *m_geomNorm = computeGeomNorm(rightEye, leftEye, m_lastCenter);
 
     // Perform the normalization
     if(mask)
@@ -218,6 +302,117 @@ namespace bob { namespace ip { namespace base {
       m_geomNorm->process(src, dst, m_lastCenter);
   }
 
+  /** helper functions to split the source images of extractBatch into 2D images */
+  template <typename T>
+  static inline void _batch_images(const blitz::Array<T,2>& src, std::vector<blitz::Array<T,2> >& images){
+    images.push_back(src);
+  }
+
+  template <typename T>
+  static inline void _batch_images(const blitz::Array<T,3>& src, std::vector<blitz::Array<T,2> >& images){
+    for (int i = 0; i < src.extent(0); ++i)
+      images.push_back(src(i, blitz::Range::all(), blitz::Range::all()));
+  }
+
+  template <int N>
+  static inline void _check_batch(const blitz::TinyVector<int,N>& src_shape, const blitz::TinyVector<int,3>& dst_shape, const blitz::Array<double,2>& rightEyes, const blitz::Array<double,2>& leftEyes, const blitz::TinyVector<int,2>& cropSize){
+    bob::core::array::assertZeroBase(rightEyes);
+    bob::core::array::assertZeroBase(leftEyes);
+    bob::core::array::assertSameDimensionLength(rightEyes.extent(0), dst_shape[0]);
+    bob::core::array::assertSameDimensionLength(leftEyes.extent(0), dst_shape[0]);
+    bob::core::array::assertSameDimensionLength(rightEyes.extent(1), 2);
+    bob::core::array::assertSameDimensionLength(leftEyes.extent(1), 2);
+    bob::core::array::assertSameDimensionLength(dst_shape[1], cropSize[0]);
+    bob::core::array::assertSameDimensionLength(dst_shape[2], cropSize[1]);
+    if (N == 3) bob::core::array::assertSameDimensionLength(src_shape[0], dst_shape[0]);
+  }
+
+  template <typename T, int N, typename U>
+  inline void FaceEyesNorm::extractBatch(
+    const blitz::Array<T,N>& src,
+    blitz::Array<U,3>& dst,
+    const blitz::Array<double,2>& rightEyes,
+    const blitz::Array<double,2>& leftEyes,
+    const int threads
+  ) const
+  {
+    // Check input and output
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    _check_batch(src.shape(), dst.shape(), rightEyes, leftEyes, m_geomNorm->getCropSize());
+
+    // Since the reference counting of blitz is not thread-safe, all slices are created beforehand
+    std::vector<blitz::Array<T,2> > srcs;
+    std::vector<blitz::Array<bool,2> > srcMasks, dstMasks;
+    std::vector<blitz::Array<U,2> > dsts;
+    _batch_images(src, srcs);
+    _batch_images(dst, dsts);
+
+    // Process
+    parallelFor(dst.extent(0), threads, boost::bind(&FaceEyesNorm::extractBatchNoCheck<T,false,U>, this, boost::cref(srcs), boost::cref(srcMasks), boost::ref(dsts), boost::ref(dstMasks), boost::cref(rightEyes), boost::cref(leftEyes), _1, _2));
+  }
+
+  template <typename T, int N, typename U>
+  inline void FaceEyesNorm::extractBatch(
+    const blitz::Array<T,N>& src,
+    const blitz::Array<bool,N>& srcMask,
+    blitz::Array<U,3>& dst,
+    blitz::Array<bool,3>& dstMask,
+    const blitz::Array<double,2>& rightEyes,
+    const blitz::Array<double,2>& leftEyes,
+    const int threads
+  ) const
+  {
+    // Check input and output
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(srcMask);
+    bob::core::array::assertSameShape(src, srcMask);
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertZeroBase(dstMask);
+    bob::core::array::assertSameShape(dst, dstMask);
+    _check_batch(src.shape(), dst.shape(), rightEyes, leftEyes, m_geomNorm->getCropSize());
+
+    // Since the reference counting of blitz is not thread-safe, all slices are created beforehand
+    std::vector<blitz::Array<T,2> > srcs;
+    std::vector<blitz::Array<bool,2> > srcMasks, dstMasks;
+    std::vector<blitz::Array<U,2> > dsts;
+    _batch_images(src, srcs);
+    _batch_images(srcMask, srcMasks);
+    _batch_images(dst, dsts);
+    _batch_images(dstMask, dstMasks);
+
+    // Process
+    parallelFor(dst.extent(0), threads, boost::bind(&FaceEyesNorm::extractBatchNoCheck<T,true,U>, this, boost::cref(srcs), boost::cref(srcMasks), boost::ref(dsts), boost::ref(dstMasks), boost::cref(rightEyes), boost::cref(leftEyes), _1, _2));
+  }
+
+  template <typename T, bool mask, typename U>
+  inline void FaceEyesNorm::extractBatchNoCheck(
+    const std::vector<blitz::Array<T,2> >& src,
+    const std::vector<blitz::Array<bool,2> >& srcMask,
+    std::vector<blitz::Array<U,2> >& dst,
+    std::vector<blitz::Array<bool,2> >& dstMask,
+    const blitz::Array<double,2>& rightEyes,
+    const blitz::Array<double,2>& leftEyes,
+    const int begin,
+    const int end
+  ) const
+  {
+    for (int i = begin; i < end; ++i){
+      // the image to extract the face from
+      const int j = src.size() == 1 ? 0 : i;
+      blitz::TinyVector<double,2> center;
+      const GeomNorm geomNorm = computeGeomNorm(
+        blitz::TinyVector<double,2>(rightEyes(i,0), rightEyes(i,1)),
+        blitz::TinyVector<double,2>(leftEyes(i,0), leftEyes(i,1)),
+        center
+      );
+      if (mask)
+        geomNorm.process(src[j], srcMask[j], dst[i], dstMask[i], center);
+      else
+        geomNorm.process(src[j], dst[i], center);
+    }
+  }
+
 } } } // namespaces
 
 #endif /* BOB_IP_BASE_FACE_EYES_NORM_H */
@@ -11,12 +11,18 @@
 #define BOB_IP_BASE_GAUSSIAN_H
 
 #include <bob.core/assert.h>
-#include <bob.core/cast.h>
-#include <bob.sp/conv.h>
 #include <bob.sp/extrapolate.h>
+#include <bob.ip.base/Convolution.h>
 
 namespace bob { namespace ip { namespace base {
 
+  /** The algorithms to smooth an image with a Gaussian */
+  typedef enum {
+    GAUSSIAN_CONVOLUTION = 0, //!< convolve with the Gaussian kernel, which is truncated at the radius; the execution time grows with the radius
+    GAUSSIAN_RECURSIVE = 1,   //!< use the recursive approximation of the (not truncated) Gaussian; the execution time does not depend on sigma, and the radius is ignored
+    GAUSSIAN_AUTOMATIC = 2    //!< use the recursive approximation when it is faster and the kernel is not truncated, see Gaussian::isRecursive
+  } GaussianAlgorithm;
+
   /**
     * @brief This class allows to smooth images with a Gaussian kernel
     */
@@ -30,11 +36,13 @@ namespace bob { namespace ip { namespace base {
        * @param sigma_y The standard deviation of the kernel along the y-axis
        * @param sigma_x The standard deviation of the kernel along the x-axis
        * @param border_type The interpolation type for the convolution
+       * @param algorithm The algorithm used to smooth the image
        */
       Gaussian(
         const size_t radius_y = 1, const size_t radius_x = 1,
         const double sigma_y=sqrt(2.5), const double sigma_x=sqrt(2.5),
-        const bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror
+        const bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror,
+        const GaussianAlgorithm algorithm = GAUSSIAN_CONVOLUTION
       );
 
       /**
@@ -68,11 +76,13 @@ namespace bob { namespace ip { namespace base {
        * @param sigma_y The standard deviation of the kernel along the y-axis
        * @param sigma_x The standard deviation of the kernel along the x-axis
        * @param border_type The interpolation type for the convolution
+       * @param algorithm The algorithm used to smooth the image
        */
       void reset(
         const size_t radius_y, const size_t radius_x,
         const double sigma_y=sqrt(2.5), const double sigma_x=sqrt(2.5),
-        const bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror
+        const bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror,
+        const GaussianAlgorithm algorithm = GAUSSIAN_CONVOLUTION
       );
 
       /**
@@ -83,6 +93,7 @@ namespace bob { namespace ip { namespace base {
       double getSigmaY() const { return m_sigma_y; }
       double getSigmaX() const { return m_sigma_x; }
       bob::sp::Extrapolation::BorderType getConvBorder() const { return m_conv_border; }
+      GaussianAlgorithm getAlgorithm() const { return m_algorithm; }
       const blitz::Array<double,1>& getKernelY() const { return m_kernel_y; }
       const blitz::Array<double,1>& getKernelX() const { return m_kernel_x; }
 
@@ -96,6 +107,14 @@ namespace bob { namespace ip { namespace base {
       void setSigmaX(const double sigma_x) { m_sigma_x = sigma_x; computeKernel(); }
       void setSigma(const blitz::TinyVector<double,2>& sigma) {m_sigma_y = sigma[0]; m_sigma_x = sigma[1]; computeKernel();}
       void setConvBorder(const bob::sp::Extrapolation::BorderType border_type) { m_conv_border = border_type; }
+      void setAlgorithm(const GaussianAlgorithm algorithm) { m_algorithm = algorithm; }
+
+      /**
+       * @brief Returns whether the image is smoothed with the recursive approximation of the Gaussian.
+       *   With GAUSSIAN_AUTOMATIC, this is the case when both standard deviations are at least 3 pixels,
+       *   and both radii are at least 3 times the standard deviations (rounded), e.g., as chosen by default in the python bindings.
+       */
+      bool isRecursive() const;
 
       /**
        * @brief Process a 2D blitz Array/Image
@@ -107,15 +126,14 @@ namespace bob { namespace ip { namespace base {
 
       /**
        * @brief Process a 2D blitz Array/Image
+       *   The src image is read in its own data type, without converting it to double first.
        * @param src The 2D input blitz array
        * @param dst The 2D output blitz array
        */
       template <typename T>
       void filter(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst){
-        // Casts the input to double
-        blitz::Array<double,2> src_d = bob::core::array::cast<double>(src);
-        // Calls the specialized template function for double
-        filter_(src_d, dst);
+        if (isRecursive()) recursiveGaussian(src, m_sigma_y, m_sigma_x, dst, m_conv_border, m_tmp_int);
+        else convolveSeparable(src, m_kernel_y, m_kernel_x, dst, m_conv_border, m_tmp_int);
       }
 
 
@@ -146,13 +164,12 @@ namespace bob { namespace ip { namespace base {
       double m_sigma_y;
       double m_sigma_x;
       bob::sp::Extrapolation::BorderType m_conv_border;
+      GaussianAlgorithm m_algorithm;
 
       blitz::Array<double, 1> m_kernel_y;
       blitz::Array<double, 1> m_kernel_x;
 
       blitz::Array<double, 2> m_tmp_int;
-      blitz::Array<double, 2> m_tmp_int1;
-      blitz::Array<double, 2> m_tmp_int2;
   };
 
 
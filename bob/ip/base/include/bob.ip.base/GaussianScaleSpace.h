@@ -13,6 +13,8 @@
 
 #include <boost/shared_ptr.hpp>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include <bob.ip.base/Gaussian.h>
 
@@ -96,6 +98,90 @@ namespace bob { namespace ip { namespace base {
     dst = src(rsrc_y, rsrc_x);
   }
 
+  /**
+   * @brief Returns the standard deviation of the normalized Gaussian kernel with the given sigma, which is truncated at the given radius
+   */
+  static inline double _truncated_sigma(const double sigma, const int radius)
+  {
+    double sum = 0., variance = 0.;
+    for (int i = -radius; i <= radius; ++i){
+      const double weight = exp(-0.5 * i * i / (sigma * sigma));
+      sum += weight;
+      variance += weight * i * i;
+    }
+    return sqrt(variance / sum);
+  }
+
+  /**
+   * @brief Returns the number of pyramid levels, each halving the resolution, after which an image of the given size is smoothed with a Gaussian of the given sigma.
+   * The image is decimated as long as the remaining smoothing spans at least two pixels of the decimated image,
+   * and the decimated image keeps at least 8 pixels in both directions.
+   */
+  static inline int _decimation_levels(const double sigma, const int height, const int width)
+  {
+    int levels = 0;
+    while ((4 << levels) <= sigma && (std::min(height, width) >> (levels+1)) >= 8)
+      ++levels;
+    return levels;
+  }
+
+  /**
+   * @brief Returns the variance (in pixels of the full resolution image) that is introduced by the given number of pyramid levels built by _build_pyramid
+   */
+  static inline double _pyramid_variance(const int levels)
+  {
+    // each level is smoothed with unit standard deviation at its own resolution
+    return ((1 << 2*levels) - 1) / 3.;
+  }
+
+  /**
+   * @brief Builds the given number of levels of a Gaussian pyramid, where pyramid[l] has 2^(l+1) times lower resolution than src.
+   * Before decimation, each level is smoothed with the given smoother, which should have unit standard deviation.
+   */
+  template <typename T>
+  void _build_pyramid(const blitz::Array<T,2>& src, const int levels, bob::ip::base::Gaussian& smoother, blitz::Array<double,2>& buffer, std::vector<blitz::Array<double,2> >& pyramid)
+  {
+    pyramid.resize(levels);
+    for (int l = 0; l < levels; ++l){
+      const blitz::TinyVector<int,2> shape = l ? pyramid[l-1].shape() : src.shape();
+      if (buffer.extent(0) != shape[0] || buffer.extent(1) != shape[1])
+        buffer.resize(shape);
+      if (l) smoother.filter(pyramid[l-1], buffer);
+      else smoother.filter(src, buffer);
+      if (pyramid[l].extent(0) != shape[0] / 2 || pyramid[l].extent(1) != shape[1] / 2)
+        pyramid[l].resize(shape[0] / 2, shape[1] / 2);
+      _downsample(buffer, pyramid[l], 1);
+    }
+  }
+
+  /**
+   * @brief Bilinearly interpolates the src image, which was decimated by the given number of pyramid levels (see _downsample), to the resolution of dst.
+   * Pixels beyond the last sample of src are extrapolated with the nearest sample.
+   */
+  static inline void _upsample_bilinear(const blitz::Array<double,2>& src, const int levels, blitz::Array<double,2>& dst)
+  {
+    const double scale = 1. / (1 << levels);
+    const int width = dst.extent(1);
+    std::vector<int> x0(width), x1(width);
+    std::vector<double> wx(width);
+    for (int x = 0; x < width; ++x){
+      const double p = std::min(x * scale, src.extent(1) - 1.);
+      x0[x] = (int)p;
+      x1[x] = std::min(x0[x] + 1, src.extent(1) - 1);
+      wx[x] = p - x0[x];
+    }
+    for (int y = 0; y < dst.extent(0); ++y){
+      const double p = std::min(y * scale, src.extent(0) - 1.);
+      const int y0 = (int)p, y1 = std::min(y0 + 1, src.extent(0) - 1);
+      const double wy = p - y0;
+      for (int x = 0; x < width; ++x){
+        const double top = src(y0,x0[x]) + wx[x] * (src(y0,x1[x]) - src(y0,x0[x]));
+        const double bottom = src(y1,x0[x]) + wx[x] * (src(y1,x1[x]) - src(y1,x0[x]));
+        dst(y,x) = top + wy * (bottom - top);
+      }
+    }
+  }
+
 
   /**
    * @brief This class can be used to extract a Gaussian Scale Space
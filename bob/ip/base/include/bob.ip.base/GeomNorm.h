@@ -83,20 +83,27 @@ namespace bob { namespace ip { namespace base {
       /**
         * @brief Process a 2D blitz Array/Image by applying the geometric
         * normalization
+        *
+        * The type of the dst image can differ from the type of the src image;
+        * for integral dst types, the interpolated values are rounded and saturated.
         */
-      template <typename T>
-      void process(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const blitz::TinyVector<double,2>& center) const;
-      template <typename T>
-      void process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const;
 
       /**
        * @brief Process a 3D blitz Array/Image by applying the geometric
        * normalization to each color plane
+       *
+       * The color planes can be stored in planar (planes, height, width) or
+       * interleaved (height, width, planes) layout; all planes are processed
+       * in a single pass.
        */
-      template <typename T>
-      void process(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const blitz::TinyVector<double,2>& center) const;
-      template <typename T>
-      void process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const blitz::TinyVector<double,2>& center, const ColorLayout layout = LAYOUT_PLANAR) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center, const ColorLayout layout = LAYOUT_PLANAR) const;
 
       /**
        * @brief applies the geometric normalization to the given input position
@@ -113,8 +120,8 @@ namespace bob { namespace ip { namespace base {
       blitz::TinyVector<double,2> m_crop_offset;
   };
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const blitz::TinyVector<double,2>& center) const
   {
     // Check input
     bob::core::array::assertZeroBase(src);
@@ -129,8 +136,8 @@ namespace bob { namespace ip { namespace base {
     bob::ip::base::transform<T,false>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle);
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const
   {
     // Check input
     bob::core::array::assertZeroBase(src);
@@ -148,32 +155,41 @@ namespace bob { namespace ip { namespace base {
     bob::ip::base::transform<T,true>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle);
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const blitz::TinyVector<double,2>& center, const ColorLayout layout) const
   {
-    for( int p=0; p<dst.extent(0); ++p) {
-      const blitz::Array<T,2> src_slice =
-        src( p, blitz::Range::all(), blitz::Range::all() );
-      blitz::Array<double,2> dst_slice =
-        dst( p, blitz::Range::all(), blitz::Range::all() );
-
-      // Process one plane
-      process(src_slice, dst_slice, center);
-    }
+    // Check input
+    bob::core::array::assertZeroBase(src);
+
+    // Check output
+    bob::core::array::assertZeroBase(dst);
+    const blitz::TinyVector<int,2> dst_shape = _image_shape(dst.shape(), layout);
+    bob::core::array::assertSameDimensionLength(dst_shape[0], m_crop_size[0]);
+    bob::core::array::assertSameDimensionLength(dst_shape[1], m_crop_size[1]);
+
+    // Process all planes at once
+    blitz::Array<bool,3> src_mask, dst_mask;
+    bob::ip::base::transform<T,false>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle, layout);
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center, const ColorLayout layout) const
   {
-    for( int p=0; p<dst.extent(0); ++p) {
-      const blitz::Array<T,2> src_slice = src( p, blitz::Range::all(), blitz::Range::all() );
-      const blitz::Array<bool,2> src_mask_slice = src_mask( p, blitz::Range::all(), blitz::Range::all() );
-      blitz::Array<double,2> dst_slice = dst( p, blitz::Range::all(), blitz::Range::all() );
-      blitz::Array<bool,2> dst_mask_slice = dst_mask( p, blitz::Range::all(), blitz::Range::all() );
-
-      // Process one plane
-      process(src_slice, src_mask_slice, dst_slice, dst_mask_slice, center);
-    }
+    // Check input
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(src_mask);
+    bob::core::array::assertSameShape(src,src_mask);
+
+    // Check output
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertZeroBase(dst_mask);
+    bob::core::array::assertSameShape(dst, dst_mask);
+    const blitz::TinyVector<int,2> dst_shape = _image_shape(dst.shape(), layout);
+    bob::core::array::assertSameDimensionLength(dst_shape[0], m_crop_size[0]);
+    bob::core::array::assertSameDimensionLength(dst_shape[1], m_crop_size[1]);
+
+    // Process all planes at once
+    bob::ip::base::transform<T,true>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle, layout);
   }
 
 } } } // namespaces
@@ -11,32 +11,184 @@
 #define BOB_IP_BASE_HISTOGRAM_H
 
 
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
 #include <bob.core/assert.h>
 #include <bob.io.base/array_type.h>
+#include <bob.ip.base/LookupTable.h>
+#include <bob.ip.base/Parallel.h>
 
 namespace bob { namespace ip { namespace base {
 
+  /** The number of interleaved sub-histograms that are filled by the histogram engine */
+  static const int _histogram_ways = 4;
+  /** The number of pixels of a row that are range-checked and binned together */
+  static const int _histogram_chunk = 256;
+
+  /** Maps pixel values directly to bin indices, i.e., for histograms with one bin per value */
+  template <typename T>
+  struct _DirectBins {
+    _DirectBins(const int bins) : m_bins(bins) {}
+
+    /** returns true if all n values are lower than the number of bins */
+    bool check(const T* s, const int n, const std::ptrdiff_t stride) const {
+      T m = 0;
+      for (int i = 0; i < n; ++i) m = s[i*stride] > m ? s[i*stride] : m;
+      return static_cast<uint64_t>(m) < static_cast<uint64_t>(m_bins);
+    }
+
+    /** throws the exception for the first value that is out of range */
+    void raise(const T* s, const int n, const std::ptrdiff_t stride) const {
+      for (int i = 0; i < n; ++i)
+        if (static_cast<uint64_t>(s[i*stride]) >= static_cast<uint64_t>(m_bins))
+          throw std::runtime_error((boost::format("The pixel with value (%d) in the source image is higher than the number of bins (%d)") % static_cast<uint64_t>(s[i*stride]) % m_bins).str());
+    }
+
+    /** computes the bin indices of n values */
+    void index(const T* s, const int n, const std::ptrdiff_t stride, int* bins) const {
+      for (int i = 0; i < n; ++i) bins[i] = static_cast<int>(s[i*stride]);
+    }
+
+    const int m_bins;
+  };
+
+  /** Maps pixel values to bin indices for regular bins between a minimum and a maximum value */
+  template <typename T>
+  struct _RangedBins {
+    _RangedBins(const T min, const T max, const int bins)
+    : m_min(min), m_max(max), m_bins(bins), m_bin_size(static_cast<double>(max - min) / static_cast<double>(bins)) {}
+
+    /** returns true if all n values are inside [min, max] */
+    bool check(const T* s, const int n, const std::ptrdiff_t stride) const {
+      int outside = 0;
+      for (int i = 0; i < n; ++i)
+        outside |= (s[i*stride] < m_min) | (s[i*stride] > m_max);
+      return !outside;
+    }
+
+    /** throws the exception for the first value that is out of range */
+    void raise(const T* s, const int n, const std::ptrdiff_t stride) const {
+      for (int i = 0; i < n; ++i)
+        if (s[i*stride] < m_min || s[i*stride] > m_max)
+          throw std::runtime_error((boost::format("The pixel with value (%1%) in the source image is not in the given range (%2%, %3%)") % s[i*stride] % m_min % m_max).str());
+    }
+
+    /** computes the bin indices of n values */
+    void index(const T* s, const int n, const std::ptrdiff_t stride, int* bins) const {
+      for (int i = 0; i < n; ++i)
+        bins[i] = std::min(static_cast<int>(static_cast<double>(s[i*stride] - m_min) / m_bin_size), m_bins - 1);
+    }
+
+    const T m_min, m_max;
+    const int m_bins;
+    const double m_bin_size;
+  };
+
   /**
-   * Compute an histogram of a 2D array.
-   *
-   * @warning This function only accepts arrays of int or float (int8, int16,
-   *          int32, int64, uint8, uint16, uint32, float32, float64
-   *          and float128)
-   *          Any other type raises a std::runtime_error exception
-   * @warning You must have @c min <= @c src(i,j) <= @c max, for every i and j
-   * @warning If @c min >= @c max or @c nb_bins == 0, a
-   *
-   * @param src source 2D array
-   * @param histo result of the function. This array must have @c nb_bins
-   *              elements
-   * @param min least possible value in @c src
-   * @param max greatest possible value in @c src
+   * @brief Adds the values of the rows [begin, end) to the given histogram.
+   * When the rows contain enough pixels, each chunk of pixels is spread over several sub-histograms, which are merged at the end,
+   * so that consecutive pixels with the same value do not increment the same counter.
    */
-  template<typename T>
-  void histogram(
-    const blitz::Array<T, 2>& src,
-    blitz::Array<uint64_t, 1>& histo
-  ){
+  template <typename T, typename B>
+  void _histogramRows(const std::vector<const T*>& rows, const int width, const std::ptrdiff_t stride, const B& bins, uint64_t* histo, const int begin, const int end){
+    const int nb_bins = bins.m_bins;
+    const int ways = (nb_bins <= 65536 && static_cast<double>(end - begin) * width >= 4. * _histogram_ways * nb_bins) ? _histogram_ways : 1;
+    std::vector<uint64_t> sub(ways > 1 ? _histogram_ways * nb_bins : 0, 0);
+    uint64_t* h0 = ways > 1 ? &sub[0] : histo;
+    uint64_t* h1 = h0 + nb_bins,* h2 = h1 + nb_bins,* h3 = h2 + nb_bins;
+    int index[_histogram_chunk];
+
+    for (int r = begin; r < end; ++r){
+      for (int x = 0; x < width; x += _histogram_chunk){
+        const int n = std::min(_histogram_chunk, width - x);
+        const T* s = rows[r] + x * stride;
+        // check the range once for the whole chunk; contiguous rows are written separately, so that the compiler can optimize for unit strides
+        if (stride == 1){
+          if (!bins.check(s, n, 1)) bins.raise(s, n, 1);
+          bins.index(s, n, 1, index);
+        } else {
+          if (!bins.check(s, n, stride)) bins.raise(s, n, stride);
+          bins.index(s, n, stride, index);
+        }
+        int i = 0;
+        if (ways > 1){
+          for (; i + 4 <= n; i += 4){
+            ++h0[index[i]]; ++h1[index[i+1]]; ++h2[index[i+2]]; ++h3[index[i+3]];
+          }
+        }
+        for (; i < n; ++i) ++h0[index[i]];
+      }
+    }
+
+    if (ways > 1){
+      for (int b = 0; b < nb_bins; ++b)
+        histo[b] += h0[b] + h1[b] + h2[b] + h3[b];
+    }
+  }
+
+  /** computes the private histograms of the parts [begin, end) of the rows */
+  template <typename T, typename B>
+  void _histogramParts(const std::vector<const T*>& rows, const int width, const std::ptrdiff_t stride, const B& bins, const int parts, uint64_t* histos, const int begin, const int end){
+    const int count = rows.size();
+    for (int p = begin; p < end; ++p)
+      _histogramRows(rows, width, stride, bins, histos + static_cast<size_t>(p) * bins.m_bins, static_cast<int>(static_cast<long>(count) * p / parts), static_cast<int>(static_cast<long>(count) * (p+1) / parts));
+  }
+
+  /**
+   * @brief Computes the histogram of the given rows.
+   * Large images are split into parts of rows, each of which is histogrammed into a private histogram in a separate thread; the private histograms are summed up at the end.
+   */
+  template <typename T, typename B>
+  void _histogramEngine(const std::vector<const T*>& rows, const int width, const std::ptrdiff_t stride, const B& bins, blitz::Array<uint64_t,1>& histo, const int threads){
+    const int nb_bins = histo.extent(0);
+    const int parts = static_cast<double>(rows.size()) * width >= (1 << 18) ? std::min(getNumberOfThreads(threads), static_cast<int>(rows.size())) : 1;
+    std::vector<uint64_t> histos(std::max(static_cast<size_t>(parts) * nb_bins, static_cast<size_t>(1)), 0);
+    if (width && !rows.empty()){
+      if (parts == 1)
+        _histogramRows(rows, width, stride, bins, &histos[0], 0, rows.size());
+      else {
+        try {
+          parallelFor(parts, parts, boost::bind(&_histogramParts<T,B>, boost::cref(rows), width, stride, boost::cref(bins), parts, &histos[0], _1, _2));
+        } catch (std::runtime_error&) {
+          // several parts might have found pixels out of range; re-run sequentially to report the first one
+          _histogramRows(rows, width, stride, bins, &histos[0], 0, rows.size());
+          throw;
+        }
+      }
+    }
+
+    for (int b = 0; b < nb_bins; ++b){
+      uint64_t sum = 0;
+      for (int p = 0; p < parts; ++p) sum += histos[static_cast<size_t>(p) * nb_bins + b];
+      histo(b) = sum;
+    }
+  }
+
+  /** collects the pointers to the rows of the given image */
+  template <typename T>
+  std::vector<const T*> _histogramRowPointers(const blitz::Array<T,2>& src){
+    std::vector<const T*> rows;
+    if (src.extent(1))
+      for (int y = src.lbound(0); y <= src.ubound(0); ++y)
+        rows.push_back(&src(y, src.lbound(1)));
+    return rows;
+  }
+
+  /** collects the pointers to the rows of all images of the given stack */
+  template <typename T>
+  std::vector<const T*> _histogramRowPointers(const blitz::Array<T,3>& src){
+    std::vector<const T*> rows;
+    if (src.extent(2))
+      for (int z = src.lbound(0); z <= src.ubound(0); ++z)
+        for (int y = src.lbound(1); y <= src.ubound(1); ++y)
+          rows.push_back(&src(z, y, src.lbound(2)));
+    return rows;
+  }
+
+  /** checks that the given type can be histogrammed, with or without specifying a range */
+  template <typename T>
+  void _checkHistogramType(const bool ranged){
     bob::io::base::array::ElementType element_type = bob::io::base::array::getElementType<T>();
 
     // Check that the given type is supported
@@ -47,21 +199,60 @@ namespace bob { namespace ip { namespace base {
       case bob::io::base::array::t_uint64:
         // Valid type
         break;
+      case bob::io::base::array::t_int8:
+      case bob::io::base::array::t_int16:
+      case bob::io::base::array::t_int32:
+      case bob::io::base::array::t_int64:
+      case bob::io::base::array::t_float32:
+      case bob::io::base::array::t_float64:
+      case bob::io::base::array::t_float128:
+        // Valid type, when the range is given
+        if (ranged) break;
+        throw std::runtime_error((boost::format("data type `%s' cannot be histogrammed without specifying a range") % bob::io::base::array::stringize<T>()).str());
       default:
         // Invalid type
+        if (ranged)
+          throw std::runtime_error((boost::format("data type `%s' cannot be histogrammed") % bob::io::base::array::stringize<T>()).str());
         throw std::runtime_error((boost::format("data type `%s' cannot be histogrammed without specifying a range") % bob::io::base::array::stringize<T>()).str());
     }
+  }
 
-    // empty the histogram
-    histo = 0;
+  /**
+   * Compute an histogram of a 2D array.
+   *
+   * @warning This function only accepts arrays of unsigned int (uint8,
+   *          uint16, uint32 and uint64)
+   *          Any other type raises a std::runtime_error exception
+   * @warning You must have @c src(i,j) < @c nb_bins, for every i and j
+   *
+   * @param src source 2D array
+   * @param histo result of the function. This array must have @c nb_bins
+   *              elements
+   * @param threads the number of threads to use for large images; see getNumberOfThreads
+   */
+  template<typename T>
+  void histogram(
+    const blitz::Array<T, 2>& src,
+    blitz::Array<uint64_t, 1>& histo,
+    const int threads = 0
+  ){
+    _checkHistogramType<T>(false);
+    _histogramEngine(_histogramRowPointers(src), src.extent(1), src.stride(1), _DirectBins<T>(histo.extent(0)), histo, threads);
+  }
 
-    unsigned max = histo.extent(0);
-    for (auto it = src.begin(); it != src.end(); ++it){
-      // perform a check that the pixel is in range
-      if ((unsigned)*it >= max)
-        throw std::runtime_error((boost::format("The pixel with value (%d) in the source image is higher than the number of bins (%d)") % (unsigned)*it % (unsigned)max).str());
-      ++histo(*it);
-    }
+  /**
+   * Compute a joint histogram of all images of a 3D stack.
+   *
+   * @see histogram(const blitz::Array<T,2>&, blitz::Array<uint64_t,1>&, const int)
+   */
+  template<typename T>
+  void histogram(
+    const blitz::Array<T, 3>& src,
+    blitz::Array<uint64_t, 1>& histo,
+    const int threads = 0
+  ){
+    _checkHistogramType<T>(false);
+    _histogramEngine(_histogramRowPointers(src), src.extent(2), src.stride(2), _DirectBins<T>(histo.extent(0)), histo, threads);
   }
 
 
@@ -73,71 +264,74 @@ namespace bob { namespace ip { namespace base {
    *          and float128)
    *          Any other type raises a std::runtime_error exception
    * @warning You must have @c min <= @c src(i,j) <= @c max, for every i and j
-   * @warning If @c min >= @c max or @c nb_bins == 0, a
+   * @warning If @c min >= @c max or @c nb_bins == 0, a std::runtime_error
+   *          exception is raised
    *
    * @param src source 2D array
    * @param histo result of the function. This array must have @c nb_bins
    *              elements
    * @param min least possible value in @c src
    * @param max greatest possible value in @c src
+   * @param threads the number of threads to use for large images; see getNumberOfThreads
    */
   template<typename T>
   void histogram(
     const blitz::Array<T, 2>& src,
     blitz::Array<uint64_t, 1>& histo,
     T min,
-    T max
+    T max,
+    const int threads = 0
   ){
-    bob::io::base::array::ElementType element_type = bob::io::base::array::getElementType<T>();
-
-    // Check that the given type is supported
-    switch (element_type) {
-      case bob::io::base::array::t_int8:
-      case bob::io::base::array::t_int16:
-      case bob::io::base::array::t_int32:
-      case bob::io::base::array::t_int64:
-      case bob::io::base::array::t_uint8:
-      case bob::io::base::array::t_uint16:
-      case bob::io::base::array::t_uint32:
-      case bob::io::base::array::t_uint64:
-      case bob::io::base::array::t_float32:
-      case bob::io::base::array::t_float64:
-      case bob::io::base::array::t_float128:
-        // Valid type
-        break;
-      default:
-        // Invalid type
-        throw std::runtime_error((boost::format("data type `%s' cannot be histogrammed") % bob::io::base::array::stringize<T>()).str());
-    }
+    _checkHistogramType<T>(true);
 
     if (max <= min) {
       throw std::runtime_error((boost::format("the `max' value (%1%) should be larger than the `min' value (%2%)") % max % min).str());
     }
+    if (!histo.extent(0)) {
+      throw std::runtime_error("the histogram needs to have at least one bin");
+    }
 
-    // empty the histogram
-    histo = 0;
+    _histogramEngine(_histogramRowPointers(src), src.extent(1), src.stride(1), _RangedBins<T>(min, max, histo.extent(0)), histo, threads);
+  }
 
-    int nb_bins = histo.extent(0);
+  /**
+   * Compute a joint histogram of all images of a 3D stack.
+   *
+   * @see histogram(const blitz::Array<T,2>&, blitz::Array<uint64_t,1>&, T, T, const int)
+   */
+  template<typename T>
+  void histogram(
+    const blitz::Array<T, 3>& src,
+    blitz::Array<uint64_t, 1>& histo,
+    T min,
+    T max,
+    const int threads = 0
+  ){
+    _checkHistogramType<T>(true);
 
-    // Handle the special case nb_bins == 1
-    if (nb_bins == 1) {
-      histo(0) += histo.size();
-      return;
+    if (max <= min) {
+      throw std::runtime_error((boost::format("the `max' value (%1%) should be larger than the `min' value (%2%)") % max % min).str());
+    }
+    if (!histo.extent(0)) {
+      throw std::runtime_error("the histogram needs to have at least one bin");
     }
 
-    double width = max - min;
-    double bin_size = width / static_cast<double>(nb_bins);
+    _histogramEngine(_histogramRowPointers(src), src.extent(2), src.stride(2), _RangedBins<T>(min, max, histo.extent(0)), histo, threads);
+  }
 
-    for(int i = src.lbound(0); i <= src.ubound(0); i++) {
-      for(int j = src.lbound(1); j <= src.ubound(1); j++) {
-        T element = src(i, j);
-        if (element < min || element > max)
-          throw std::runtime_error((boost::format("The pixel with value (%1%) in the source image is not in the given range (%2%, %3%)") % element % min % max).str());
-        // Convert a value into a bin index
-        int index = static_cast<int>((element - min) / bin_size);
-        index = std::min(index, nb_bins-1);
-        ++(histo(index));
-      }
+  /**
+   * @brief Computes the lookup table of a histogram equalization from the given histogram,
+   *   i.e., table[i] = offset + (hist[0] + ... + hist[i]) * range / count.
+   *   The cumulative sums are computed exactly in integers, and they are multiplied with the range before dividing by the count,
+   *   so that the last non-empty bin is mapped exactly to offset + range, when the histogram sums up to count.
+   *   Integral tables are truncated, i.e., rounded down.
+   */
+  template <typename U>
+  void _cumulativeTable(const uint64_t* hist, const int bins, const double range, const uint64_t count, const double offset, U* table){
+    uint64_t sum = 0;
+    for (int i = 0; i < bins; ++i){
+      sum += hist[i];
+      table[i] = static_cast<U>(static_cast<double>(sum) * range / static_cast<double>(count) + offset);
     }
   }
 
@@ -194,31 +388,28 @@ namespace bob { namespace ip { namespace base {
         break;
       default:
         // Invalid type
-          std::runtime_error((boost::format("data type `%s' cannot be the destination of histogram equalization") % bob::io::base::array::stringize<T2>()).str());
+        throw std::runtime_error((boost::format("data type `%s' cannot be the destination of histogram equalization") % bob::io::base::array::stringize<T2>()).str());
     }
     bob::core::array::assertSameShape(src, dst);
 
     // first, compute histogram of the image
-    uint32_t bin_count = std::numeric_limits<T1>::max() + 1;
+    const int bin_count = _lookup_table_size<T1>::value;
     blitz::Array<uint64_t,1> hist(bin_count);
     histogram(src, hist);
 
-    // now, compute the cumulative histogram distribution function
-    blitz::Array<double,1> cdf(bin_count);
+    // now, map the cumulative histogram distribution to the destination range once per gray value
     // -- we don't count the black pixels...
-    double pixel_count = src.size() - hist(0);
-    cdf(0) = 0.;
-    for (uint32_t i = 1; i < bin_count; ++i){
-      cdf(i) = cdf(i-1) + (double)hist(i) / pixel_count;
-    }
+    const uint64_t pixel_count = src.size() - hist(0);
+    hist(0) = 0;
+    std::vector<T2> table(bin_count);
+    if (pixel_count)
+      _cumulativeTable(hist.data(), bin_count, static_cast<double>(dst_max - dst_min), pixel_count, static_cast<double>(dst_min), &table[0]);
+    else
+      // a black image stays black
+      std::fill(table.begin(), table.end(), dst_min);
 
-    // fill the resulting image
-    T2 dst_range = dst_max - dst_min;
-    for (int y = src.lbound(0); y <= src.ubound(0); ++y)
-      for (int x = src.lbound(1); x <= src.ubound(1); ++x){
-        // here, the CDF is indexed by the current pixel value to get
-        dst(y + dst.lbound(0), x + dst.lbound(1)) = static_cast<T2>(cdf(src(y,x)) * dst_range + dst_min);
-    }
+    // fill the resulting image; here, the table is indexed by the current pixel value
+    _apply_lookup_table(src, &table[0], dst);
 
   }
 
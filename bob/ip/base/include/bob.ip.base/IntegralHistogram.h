@@ -0,0 +1,191 @@
+/**
+ * @date Sat Oct 17 21:06:43 CEST 2026
+ *
+ * @brief This file defines a class to compute integral histograms, i.e., the histograms of arbitrary rectangles of an image
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_INTEGRAL_HISTOGRAM_H
+#define BOB_IP_BASE_INTEGRAL_HISTOGRAM_H
+
+#include <vector>
+#include <algorithm>
+#include <bob.core/assert.h>
+
+#include <bob.ip.base/Histogram.h>
+#include <bob.ip.base/Parallel.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class computes the integral histogram of an image, from which the histogram of any rectangle of the image is obtained with four lookups per bin.
+   *
+   * For each bin, the table contains the integral image of the indicator function of this bin, with an extra zero border at the top and the left.
+   * The counts are stored as 32 bit unsigned integers; since the rectangle histograms are computed with modular arithmetic, they are exact for all rectangles with less than 2^32 pixels.
+   *
+   * The table can be stored bin-major (one integral image per bin) or pixel-major (the counts of all bins of one pixel are stored contiguously).
+   * The pixel-major layout is better suited to query many rectangles, since the four lookups of all bins access contiguous memory.
+   */
+  class IntegralHistogram
+  {
+    public:
+
+      /**
+       * @brief Creates an object to compute integral histograms
+       * @param bins The number of bins of the histograms
+       * @param pixel_major Store the counts of all bins of one pixel contiguously, instead of one integral image per bin
+       */
+      IntegralHistogram(const int bins, const bool pixel_major = false);
+
+      /**
+       * @brief Copy constructor
+       */
+      IntegralHistogram(const IntegralHistogram& other);
+
+      /**
+        * @brief Destructor
+        */
+      virtual ~IntegralHistogram() { }
+
+      /**
+       * @brief Assignment operator
+       */
+      IntegralHistogram& operator=(const IntegralHistogram& other);
+
+      /**
+       * @brief Equal to; compares the parameters and the computed tables
+       */
+      bool operator==(const IntegralHistogram& b) const;
+      /**
+       * @brief Not equal to
+       */
+      bool operator!=(const IntegralHistogram& b) const;
+
+      /**
+       * @brief Getters
+       */
+      int getBins() const { return m_bins; }
+      bool getPixelMajor() const { return m_pixel_major; }
+      /** the shape of the image, for which the integral histogram was computed; (0, 0) if none was computed yet */
+      blitz::TinyVector<int,2> getShape() const { return blitz::TinyVector<int,2>(m_height, m_width); }
+
+      /**
+       * @brief Setters; they discard the integral histogram that was computed before
+       */
+      void setBins(const int bins);
+      void setPixelMajor(const bool pixel_major);
+
+      /**
+       * @brief Computes the integral histogram of the given image, using one bin per pixel value.
+       * @warning Only unsigned integral types are accepted, and all pixel values must be lower than the number of bins.
+       * @param src The input image
+       * @param threads The number of threads to use; see getNumberOfThreads
+       */
+      template <typename T>
+      void compute(const blitz::Array<T,2>& src, const int threads = 0){
+        _checkHistogramType<T>(false);
+        computeLabels(src, _DirectBins<T>(m_bins));
+        build(threads);
+      }
+
+      /**
+       * @brief Computes the integral histogram of the given image, using regular bins between the given minimum and maximum value.
+       * @warning All pixel values must be in the range [min, max].
+       * @param src The input image
+       * @param min The least possible value in the image
+       * @param max The greatest possible value in the image
+       * @param threads The number of threads to use; see getNumberOfThreads
+       */
+      template <typename T>
+      void compute(const blitz::Array<T,2>& src, const T min, const T max, const int threads = 0){
+        _checkHistogramType<T>(true);
+        if (max <= min)
+          throw std::runtime_error((boost::format("the `max' value (%1%) should be larger than the `min' value (%2%)") % max % min).str());
+        computeLabels(src, _RangedBins<T>(min, max, m_bins));
+        build(threads);
+      }
+
+      /**
+       * @brief Computes the histogram of the given rectangle of the image
+       * @param top, left The upper left pixel of the rectangle
+       * @param height, width The size of the rectangle; empty rectangles are allowed
+       * @param dst The histogram, which must have as many elements as there are bins
+       */
+      void histogram(const int top, const int left, const int height, const int width, blitz::Array<uint64_t,1>& dst) const;
+
+      /**
+       * @brief Computes the histograms of several rectangles at once
+       * @param rectangles The rectangles, one per row, as (top, left, height, width)
+       * @param dst The histograms, one per row
+       * @param threads The number of threads to use; see getNumberOfThreads
+       */
+      void histograms(const blitz::Array<int32_t,2>& rectangles, blitz::Array<uint64_t,2>& dst, const int threads = 0) const;
+
+    private:
+
+      /**
+       * @brief Computes the bin indices of all pixels of the given image
+       */
+      template <typename T, typename B>
+      void computeLabels(const blitz::Array<T,2>& src, const B& bins){
+        if (m_bins < 1)
+          throw std::runtime_error("the histogram needs to have at least one bin");
+        const int height = src.extent(0), width = src.extent(1);
+        // do not keep an old table in case of errors
+        m_height = m_width = 0;
+        m_table.clear();
+        m_labels.resize(static_cast<size_t>(height) * width);
+        for (int y = 0; y < height; ++y){
+          const T* s = width ? &src(src.lbound(0) + y, src.lbound(1)) : 0;
+          int* l = m_labels.data() + static_cast<size_t>(y) * width;
+          for (int x = 0; x < width; x += _histogram_chunk){
+            const int n = std::min(_histogram_chunk, width - x);
+            if (!bins.check(s + x * src.stride(1), n, src.stride(1))) bins.raise(s + x * src.stride(1), n, src.stride(1));
+            bins.index(s + x * src.stride(1), n, src.stride(1), l + x);
+          }
+        }
+        m_height = height;
+        m_width = width;
+      }
+
+      /**
+       * @brief Computes the table from the bin indices
+       */
+      void build(const int threads);
+
+      /**
+       * @brief Computes the integral images of the bins [begin, end)
+       */
+      void buildBins(const int begin, const int end);
+
+      /**
+       * @brief Checks that the given rectangle lies inside the image
+       */
+      void checkRectangle(const int top, const int left, const int height, const int width) const;
+
+      /**
+       * @brief Computes the histogram of one rectangle, which must have been checked before
+       */
+      void rectangleHistogram(const int top, const int left, const int height, const int width, uint64_t* dst, const std::ptrdiff_t dst_stride) const;
+
+      /**
+       * @brief Computes the histograms of the rectangles [begin, end), which must have been checked before
+       */
+      void histogramRange(const std::vector<const int32_t*>& rectangles, const std::ptrdiff_t rectangle_stride, const std::vector<uint64_t*>& dst, const std::ptrdiff_t dst_stride, const int begin, const int end) const;
+
+      // parameters
+      int m_bins;
+      bool m_pixel_major;
+
+      // the integral histogram
+      int m_height, m_width;
+      std::vector<uint32_t> m_table;
+
+      // workspace
+      std::vector<int> m_labels;
+  };
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_INTEGRAL_HISTOGRAM_H
@@ -10,10 +10,135 @@
 #ifndef BOB_IP_BASE_INTEGRAL_IMAGE_H
 #define BOB_IP_BASE_INTEGRAL_IMAGE_H
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <boost/bind.hpp>
 #include <bob.core/assert.h>
 #include <bob.core/array_index.h>
+#include <bob.ip.base/Parallel.h>
 
 namespace bob { namespace ip { namespace base {
+
+    /** The number of columns that are accumulated together in the vertical pass of the parallel integral image */
+    static const int _integral_block = 256;
+
+    /**
+      * @brief Computes the prefix sums of one row in type A, and adds them to the previous row of the integral image, if given.
+      *   The squared prefix sums are computed as well, if squared is enabled.
+      */
+    template<typename T, typename U, typename A, bool squared>
+    inline void _integral_row(const T* s, U* d, U* q, const U* d_prev, const U* q_prev, const int width, const std::ptrdiff_t sx, const std::ptrdiff_t dx, const std::ptrdiff_t qx)
+    {
+      A row_sum_cur = 0, row_sum_sqr = 0;
+      for(int x=0; x<width; ++x)
+      {
+        const A v = static_cast<A>(s[x*sx]);
+        row_sum_cur += v;
+        d[x*dx] = d_prev ? d_prev[x*dx] + static_cast<U>(row_sum_cur) : static_cast<U>(row_sum_cur);
+        if (squared){
+          row_sum_sqr += v*v;
+          q[x*qx] = q_prev ? q_prev[x*qx] + static_cast<U>(row_sum_sqr) : static_cast<U>(row_sum_sqr);
+        }
+      }
+    }
+
+    /**
+      * @brief Computes the row prefix sums of the rows [begin, end) (and the ones of the previous rows, if cumulative is enabled).
+      */
+    template<typename T, typename U, typename A, bool squared>
+    void _integral_rows(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const bool cumulative, const int begin, const int end)
+    {
+      const int width = src.extent(1);
+      const std::ptrdiff_t sx = src.stride(1), dx = dst.stride(1), qx = sqr.stride(1), dy = dst.stride(0), qy = sqr.stride(0);
+      const bool contiguous = sx == 1 && dx == 1 && qx == 1;
+      for(int y=begin; y<end; ++y)
+      {
+        U* d = &dst(y,0);
+        U* q = &sqr(y,0);
+        const U* d_prev = cumulative && y ? d - dy : 0;
+        const U* q_prev = cumulative && y ? q - qy : 0;
+        // the contiguous case is written separately, so that the compiler can optimize it for unit strides
+        if (contiguous)
+          _integral_row<T,U,A,squared>(&src(y,0), d, q, d_prev, q_prev, width, 1, 1, 1);
+        else
+          _integral_row<T,U,A,squared>(&src(y,0), d, q, d_prev, q_prev, width, sx, dx, qx);
+      }
+    }
+
+    /**
+      * @brief Accumulates the row prefix sums vertically for the column blocks [begin, end).
+      */
+    template<typename U, bool squared>
+    void _integral_columns(blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const int begin, const int end)
+    {
+      const int height = dst.extent(0), width = dst.extent(1);
+      const std::ptrdiff_t dy = dst.stride(0), dx = dst.stride(1), qy = sqr.stride(0), qx = sqr.stride(1);
+      for(int block=begin; block<end; ++block)
+      {
+        const int first = block * _integral_block, n = std::min(_integral_block, width - first);
+        U* d = &dst(0,first);
+        U* q = &sqr(0,first);
+        for(int y=1; y<height; ++y)
+        {
+          d += dy;
+          for(int i=0; i<n; ++i)
+            d[i*dx] = d[i*dx-dy] + d[i*dx];
+          if (squared){
+            q += qy;
+            for(int i=0; i<n; ++i)
+              q[i*qx] = q[i*qx-qy] + q[i*qx];
+          }
+        }
+      }
+    }
+
+    /**
+      * @brief Computes the integral image, where the row prefix sums are accumulated in type A.
+      *   With several threads, it is computed in two passes, i.e., the row prefix sums are computed in parallel for blocks of rows,
+      *   and afterwards they are accumulated vertically in parallel for blocks of columns.
+      *   In any case, the additions are the same as in the sequential computation, so that the results do not depend on the number of threads.
+      */
+    template<typename T, typename U, typename A, bool squared>
+    void _integral_engine(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const int threads)
+    {
+      if (!src.extent(0) || !src.extent(1)) return;
+      // small images are processed in a single pass in the current thread
+      if (src.numElements() < (1u<<18) || getNumberOfThreads(threads) == 1){
+        _integral_rows<T,U,A,squared>(src, dst, sqr, true, 0, src.extent(0));
+        return;
+      }
+      parallelFor(src.extent(0), threads, boost::bind(&_integral_rows<T,U,A,squared>, boost::cref(src), boost::ref(dst), boost::ref(sqr), false, _1, _2));
+      const int blocks = (src.extent(1) + _integral_block - 1) / _integral_block;
+      parallelFor(blocks, threads, boost::bind(&_integral_columns<U,squared>, boost::ref(dst), boost::ref(sqr), _1, _2));
+    }
+
+    /**
+      * @brief Selects the accumulator of the row prefix sums.
+      *   The rows of unsigned 8 and 16 bit integral images are accumulated in uint32_t, when the integral image has a 64 bit type and its largest possible value fits into 32 bit,
+      *   e.g., for uint8 images with up to 16M pixels.
+      *   Since all values are exact, the result is identical to the accumulation in the type of the integral image.
+      */
+    template<typename T, typename U, bool squared,
+             bool narrow = std::numeric_limits<T>::is_integer && !std::numeric_limits<T>::is_signed && sizeof(T) <= 2 && sizeof(U) == 8>
+    struct _Integral {
+      static void compute(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const int threads){
+        _integral_engine<T,U,U,squared>(src, dst, sqr, threads);
+      }
+    };
+
+    template<typename T, typename U, bool squared>
+    struct _Integral<T,U,squared,true> {
+      static void compute(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const int threads){
+        const double max_value = static_cast<double>(std::numeric_limits<T>::max());
+        const double max_sum = static_cast<double>(src.numElements()) * (squared ? max_value * max_value : max_value);
+        if (max_sum <= static_cast<double>(std::numeric_limits<uint32_t>::max()))
+          _integral_engine<T,U,uint32_t,squared>(src, dst, sqr, threads);
+        else
+          _integral_engine<T,U,U,squared>(src, dst, sqr, threads);
+      }
+    };
+
     /**
       * @brief Function which computes the integral image of a 2D
       *   blitz::array/image of a given type.
@@ -22,25 +147,12 @@ namespace bob { namespace ip { namespace base {
       * @warning No check is performed wrt. the array dimensions.
       * @param src The input image
       * @param dst The output integral image
+      * @param threads The number of threads to use for large images; see getNumberOfThreads
       */
     template<typename T, typename U>
-    void integral_(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst)
+    void integral_(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const int threads=0)
     {
-      dst(0,0) = static_cast<U>(src(0,0));
-      // Compute first row
-      for(int x=1; x<src.extent(1); ++x)
-        dst(0,x) = dst(0,x-1) + static_cast<U>(src(0,x));
-      // Compute remaining part
-      for(int y=1; y<src.extent(0); ++y)
-      {
-        dst(y,0) = dst(y-1,0) + static_cast<U>(src(y,0));
-        U row_sum_cur = src(y,0);
-        for(int x=1; x<src.extent(1); ++x)
-        {
-          row_sum_cur += static_cast<U>(src(y,x));
-          dst(y,x) = dst(y-1,x) + row_sum_cur;
-        }
-      }
+      _Integral<T,U,false>::compute(src, dst, dst, threads);
     }
 
 
@@ -57,9 +169,10 @@ namespace bob { namespace ip { namespace base {
     * @param addZeroBorder This requires the dst array to be 1 pixel
     *   larger in each dimension. Besides, an extra zero pixel will be
     *   added at the beginning of each row and column
+    * @param threads The number of threads to use for large images; see getNumberOfThreads
     */
   template<typename T, typename U>
-  void integral(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const bool addZeroBorder=false)
+  void integral(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const bool addZeroBorder=false, const int threads=0)
   {
     // Checks that the src/dst arrays have zero base indices
     bob::core::array::assertZeroBase(src);
@@ -82,54 +195,27 @@ namespace bob { namespace ip { namespace base {
         dst(0,x) = 0;
       blitz::Array<U,2> dst_c =
         dst(blitz::Range(1,src.extent(0)), blitz::Range(1,src.extent(1)));
-      integral_(src, dst_c);
+      integral_(src, dst_c, threads);
     }
     else
-      integral_(src, dst);
+      integral_(src, dst, threads);
   }
 
 
   /**
     * @brief Function which computes the integral image and the
     *   integral square image of a 2D blitz::array/image of a given type.
+    *   Both images are computed in the same pass.
     * @warning No check is performed wrt. the array dimensions.
     * @param src The input image
     * @param dst The output integral image
     * @param sqr The output integral square image
+    * @param threads The number of threads to use for large images; see getNumberOfThreads
     */
   template<typename T, typename U>
-  void integral_(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr)
+  void integral_(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const int threads=0)
   {
-    const U v = static_cast<U>(src(0,0));
-    dst(0,0) = v;
-    sqr(0,0) = v*v;
-
-    // Compute first row
-    for(int x=1; x<src.extent(1); ++x){
-      const U v = static_cast<U>(src(0,x));
-      dst(0,x) = dst(0,x-1) + v;
-      sqr(0,x) = sqr(0,x-1) + v*v;
-    }
-
-    // Compute remaining part
-    for(int y=1; y<src.extent(0); ++y)
-    {
-      U row_sum_cur = static_cast<U>(src(y,0));
-      U row_sum_sqr = row_sum_cur * row_sum_cur;
-
-      dst(y,0) = dst(y-1,0) + row_sum_cur;
-      sqr(y,0) = sqr(y-1,0) + row_sum_sqr;
-
-      for(int x=1; x<src.extent(1); ++x)
-      {
-        const U v = static_cast<U>(src(y,x));
-        row_sum_cur += v;
-        row_sum_sqr += v*v;
-
-        dst(y,x) = dst(y-1,x) + row_sum_cur;
-        sqr(y,x) = sqr(y-1,x) + row_sum_sqr;
-      }
-    }
+    _Integral<T,U,true>::compute(src, dst, sqr, threads);
   }
 
   /**
@@ -144,9 +230,10 @@ namespace bob { namespace ip { namespace base {
     * @param addZeroBorder This requires the dst and sqr arrays to be 1
     *   pixel larger in each dimension. Besides, an extra zero pixel will
     *   be added at the beginning of each row and column
+    * @param threads The number of threads to use for large images; see getNumberOfThreads
     */
   template<typename T, typename U>
-  void integral(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const bool addZeroBorder=false)
+  void integral(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, blitz::Array<U,2>& sqr, const bool addZeroBorder=false, const int threads=0)
   {
     // Checks that the src/dst arrays have zero base indices
     bob::core::array::assertZeroBase(src);
@@ -174,10 +261,74 @@ namespace bob { namespace ip { namespace base {
         dst(blitz::Range(1,src.extent(0)), blitz::Range(1,src.extent(1)));
       blitz::Array<U,2> sqr_c =
         sqr(blitz::Range(1,src.extent(0)), blitz::Range(1,src.extent(1)));
-      integral_(src, dst_c, sqr_c);
+      integral_(src, dst_c, sqr_c, threads);
     }
     else
-      integral_(src, dst, sqr);
+      integral_(src, dst, sqr, threads);
+  }
+
+
+  /**
+    * @brief Function which computes the tilted (45 degree rotated) integral
+    *   image of a 2D blitz::array/image of a given type, i.e.:
+    *   dst(Y,X) = sum of src(y,x) for all y < Y and |x - X + 1| <= Y - y - 1
+    *   This is, each pixel of dst contains the sum of the triangle of
+    *   pixels above the pixel at (Y-1, X-1), which is clipped at the image
+    *   boundaries.
+    *   The sum over a rectangle that is rotated by 45 degrees, i.e., over
+    *   all pixels (y',x') with 0 <= (y'-y)+(x'-x) < 2w and
+    *   0 <= (y'-y)-(x'-x) < 2h, which has its top corner at pixel (y,x),
+    *   is then given by:
+    *   dst(y+w+h, x-h+w+1) - dst(y+w, x+w+1) - dst(y+h, x-h+1) + dst(y, x+1)
+    * @warning It is the user responsibility to select a suitable type
+    *   for the destination array.
+    * @param src The input image
+    * @param dst The output tilted integral image, which needs to be 1 pixel
+    *   larger than src in each dimension
+    */
+  template<typename T, typename U>
+  void tiltedIntegral(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst)
+  {
+    // Checks that the src/dst arrays have zero base indices
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    blitz::TinyVector<int,2> shape = src.shape();
+    shape += 1;
+    bob::core::array::assertSameShape(dst,shape);
+
+    const int height = src.extent(0), width = src.extent(1);
+    for(int x=0; x<=width; ++x)
+      dst(0,x) = 0;
+    if (!width) {
+      for(int y=1; y<=height; ++y)
+        dst(y,0) = 0;
+      return;
+    }
+
+    // The triangle of each pixel is the difference of two sums over the row prefix sums P(y,c) = sum_{x<=c} src(y,x):
+    //   dst(Y,X) = sum_{y<Y} P(y, X+Y-2-y) - sum_{y<Y} P(y, X-Y-1+y),
+    // where the column indices c are clipped to [-1, width-1] with P(y,-1) = 0.
+    // Both sums are accumulated row by row along the diagonals s = X+Y-2 and t = X-Y-1 of the current Y.
+    std::vector<U> prefix(width), diag_s(width+height+1, U(0)), diag_t(width+height+1, U(0));
+    for(int Y=1; Y<=height; ++Y)
+    {
+      const int y = Y-1;
+      U sum = 0;
+      for(int x=0; x<width; ++x)
+      {
+        sum += static_cast<U>(src(y,x));
+        prefix[x] = sum;
+      }
+      // diag_s[i] belongs to s = i-2 and adds P(y, s-y); diag_t[i] belongs to t = i-height-1 and adds P(y, t+y)
+      for(int i=0; i<(int)diag_s.size(); ++i)
+      {
+        const int c_s = std::min(i - 2 - y, width - 1), c_t = std::min(i - height - 1 + y, width - 1);
+        if (c_s >= 0) diag_s[i] += prefix[c_s];
+        if (c_t >= 0) diag_t[i] += prefix[c_t];
+      }
+      for(int X=0; X<=width; ++X)
+        dst(Y,X) = diag_s[X+Y] - diag_t[X-Y+height];
+    }
   }
 
 } } } // namespaces
@@ -0,0 +1,135 @@
+/**
+ * @date Sat Oct 17 16:12:40 CEST 2026
+ *
+ * This file defines lookup tables that evaluate pointwise functions of 8 and 16 bit images once per gray value
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_LOOKUP_TABLE_H
+#define BOB_IP_BASE_LOOKUP_TABLE_H
+
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+#include <blitz/array.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /** The number of entries of a lookup table that covers all values of type T; 0 if no lookup table should be used for T */
+  template <typename T> struct _lookup_table_size { static const int value = 0; };
+  template <> struct _lookup_table_size<uint8_t> { static const int value = 256; };
+  template <> struct _lookup_table_size<uint16_t> { static const int value = 65536; };
+
+  /** The power-law function x^gamma used by the gamma correction */
+  struct _GammaFunction {
+    _GammaFunction(const double gamma = 1.) : m_gamma(gamma) {}
+    double operator()(const double x) const { return std::pow(x, m_gamma); }
+    bool operator==(const _GammaFunction& other) const { return m_gamma == other.m_gamma; }
+    double m_gamma;
+  };
+
+  /** The function log(1+x) used to compress the dynamic range of images */
+  struct _LogPlusOne {
+    double operator()(const double x) const { return std::log(1. + x); }
+    bool operator==(const _LogPlusOne&) const { return true; }
+  };
+
+  /**
+   * @brief Replaces each pixel of src by table[src(y,x)]
+   * @param src The 2D input image with values in [0, table size)
+   * @param table The lookup table
+   * @param dst The 2D output image of the same shape as src
+   */
+  template <typename T, typename U>
+  void _apply_lookup_table(const blitz::Array<T,2>& src, const U* table, blitz::Array<U,2>& dst){
+    const int height = src.extent(0), width = src.extent(1);
+    if (!width) return;
+    for (int y = 0; y < height; ++y){
+      const int ys = y + src.lbound(0), yd = y + dst.lbound(0);
+      if (src.stride(1) == 1 && dst.stride(1) == 1){
+        // contiguous rows are gathered with plain pointers
+        const T* s = &src(ys, src.lbound(1));
+        U* d = &dst(yd, dst.lbound(1));
+        for (int x = 0; x < width; ++x) d[x] = table[static_cast<int>(s[x])];
+      } else {
+        for (int x = 0; x < width; ++x) dst(yd, x + dst.lbound(1)) = table[static_cast<int>(src(ys, x + src.lbound(1)))];
+      }
+    }
+  }
+
+  /**
+   * @brief Evaluates the given function for each pixel
+   * @param src The 2D input image
+   * @param function The function to evaluate
+   * @param dst The 2D output image of the same shape as src
+   */
+  template <typename T, typename F>
+  void _evaluate_pointwise(const blitz::Array<T,2>& src, const F& function, blitz::Array<double,2>& dst){
+    for (int y = 0; y < src.extent(0); ++y)
+      for (int x = 0; x < src.extent(1); ++x)
+        dst(y + dst.lbound(0), x + dst.lbound(1)) = function(static_cast<double>(src(y + src.lbound(0), x + src.lbound(1))));
+  }
+
+  /**
+   * @brief Applies a pointwise function to an image.
+   * For uint8 and uint16 images, the function is evaluated once per gray value into a lookup table, if the image has at least as many pixels as the table has entries.
+   * Otherwise, the function is evaluated for each pixel.
+   * @param src The 2D input image
+   * @param function The function to evaluate
+   * @param dst The 2D output image of the same shape as src
+   */
+  template <typename T, typename F>
+  void pointwiseTransform(const blitz::Array<T,2>& src, const F& function, blitz::Array<double,2>& dst){
+    const int size = _lookup_table_size<T>::value;
+    if (!size || src.numElements() < (size_t)size){
+      _evaluate_pointwise(src, function, dst);
+      return;
+    }
+    std::vector<double> table(size);
+    for (int i = 0; i < size; ++i) table[i] = function(static_cast<double>(i));
+    _apply_lookup_table(src, &table[0], dst);
+  }
+
+  /**
+   * @brief This class applies a pointwise function to images and keeps the lookup table of the last function for the next image.
+   * For uint8 and uint16 images, the table is rebuilt only when the function changes.
+   * As in pointwiseTransform, no new table is built for images with fewer pixels than the table has entries, but an existing table of the same function is still used.
+   * For other types, the function is evaluated for each pixel.
+   */
+  template <typename F>
+  class LookupTable {
+    public:
+      /**
+       * @brief Applies the given function to src
+       * @param src The 2D input image
+       * @param function The function to evaluate
+       * @param dst The 2D output image of the same shape as src
+       */
+      template <typename T>
+      void transform(const blitz::Array<T,2>& src, const F& function, blitz::Array<double,2>& dst){
+        const int size = _lookup_table_size<T>::value;
+        if (!size){
+          _evaluate_pointwise(src, function, dst);
+          return;
+        }
+        if ((int)m_table.size() != size || !(m_function == function)){
+          if (src.numElements() < (size_t)size){
+            _evaluate_pointwise(src, function, dst);
+            return;
+          }
+          m_table.resize(size);
+          for (int i = 0; i < size; ++i) m_table[i] = function(static_cast<double>(i));
+          m_function = function;
+        }
+        _apply_lookup_table(src, &m_table[0], dst);
+      }
+
+    private:
+      F m_function;
+      std::vector<double> m_table;
+  };
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_LOOKUP_TABLE_H
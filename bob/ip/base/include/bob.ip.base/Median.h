@@ -12,11 +12,238 @@
 
 #include <vector>
 #include <algorithm>
+#include <stdint.h>
+#include <boost/bind.hpp>
 #include <bob.core/assert.h>
 #include <bob.core/cast.h>
+#include <bob.ip.base/Parallel.h>
 
 namespace bob { namespace ip { namespace base {
 
+  /** Median selection network for 9 elements; after applying the compare-exchange operations, element 4 is the median */
+  static const int _median_network_9[19][2] = {
+    {1,2},{4,5},{7,8},{0,1},{3,4},{6,7},{1,2},{4,5},{7,8},{0,3},{5,8},{4,7},{3,6},{1,4},{2,5},{4,7},{4,2},{6,4},{4,2}
+  };
+
+  /** Median selection network for 25 elements; after applying the compare-exchange operations, element 12 is the median */
+  static const int _median_network_25[99][2] = {
+    {0,1},{3,4},{2,4},{2,3},{6,7},{5,7},{5,6},{9,10},{8,10},{8,9},{12,13},{11,13},{11,12},{15,16},{14,16},{14,15},{18,19},{17,19},{17,18},{21,22},
+    {20,22},{20,21},{23,24},{2,5},{3,6},{0,6},{0,3},{4,7},{1,7},{1,4},{11,14},{8,14},{8,11},{12,15},{9,15},{9,12},{13,16},{10,16},{10,13},{20,23},
+    {17,23},{17,20},{21,24},{18,24},{18,21},{19,22},{8,17},{9,18},{0,18},{0,9},{10,19},{1,19},{1,10},{11,20},{2,20},{2,11},{12,21},{3,21},{3,12},{13,22},
+    {4,22},{4,13},{14,23},{5,23},{5,14},{15,24},{6,24},{6,15},{7,16},{7,19},{13,21},{15,23},{7,13},{7,15},{1,9},{3,11},{5,17},{11,17},{9,17},{4,10},
+    {6,12},{7,14},{4,6},{4,7},{12,14},{10,14},{6,7},{10,12},{6,10},{6,17},{12,17},{7,17},{7,10},{12,18},{7,12},{10,18},{12,20},{10,20},{10,12}
+  };
+
+  /**
+   * @brief Computes the median of all (W x W) windows with a median selection network.
+   * The network is applied to chunks of pixels of the same row at once, i.e., each compare-exchange is a branch-free min/max loop over the chunk, which the compiler vectorizes.
+   */
+  template <typename T, int W, int K>
+  void _medianNetwork(
+    const blitz::Array<T,2>& src,
+    blitz::Array<T,2>& dst,
+    const int (&network)[K][2]
+  ){
+    static const int chunk = 256;
+    const int src_stride = src.stride(1);
+    std::vector<T> buffer(W * W * chunk);
+    for (int y = 0; y < dst.extent(0); ++y)
+      for (int x0 = 0; x0 < dst.extent(1); x0 += chunk){
+        const int n = std::min(chunk, dst.extent(1) - x0);
+        // copy the pixels of each window position into a separate line of the buffer
+        for (int dy = 0; dy < W; ++dy)
+          for (int dx = 0; dx < W; ++dx){
+            const T* s = &src(y + dy, x0 + dx);
+            T* b = &buffer[(dy * W + dx) * chunk];
+            for (int i = 0; i < n; ++i) b[i] = s[i * src_stride];
+          }
+        // sort the lines pairwise
+        for (int k = 0; k < K; ++k){
+          T* a = &buffer[network[k][0] * chunk];
+          T* b = &buffer[network[k][1] * chunk];
+          for (int i = 0; i < n; ++i){
+            const T lower = std::min(a[i], b[i]);
+            b[i] = std::max(a[i], b[i]);
+            a[i] = lower;
+          }
+        }
+        const T* median = &buffer[(W * W / 2) * chunk];
+        for (int i = 0; i < n; ++i) dst(y, x0 + i) = median[i];
+      }
+  }
+
+  /**
+   * @brief Computes the median of each window by partially sorting its pixels.
+   * This works for any data type and any radius, but costs O(r^2) per pixel.
+   */
+  template <typename T>
+  void _medianSelect(
+    const blitz::Array<T,2>& src,
+    blitz::Array<T,2>& dst,
+    const blitz::TinyVector<int,2>& radius
+  ){
+    // compute centeral pixel
+    const int center = (2*radius[0]+1)*(2*radius[1]+1)/2;
+    std::vector<T> _temp((2*radius[0]+1)*(2*radius[1]+1));
+    // iterate over the destination array
+    for (int y = 0; y < dst.extent(0); ++y)
+      for (int x = 0; x < dst.extent(1); ++x){
+        // copy the pixels of the window
+        typename std::vector<T>::iterator it = _temp.begin();
+        for (int dy = 0; dy <= 2 * radius[0]; ++dy)
+          for (int dx = 0; dx <= 2 * radius[1]; ++dx)
+            *it++ = src(y + dy, x + dx);
+        // move the central element to its position
+        std::nth_element(_temp.begin(), _temp.begin() + center, _temp.end());
+        dst(y,x) = _temp[center];
+    }
+  }
+
+  /**
+   * @brief Computes the median with histograms of the pixel values, which is implemented for integral types only.
+   * min_size is the smallest window size, for which the histogram is faster than _medianSelect.
+   */
+  template <typename T>
+  struct _MedianHistogram {
+    static const int min_size = 0;
+    static void apply(const blitz::Array<T,2>&, blitz::Array<T,2>&, const blitz::TinyVector<int,2>&){
+      throw std::runtime_error("median filtering with histograms is only implemented for uint8 and uint16 images");
+    }
+  };
+
+  /**
+   * @brief Median filter in constant time per pixel, as proposed by Perreault and Hebert in
+   *   "Median Filtering in Constant Time", IEEE Transactions on Image Processing 16(9), 2007.
+   * A histogram for each column of the window is updated when moving down one row.
+   * The kernel histogram is updated from the column histograms when moving right one pixel.
+   * The histograms have two levels with 16 bins each; the fine level of the kernel histogram is only updated for the bin that contains the median.
+   */
+  template <>
+  struct _MedianHistogram<uint8_t> {
+    static const int min_size = 26;
+    static void apply(const blitz::Array<uint8_t,2>& src, blitz::Array<uint8_t,2>& dst, const blitz::TinyVector<int,2>& radius){
+      const int width = src.extent(1);
+      const int window_y = 2*radius[0]+1, window_x = 2*radius[1]+1;
+      const int center = window_y*window_x/2;
+      // the column histograms, initialized with the first window_y rows
+      std::vector<int> coarse(width*16), fine(width*256);
+      for (int x = 0; x < width; ++x)
+        for (int y = 0; y < window_y; ++y){
+          const int v = src(y,x);
+          ++coarse[x*16 + (v>>4)];
+          ++fine[x*256 + v];
+        }
+      // the kernel histograms; for each coarse bin, valid stores the window position that the fine bins were computed for
+      int kernel_coarse[16], kernel_fine[256], valid[16];
+      for (int y = 0; y < dst.extent(0); ++y){
+        if (y){
+          // move the column histograms down
+          for (int x = 0; x < width; ++x){
+            const int v = src(y-1,x), w = src(y-1+window_y,x);
+            --coarse[x*16 + (v>>4)]; --fine[x*256 + v];
+            ++coarse[x*16 + (w>>4)]; ++fine[x*256 + w];
+          }
+        }
+        std::fill(kernel_coarse, kernel_coarse + 16, 0);
+        for (int x = 0; x < window_x; ++x)
+          for (int c = 0; c < 16; ++c)
+            kernel_coarse[c] += coarse[x*16 + c];
+        std::fill(valid, valid + 16, -window_x);
+
+        for (int x = 0; x < dst.extent(1); ++x){
+          if (x){
+            const int* removed = &coarse[(x-1)*16], * added = &coarse[(x-1+window_x)*16];
+            for (int c = 0; c < 16; ++c) kernel_coarse[c] += added[c] - removed[c];
+          }
+          // find the coarse bin that contains the median
+          int c = 0, count = 0;
+          while (count + kernel_coarse[c] <= center) count += kernel_coarse[c++];
+          // bring the fine bins of that coarse bin up to date
+          int* kernel = &kernel_fine[c*16];
+          if (x - valid[c] >= window_x){
+            std::fill(kernel, kernel + 16, 0);
+            for (int xx = x; xx < x + window_x; ++xx){
+              const int* column = &fine[xx*256 + c*16];
+              for (int f = 0; f < 16; ++f) kernel[f] += column[f];
+            }
+          } else {
+            for (int xx = valid[c]; xx < x; ++xx){
+              const int* removed = &fine[xx*256 + c*16], * added = &fine[(xx+window_x)*256 + c*16];
+              for (int f = 0; f < 16; ++f) kernel[f] += added[f] - removed[f];
+            }
+          }
+          valid[c] = x;
+          // find the median in the fine bins
+          int f = 0;
+          while (count + kernel[f] <= center) count += kernel[f++];
+          dst(y,x) = static_cast<uint8_t>(c*16 + f);
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Median filter with a sliding kernel histogram, as proposed by Huang, Yang and Tang in
+   *   "A fast two-dimensional median filtering algorithm", IEEE Transactions on Acoustics, Speech, and Signal Processing 27(1), 1979.
+   * The window moves through the image in a serpentine order, so that only one row or column of pixels is exchanged per step.
+   * The histogram has two levels with 256 bins each, so that the median is found in at most 512 steps.
+   */
+  template <>
+  struct _MedianHistogram<uint16_t> {
+    static const int min_size = 81;
+    static void apply(const blitz::Array<uint16_t,2>& src, blitz::Array<uint16_t,2>& dst, const blitz::TinyVector<int,2>& radius){
+      const int window_y = 2*radius[0]+1, window_x = 2*radius[1]+1;
+      const int center = window_y*window_x/2;
+      std::vector<int> coarse(256), fine(65536);
+      for (int y = 0; y < window_y; ++y)
+        for (int x = 0; x < window_x; ++x){
+          const int v = src(y,x);
+          ++coarse[v>>8]; ++fine[v];
+        }
+      for (int y = 0; y < dst.extent(0); ++y){
+        const bool forward = !(y % 2);
+        const int first = forward ? 0 : dst.extent(1) - 1;
+        if (y){
+          // move the window down
+          for (int x = first; x < first + window_x; ++x){
+            const int v = src(y-1,x), w = src(y-1+window_y,x);
+            --coarse[v>>8]; --fine[v];
+            ++coarse[w>>8]; ++fine[w];
+          }
+        }
+        for (int i = 0; i < dst.extent(1); ++i){
+          const int x = forward ? i : dst.extent(1) - 1 - i;
+          if (i){
+            // move the window horizontally
+            const int removed = forward ? x - 1 : x + window_x, added = forward ? x - 1 + window_x : x;
+            for (int yy = y; yy < y + window_y; ++yy){
+              const int v = src(yy,removed), w = src(yy,added);
+              --coarse[v>>8]; --fine[v];
+              ++coarse[w>>8]; ++fine[w];
+            }
+          }
+          int c = 0, count = 0;
+          while (count + coarse[c] <= center) count += coarse[c++];
+          const int* kernel = &fine[c*256];
+          int f = 0;
+          while (count + kernel[f] <= center) count += kernel[f++];
+          dst(y,x) = static_cast<uint16_t>(c*256 + f);
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Performs a median filtering of the given image.
+   * Only the pixels, for which the whole window is inside the image, are computed, so that dst is 2*radius pixels smaller than src.
+   * Depending on the data type and the radius, one of these algorithms is used:
+   *  - median selection networks for (3x3) and (5x5) windows
+   *  - histogram based algorithms for larger windows of uint8 and uint16 images
+   *  - partial sorting of the pixels of the window otherwise
+   * @param src The 2D input image
+   * @param dst The 2D output image of size src.shape - 2*radius
+   * @param radius The radius of the window in vertical and horizontal direction
+   */
   template <typename T>
   void medianFilter(
     const blitz::Array<T,2>& src,
@@ -28,42 +255,60 @@ namespace bob { namespace ip { namespace base {
     bob::core::array::assertZeroBase(dst);
     blitz::TinyVector<int,2> dst_size(src.extent(0) - 2 * radius[0], src.extent(1) - 2 * radius[1]);
     bob::core::array::assertSameShape(dst, dst_size);
+    if (!dst.extent(0) || !dst.extent(1)) return;
 
-    // compute centeral pixel
-    int center = (2*radius[0]+1)*(2*radius[1]+1)/2;
-    // we only sort the first half of the sequence (this is all we need)
-    std::vector<T> _temp(center+1);
-    // iterate over the destination array
-    for (int y = 0; y < dst_size[0]; ++y)
-      for (int x = 0; x < dst_size[1]; ++x){
-        // get a slice from the src array
-        const blitz::Array<T,2> slice(src(blitz::Range(y, y + 2 * radius[0]), blitz::Range(x, x + 2 * radius[1])));
-        // compute the median
-        // we only sort the first half of the sequence
-        std::partial_sort_copy(slice.begin(), slice.end(), _temp.begin(), _temp.end());
-        // get the central element
-        dst(y,x) = _temp[center];
-    }
+    const int size = (2*radius[0]+1)*(2*radius[1]+1);
+    if (radius[0] == 1 && radius[1] == 1)
+      _medianNetwork<T,3>(src, dst, _median_network_9);
+    else if (radius[0] == 2 && radius[1] == 2)
+      _medianNetwork<T,5>(src, dst, _median_network_25);
+    else if (_MedianHistogram<T>::min_size && size >= _MedianHistogram<T>::min_size)
+      _MedianHistogram<T>::apply(src, dst, radius);
+    else
+      _medianSelect(src, dst, radius);
   }
 
 
+  /** filters the planes [begin, end) of the given lists */
+  template <typename T>
+  void _medianFilterPlanes(
+    const std::vector<blitz::Array<T,2> >& src,
+    std::vector<blitz::Array<T,2> >& dst,
+    const blitz::TinyVector<int,2>& radius,
+    const int begin,
+    const int end
+  ){
+    for (int p = begin; p < end; ++p)
+      medianFilter(src[p], dst[p], radius);
+  }
+
+  /**
+   * @brief Performs a median filtering of each plane of the given color image.
+   * The planes are filtered in parallel.
+   * @param src The 3D input image
+   * @param dst The 3D output image of size src.shape - (0, 2*radius)
+   * @param radius The radius of the window in vertical and horizontal direction
+   * @param threads The number of threads to use; see getNumberOfThreads
+   */
   template <typename T>
   void medianFilter(
     const blitz::Array<T,3>& src,
     blitz::Array<T,3>& dst,
-    const blitz::TinyVector<int,2>& radius
+    const blitz::TinyVector<int,2>& radius,
+    const int threads = 0
   ){
-    // iterate over the color layers
+    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    // the color layers are sliced before starting the threads
+    std::vector<blitz::Array<T,2> > src_slices, dst_slices;
     for (int p = 0; p < dst.extent(0); ++p){
-      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<T,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
-
-      // Apply median filter to the plane
-      medianFilter(src_slice, dst_slice, radius);
+      src_slices.push_back(src(p, blitz::Range::all(), blitz::Range::all()));
+      dst_slices.push_back(dst(p, blitz::Range::all(), blitz::Range::all()));
     }
+
+    // Apply median filter to the planes
+    parallelFor(dst.extent(0), threads, boost::bind(&_medianFilterPlanes<T>, boost::cref(src_slices), boost::ref(dst_slices), boost::cref(radius), _1, _2));
   }
 
 } } } // namespaces
 
 #endif // BOB_IP_BASE_MEDIAN_H
-
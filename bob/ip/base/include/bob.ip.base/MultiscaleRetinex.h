@@ -19,6 +19,8 @@
 #include <boost/shared_array.hpp>
 
 #include <bob.ip.base/Gaussian.h>
+#include <bob.ip.base/GaussianScaleSpace.h>
+#include <bob.ip.base/LookupTable.h>
 
 namespace bob { namespace ip { namespace base {
 
@@ -100,6 +102,8 @@ namespace bob { namespace ip { namespace base {
       int getSizeStep() const { return m_size_step; }
       double getSigma() const { return m_sigma; }
       bob::sp::Extrapolation::BorderType getConvBorder() const { return m_conv_border; }
+      bool getReducedResolution() const { return m_reduced_resolution; }
+      GaussianAlgorithm getAlgorithm() const { return m_algorithm; }
 
       /**
        * @brief Setters
@@ -109,6 +113,17 @@ namespace bob { namespace ip { namespace base {
       void setSizeStep(const int size_step) { m_size_step = size_step; computeKernels(); }
       void setSigma(const double sigma) { m_sigma = sigma; computeKernels(); }
       void setConvBorder(const bob::sp::Extrapolation::BorderType border_type) { m_conv_border = border_type; computeKernels(); }
+      /**
+       * @brief Enables or disables the reduced resolution mode.
+       * In this mode, the large scales are smoothed on a decimated version of the image, which is bilinearly upsampled afterwards.
+       * The number of decimation levels is chosen for each scale from the standard deviation of its kernel.
+       */
+      void setReducedResolution(const bool reduced_resolution) { m_reduced_resolution = reduced_resolution; }
+      /**
+       * @brief Sets the algorithm of the Gaussians of all scales, see bob::ip::base::Gaussian.
+       * With the recursive approximation, the execution time does not depend on the size of the scales, and the kernels are not truncated.
+       */
+      void setAlgorithm(const GaussianAlgorithm algorithm) { m_algorithm = algorithm; computeKernels(); }
 
       /**
        * @brief Process a 2D blitz Array/Image
@@ -121,9 +136,24 @@ namespace bob { namespace ip { namespace base {
         dst = 0.;
         if( m_tmp.extent(0) != src.extent(0) || m_tmp.extent(1) != src.extent(1))
           m_tmp.resize(src.extent(0), src.extent(1) );
+        // The log of the input image is computed once for all scales (with a lookup table for integral images)
+        if( m_log_src.extent(0) != src.extent(0) || m_log_src.extent(1) != src.extent(1))
+          m_log_src.resize(src.extent(0), src.extent(1) );
+        m_log_table.transform(src, _LogPlusOne(), m_log_src);
+        // In reduced resolution mode, the pyramid is shared by all scales
+        const int levels = computeLevels(src.extent(0), src.extent(1));
+        if (levels) _build_pyramid(src, levels, m_pyramid_gaussian, m_tmp_reduced, m_pyramid);
         for(size_t s=0; s<m_n_scales; ++s) {
-          m_gaussians[s].filter(src,m_tmp);
-          dst += (blitz::log(src+1.) - blitz::log(m_tmp+1.));
+          if (m_levels[s]) {
+            const blitz::Array<double,2>& level = m_pyramid[m_levels[s]-1];
+            if (m_tmp_reduced.extent(0) != level.extent(0) || m_tmp_reduced.extent(1) != level.extent(1))
+              m_tmp_reduced.resize(level.shape());
+            m_reduced_gaussians[s].filter(level, m_tmp_reduced);
+            _upsample_bilinear(m_tmp_reduced, m_levels[s], m_tmp);
+          } else {
+            m_gaussians[s].filter(src,m_tmp);
+          }
+          dst += (m_log_src - blitz::log(m_tmp+1.));
         }
         dst /= (double)m_n_scales;
       }
@@ -147,6 +177,12 @@ namespace bob { namespace ip { namespace base {
     private:
       void computeKernels();
 
+      /**
+       * @brief Computes the number of decimation levels of each scale for an image of the given size, and sets up the Gaussians for the decimated images
+       * @return The maximum number of levels over all scales; 0 if the reduced resolution mode is disabled
+       */
+      int computeLevels(const int height, const int width);
+
       /**
        * @brief Attributes
        */
@@ -155,9 +191,20 @@ namespace bob { namespace ip { namespace base {
       int m_size_step;
       double m_sigma;
       bob::sp::Extrapolation::BorderType m_conv_border;
+      bool m_reduced_resolution;
+      GaussianAlgorithm m_algorithm;
 
       boost::shared_array<bob::ip::base::Gaussian> m_gaussians;
       blitz::Array<double,2> m_tmp;
+      blitz::Array<double,2> m_log_src;
+      LookupTable<_LogPlusOne> m_log_table;
+
+      // reduced resolution mode
+      bob::ip::base::Gaussian m_pyramid_gaussian;
+      boost::shared_array<bob::ip::base::Gaussian> m_reduced_gaussians;
+      std::vector<int> m_levels;
+      std::vector<blitz::Array<double,2> > m_pyramid;
+      blitz::Array<double,2> m_tmp_reduced;
   };
 
 } } } // namespaces
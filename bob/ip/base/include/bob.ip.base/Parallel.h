@@ -0,0 +1,101 @@
+/**
+ * @date Sat Oct 17 14:36:02 CEST 2026
+ *
+ * This file defines a helper function to distribute independent work items over several threads
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_PARALLEL_H
+#define BOB_IP_BASE_PARALLEL_H
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief Returns the number of threads to be used.
+   * @param threads The requested number of threads; if 0 or negative, the number of available cores is returned
+   */
+  inline int getNumberOfThreads(const int threads){
+    if (threads > 0) return threads;
+    const int cores = boost::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+  }
+
+  /** helper class that executes one chunk of parallelFor and records the first error */
+  template <typename F>
+  class _ParallelChunk {
+    public:
+      _ParallelChunk(F& function, const int begin, const int end, std::string& error, boost::mutex& mutex)
+      : m_function(function), m_begin(begin), m_end(end), m_error(error), m_mutex(mutex) {}
+
+      void operator()() const {
+        try {
+          m_function(m_begin, m_end);
+        } catch (std::exception& e) {
+          boost::mutex::scoped_lock lock(m_mutex);
+          if (m_error.empty()) m_error = e.what();
+        } catch (...) {
+          boost::mutex::scoped_lock lock(m_mutex);
+          if (m_error.empty()) m_error = "unknown exception raised in worker thread";
+        }
+      }
+
+    private:
+      F& m_function;
+      const int m_begin, m_end;
+      std::string& m_error;
+      boost::mutex& m_mutex;
+  };
+
+  /**
+   * @brief Splits the index range [0, size) into contiguous chunks and calls function(begin, end) for each chunk in a separate thread.
+   *
+   * If only one thread is requested, or if the range is too small, the function is called in the current thread.
+   * Exceptions raised in the worker threads are re-thrown as std::runtime_error after all threads have finished.
+   *
+   * @warning The reference counting of blitz::Array is not thread-safe.
+   *   Hence, the function should not create, copy or slice blitz::Arrays that share memory with arrays of other chunks;
+   *   required slices should be prepared before calling this function.
+   *
+   * @param size The number of work items
+   * @param threads The number of threads to use; see getNumberOfThreads
+   * @param function The function to call, which needs to accept two integral parameters begin and end
+   */
+  template <typename F>
+  void parallelFor(const int size, const int threads, F function){
+    const int n = std::min(getNumberOfThreads(threads), size);
+    if (n <= 1){
+      if (size > 0) function(0, size);
+      return;
+    }
+
+    std::string error;
+    boost::mutex mutex;
+    std::vector<boost::shared_ptr<boost::thread> > workers;
+    try {
+      for (int t = 0; t < n; ++t){
+        const int begin = static_cast<int>(static_cast<long>(size) * t / n),
+                  end = static_cast<int>(static_cast<long>(size) * (t+1) / n);
+        workers.push_back(boost::shared_ptr<boost::thread>(new boost::thread(_ParallelChunk<F>(function, begin, end, error, mutex))));
+      }
+    } catch (...) {
+      // could not start all threads; wait for the running ones before giving up
+      for (size_t t = 0; t < workers.size(); ++t) workers[t]->join();
+      throw;
+    }
+    for (size_t t = 0; t < workers.size(); ++t){
+      workers[t]->join();
+    }
+    if (!error.empty()) throw std::runtime_error(error);
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_PARALLEL_H
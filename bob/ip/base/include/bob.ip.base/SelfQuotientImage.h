@@ -17,8 +17,11 @@
 #include <bob.core/assert.h>
 #include <bob.sp/extrapolate.h>
 #include <boost/shared_array.hpp>
+#include <boost/format.hpp>
+#include <stdexcept>
 
 #include <bob.ip.base/WeightedGaussian.h>
+#include <bob.ip.base/LookupTable.h>
 
 namespace bob { namespace ip { namespace base {
 
@@ -100,6 +103,8 @@ namespace bob { namespace ip { namespace base {
       size_t getSizeStep() const { return m_size_step; }
       double getSigma() const { return m_sigma; }
       bob::sp::Extrapolation::BorderType getConvBorder() const { return m_conv_border; }
+      int getThreads() const { return m_threads; }
+      bool getReducedResolution() const { return m_reduced_resolution; }
 
       /**
        * @brief Setters
@@ -113,6 +118,13 @@ namespace bob { namespace ip { namespace base {
       void setSizeStep(const size_t size_step) { m_size_step = size_step; computeKernels(); }
       void setSigma(const double sigma) { m_sigma = sigma; computeKernels(); }
       void setConvBorder(const bob::sp::Extrapolation::BorderType border_type) { m_conv_border = border_type; computeKernels(); }
+      void setThreads(const int threads) { m_threads = threads; }
+      /**
+       * @brief Enables or disables the reduced resolution mode.
+       * In this mode, the weighted Gaussians of the large scales are computed only at every 2^l-th pixel in both directions, and bilinearly upsampled afterwards.
+       * The number of decimation levels l is chosen for each scale from the standard deviation of its kernel.
+       */
+      void setReducedResolution(const bool reduced_resolution) { m_reduced_resolution = reduced_resolution; }
 
         /**
          * @brief Process a 2D blitz Array/Image
@@ -122,15 +134,33 @@ namespace bob { namespace ip { namespace base {
         template <typename T>
         void process(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst){
           // TODO: assert array elements > -1.
-          // Checks are postponed to the Weighted Gaussian operator() function.
-          dst = 0.;
-          if( m_tmp.extent(0) != src.extent(0) || m_tmp.extent(1) != src.extent(1))
-            m_tmp.resize(src.extent(0), src.extent(1) );
-          for(size_t s=0; s<m_n_scales; ++s) {
-            m_wgaussians[s].filter(src,m_tmp);
-            dst += (blitz::log(src+1.) - blitz::log(m_tmp+1.));
+          bob::core::array::assertZeroBase(src);
+          bob::core::array::assertZeroBase(dst);
+          bob::core::array::assertSameShape(src, dst);
+
+          // All scales share the image extrapolated by the largest radius, and its integral image
+          int radius_y = 0, radius_x = 0;
+          for (size_t s = 0; s < m_n_scales; ++s){
+            radius_y = std::max(radius_y, (int)m_wgaussians[s].getRadiusY());
+            radius_x = std::max(radius_x, (int)m_wgaussians[s].getRadiusX());
+          }
+          if (src.extent(0) < 2*radius_y+1 || src.extent(1) < 2*radius_x+1) {
+            boost::format m("The largest convolutional kernel (%dx%d) is larger than the array to process (%dx%d).");
+            m % (2*radius_y+1) % (2*radius_x+1) % src.extent(0) % src.extent(1);
+            throw std::runtime_error(m.str());
           }
-          dst /= (double)m_n_scales;
+          _extrapolate(src, radius_y, radius_x, m_conv_border, m_src_extra);
+
+          // For integral images, the log of the input image is looked up in a table; otherwise, it is computed in processRows
+          if (_lookup_table_size<T>::value){
+            if (m_log_src.extent(0) != src.extent(0) || m_log_src.extent(1) != src.extent(1))
+              m_log_src.resize(src.extent(0), src.extent(1));
+            m_log_table.transform(src, _LogPlusOne(), m_log_src);
+          } else if (m_log_src.size()){
+            m_log_src.resize(0, 0);
+          }
+
+          processExtrapolated(dst);
         }
 
         /**
@@ -157,6 +187,26 @@ namespace bob { namespace ip { namespace base {
     private:
         void computeKernels();
 
+        /**
+         * @brief Computes the number of decimation levels of each scale for an image of the given size; all levels are 0 if the reduced resolution mode is disabled
+         */
+        void computeLevels(const int height, const int width);
+
+        /**
+         * @brief Computes the sum of the log illumination of all scales with reduced resolution into m_reduced_log
+         */
+        void processReduced(const int height, const int width);
+
+        /**
+         * @brief Computes the integral image of m_src_extra and evaluates all scales from these buffers
+         */
+        void processExtrapolated(blitz::Array<double,2>& dst);
+
+        /**
+         * @brief Processes the rows [begin, end) of dst for all scales
+         */
+        void processRows(blitz::Array<double,2>& dst, const int begin, const int end);
+
         /**
          * @brief Attributes
          */
@@ -166,8 +216,21 @@ namespace bob { namespace ip { namespace base {
         double m_sigma;
         bob::sp::Extrapolation::BorderType m_conv_border;
 
+        int m_threads;
+        bool m_reduced_resolution;
+
         boost::shared_array<bob::ip::base::WeightedGaussian> m_wgaussians;
         blitz::Array<double,2> m_tmp;
+        blitz::Array<double,2> m_src_extra;
+        blitz::Array<double,2> m_src_integral;
+        blitz::Array<double,2> m_log_src;
+        LookupTable<_LogPlusOne> m_log_table;
+
+        // reduced resolution mode
+        std::vector<int> m_levels;
+        int m_n_reduced;
+        blitz::Array<double,2> m_tmp_reduced;
+        blitz::Array<double,2> m_reduced_log;
   };
 
 } } } // namespaces
@@ -11,66 +11,131 @@
 #define BOB_IP_BASE_SOBEL_H
 
 #include <stdexcept>
+#include <vector>
+#include <cmath>
 #include <boost/format.hpp>
 
 #include <bob.core/assert.h>
 #include <bob.core/cast.h>
-#include <bob.sp/conv.h>
 #include <bob.sp/extrapolate.h>
+#include <bob.ip.base/Convolution.h>
 
 namespace bob { namespace ip { namespace base {
 
-  // compute filtering with the given filter
-  template <typename T>
+  /**
+    * @brief Computes both Sobel responses of the src image in a single sweep.
+    *   For each row, the three source rows are combined into a vertically
+    *   smoothed and a vertically differentiated row, which are extended by
+    *   one column on each side. The y-response is the horizontally smoothed
+    *   difference, the x-response is the horizontal difference of the
+    *   smoothed row.
+    *   If magnitude is not empty, the gradient magnitude and orientation are
+    *   computed in the same sweep.
+    */
+  template <typename T, typename U>
   void _sobel(
     const blitz::Array<T,2>& src,
-    const blitz::Array<T,2>& kernel,
-    blitz::Array<T,2>& dst,
+    blitz::Array<U,3>& dst,
+    blitz::Array<double,2>& magnitude,
+    blitz::Array<double,2>& orientation,
     bob::sp::Extrapolation::BorderType border_type
   ){
-    if (border_type == bob::sp::Extrapolation::Zero)
-      bob::sp::conv(src, kernel, dst);
-    else {
-      blitz::Array<T,2> tmp(bob::sp::getConvOutputSize(src, kernel, bob::sp::Conv::Full));
-      if (border_type == bob::sp::Extrapolation::NearestNeighbour) bob::sp::extrapolateNearest(src, tmp);
-      else if (border_type == bob::sp::Extrapolation::Circular) bob::sp::extrapolateCircular(src, tmp);
-      else if (border_type == bob::sp::Extrapolation::Mirror) bob::sp::extrapolateMirror(src, tmp);
-      else throw std::runtime_error("The given border type is (currently) not supported");
-      bob::sp::conv(tmp, kernel, dst, bob::sp::Conv::Valid);
+    if (border_type != bob::sp::Extrapolation::Zero && border_type != bob::sp::Extrapolation::NearestNeighbour &&
+        border_type != bob::sp::Extrapolation::Circular && border_type != bob::sp::Extrapolation::Mirror)
+      throw std::runtime_error("The given border type is (currently) not supported");
+
+    const int height = src.extent(0), width = src.extent(1);
+    const bool gradient = magnitude.size() > 0;
+    // the source columns of the extended rows; -1 stands for zero padding
+    std::vector<int> columns(width + 2);
+    for (int x = 0; x < width + 2; ++x) columns[x] = _border_index(x - 1, width, border_type);
+    std::vector<U> smooth(width + 2), diff(width + 2);
+
+    for (int y = 0; y < height; ++y){
+      const int above = _border_index(y - 1, height, border_type), below = _border_index(y + 1, height, border_type);
+      // vertical filters: (1, 2, 1) for smoothing and (1, 0, -1) for differentiation
+      for (int x = 0; x < width + 2; ++x){
+        const int c = columns[x];
+        if (c < 0){
+          smooth[x] = diff[x] = U(0);
+          continue;
+        }
+        const U a = above < 0 ? U(0) : static_cast<U>(src(above, c));
+        const U b = below < 0 ? U(0) : static_cast<U>(src(below, c));
+        smooth[x] = a + U(2) * static_cast<U>(src(y, c)) + b;
+        diff[x] = a - b;
+      }
+      // horizontal filters: (1, 2, 1) for the y-response and (1, 0, -1) for the x-response
+      for (int x = 0; x < width; ++x){
+        const U gy = diff[x] + U(2) * diff[x+1] + diff[x+2];
+        const U gx = smooth[x] - smooth[x+2];
+        dst(0,y,x) = gy;
+        dst(1,y,x) = gx;
+        if (gradient){
+          const double dy = static_cast<double>(gy), dx = static_cast<double>(gx);
+          magnitude(y,x) = std::sqrt(dy*dy + dx*dx);
+          orientation(y,x) = std::atan2(dy, dx);
+        }
+      }
     }
   }
 
+  /** checks the shape of the Sobel output */
+  template <typename T, typename U>
+  void _checkSobel(
+    const blitz::Array<T,2>& src,
+    const blitz::Array<U,3>& dst
+  ){
+    // Check that dst has two planes
+    if (dst.extent(0) != 2) throw std::runtime_error((boost::format("destination array extent for the first dimension (0) is not 2, but %d") % dst.extent(0)).str());
+
+    // Check that dst has zero bases
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameDimensionLength(dst.extent(1), src.extent(0));
+    bob::core::array::assertSameDimensionLength(dst.extent(2), src.extent(1));
+  }
+
   /**
     * @brief Process a 2D blitz Array/Image by applying the Sobel operator
     *   The resulting 3D array will contain two planes:
     *     - The first one for the convolution with the y-kernel
     *     - The second one for the convolution with the x-kernel
-    * @warning The selected type should be signed (e.g. int64_t or double)
+    *   The filters are computed in the type of the dst array, e.g., int32_t
+    *   can be used to filter uint8_t images without rounding.
+    * @warning The selected type should be signed (e.g. int32_t or double)
     */
-  template <typename T>
+  template <typename T, typename U>
   void sobel(
     const blitz::Array<T,2>& src,
-    blitz::Array<T,3>& dst,
+    blitz::Array<U,3>& dst,
     bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror
   ){
-    // Check that dst has two planes
-    if (dst.extent(0) != 2) throw std::runtime_error((boost::format("destination array extent for the first dimension (0) is not 2, but %d") % dst.extent(0)).str());
-
-    // Check that dst has zero bases
-    bob::core::array::assertZeroBase(dst);
-
-    // Define kernels for y and x
-    blitz::Array<T,2> kernel_y(3,3), kernel_x(3,3);
-    kernel_y = -1, -2, -1, 0, 0, 0, 1, 2, 1;
-    kernel_x = -1, 0, 1, -2, 0, 2, -1, 0, 1;
-
-    // Define slices for y and x
-    blitz::Array<T,2> dst_y = dst(0, blitz::Range::all(), blitz::Range::all());
-    blitz::Array<T,2> dst_x = dst(1, blitz::Range::all(), blitz::Range::all());
+    _checkSobel(src, dst);
+    blitz::Array<double,2> none;
+    _sobel(src, dst, none, none, border_type);
+  }
 
-    // execute
-    _sobel(src, kernel_y, dst_y, border_type);
-    _sobel(src, kernel_x, dst_x, border_type);
+  /**
+    * @brief Process a 2D blitz Array/Image by applying the Sobel operator,
+    *   and computes the gradient magnitude sqrt(gy^2 + gx^2) and the
+    *   gradient orientation atan2(gy, gx) in the same sweep.
+    * @see sobel(const blitz::Array<T,2>&, blitz::Array<U,3>&, bob::sp::Extrapolation::BorderType)
+    */
+  template <typename T, typename U>
+  void sobel(
+    const blitz::Array<T,2>& src,
+    blitz::Array<U,3>& dst,
+    blitz::Array<double,2>& magnitude,
+    blitz::Array<double,2>& orientation,
+    bob::sp::Extrapolation::BorderType border_type = bob::sp::Extrapolation::Mirror
+  ){
+    _checkSobel(src, dst);
+    bob::core::array::assertZeroBase(magnitude);
+    bob::core::array::assertZeroBase(orientation);
+    bob::core::array::assertSameShape(magnitude, src);
+    bob::core::array::assertSameShape(orientation, src);
+    if (!magnitude.size()) return;
+    _sobel(src, dst, magnitude, orientation, border_type);
   }
 
 
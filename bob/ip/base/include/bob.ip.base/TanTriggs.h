@@ -11,7 +11,8 @@
 #define BOB_IP_BASE_TAN_TRIGGS_H
 
 #include <bob.core/assert.h>
-#include <bob.sp/conv.h>
+#include <bob.ip.base/Convolution.h>
+#include <bob.ip.base/LookupTable.h>
 #include <bob.sp/extrapolate.h>
 
 namespace bob { namespace ip { namespace base {
@@ -24,6 +25,7 @@ namespace bob { namespace ip { namespace base {
     * @param src The input blitz array
     * @param dst The output blitz array (always double)
     * @param gamma The gamma value for power-law gamma correction
+    * @note For uint8 and uint16 images, the power is computed once per gray value
     */
   template<typename T>
   void gammaCorrection(
@@ -40,7 +42,7 @@ namespace bob { namespace ip { namespace base {
     if( gamma < 0.)  throw std::runtime_error((boost::format("parameter `gamma' was set to %f, but should be greater or equal zero") % gamma).str());
 
     // Perform gamma correction for the 2D array
-    dst = blitz::pow(src, gamma);
+    pointwiseTransform(src, _GammaFunction(gamma), dst);
   }
 
 
@@ -172,27 +174,20 @@ namespace bob { namespace ip { namespace base {
           m_img_tmp.resize( src.extent(0), src.extent(1) );
 
         // 1/ Perform gamma correction
+        // (for integral images, the lookup tables are kept for the next image)
         if( m_gamma > 0.)
-          bob::ip::base::gammaCorrection( src, m_img_tmp, m_gamma);
+          m_gamma_table.transform( src, _GammaFunction(m_gamma), m_img_tmp);
         else
-          m_img_tmp = blitz::log( 1. + src );
-
-        // 2/ Convolution with the DoG Filter
-        if (m_border_type == bob::sp::Extrapolation::Zero)
-          sp::conv( m_img_tmp, m_kernel, dst, bob::sp::Conv::Same);
-        else {
-          m_img_tmp2.resize(bob::sp::getConvOutputSize(m_img_tmp, m_kernel, bob::sp::Conv::Full));
-          if (m_border_type == bob::sp::Extrapolation::NearestNeighbour)
-            bob::sp::extrapolateNearest(m_img_tmp, m_img_tmp2);
-          else if (m_border_type == bob::sp::Extrapolation::Circular)
-            bob::sp::extrapolateCircular(m_img_tmp, m_img_tmp2);
-          else
-            bob::sp::extrapolateMirror(m_img_tmp, m_img_tmp2);
-          bob::sp::conv( m_img_tmp2, m_kernel, dst, bob::sp::Conv::Valid);
-        }
-
-        // 3/ Perform contrast equalization
-        performContrastEqualization(dst);
+          m_log_table.transform( src, _LogPlusOne(), m_img_tmp);
+
+        // 2/ Convolution with the DoG Filter, which is the difference of two separable Gaussians
+        if (m_img_tmp2.extent(0) != src.extent(0) || m_img_tmp2.extent(1) != src.extent(1))
+          m_img_tmp2.resize( src.extent(0), src.extent(1) );
+        convolveSeparable(m_img_tmp, m_kernel0, m_kernel0, dst, m_border_type, m_buffer);
+        convolveSeparable(m_img_tmp, m_kernel1, m_kernel1, m_img_tmp2, m_border_type, m_buffer);
+
+        // 3/ Subtract the Gaussians and perform contrast equalization
+        performContrastEqualization(dst, m_img_tmp2);
       }
 
 
@@ -200,18 +195,30 @@ namespace bob { namespace ip { namespace base {
       /**
         * @brief Perform the contrast equalization step on a 2D blitz
         * Array/Image.
+        * The DoG filtered image is computed as img - outer on the fly, and
+        * the statistics of both normalization steps are collected while it
+        * is produced, so that the image is written only twice.
+        * @param img The image filtered with the inner Gaussian; contains the
+        *   equalized DoG image on output
+        * @param outer The image filtered with the outer Gaussian, which is
+        *   overwritten
         */
-      void performContrastEqualization( blitz::Array<double,2>& img);
+      void performContrastEqualization( blitz::Array<double,2>& img, blitz::Array<double,2>& outer);
 
       /**
-        * @brief Generate the difference of Gaussian filter
+        * @brief Generate the difference of Gaussian filter, and the separable Gaussians it is composed of
         */
       void computeDoG(double sigma0, double sigma1, size_t size);
 
       // Attributes
       blitz::Array<double, 2> m_kernel;
+      blitz::Array<double, 1> m_kernel0;
+      blitz::Array<double, 1> m_kernel1;
       blitz::Array<double, 2> m_img_tmp;
       blitz::Array<double, 2> m_img_tmp2;
+      blitz::Array<double, 2> m_buffer;
+      LookupTable<_GammaFunction> m_gamma_table;
+      LookupTable<_LogPlusOne> m_log_table;
       double m_gamma;
       double m_sigma0;
       double m_sigma1;
@@ -0,0 +1,255 @@
+/**
+ * @date Sat Oct 17 10:12:43 CEST 2026
+ *
+ * This file defines a class that caches the bi-linear interpolation of a geometric transformation
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_WARP_PLAN_H
+#define BOB_IP_BASE_WARP_PLAN_H
+
+#include <boost/shared_ptr.hpp>
+#include <bob.core/assert.h>
+#include <bob.core/check.h>
+
+#include <bob.ip.base/GeomNorm.h>
+#include <bob.ip.base/FaceEyesNorm.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief A precompiled geometric transformation.
+   *
+   * For each pixel of the target image, the offsets of the (up to four) source
+   * pixels inside of the source image and their bi-linear interpolation
+   * weights are computed once, exactly as
+   * done by bob::ip::base::transform. Afterward, the same transformation can
+   * be applied to any number of images of the source shape with a pure
+   * gather-and-blend loop. The results are identical to the ones of
+   * bob::ip::base::transform.
+   *
+   * Additionally, the target pixels that would access pixels outside of the
+   * source image are cached in the valid mask.
+   *
+   * As for bob::ip::base::transform, the interpolated values are rounded and
+   * saturated for integral target images.
+   */
+  class WarpPlan
+  {
+    public:
+
+      /**
+        * @brief Constructor taking the parameters of bob::ip::base::transform
+        */
+      WarpPlan(
+        const blitz::TinyVector<int,2>& src_shape,
+        const blitz::TinyVector<double,2>& src_center,
+        const blitz::TinyVector<int,2>& dst_shape,
+        const blitz::TinyVector<double,2>& dst_center,
+        const blitz::TinyVector<double,2>& scaling_factor,
+        const double rotation_angle
+      );
+
+      /**
+        * @brief Constructor caching the transformation of GeomNorm::process for the given source image shape and transformation center
+        */
+      WarpPlan(
+        const GeomNorm& geomNorm,
+        const blitz::TinyVector<int,2>& src_shape,
+        const blitz::TinyVector<double,2>& center
+      );
+
+      /**
+        * @brief Constructor caching the transformation of FaceEyesNorm::extract for the given source image shape and eye positions
+        */
+      WarpPlan(
+        const FaceEyesNorm& faceEyesNorm,
+        const blitz::TinyVector<int,2>& src_shape,
+        const blitz::TinyVector<double,2>& rightEye,
+        const blitz::TinyVector<double,2>& leftEye
+      );
+
+      /**
+       * @brief Copy constructor
+       */
+      WarpPlan(const WarpPlan& other);
+
+      /**
+        * @brief Destructor
+        */
+      virtual ~WarpPlan() {}
+
+      /**
+       * @brief Assignment operator
+       */
+      WarpPlan& operator=(const WarpPlan& other);
+
+      /**
+        * @brief Accessors
+        */
+      const blitz::TinyVector<int,2>& getSourceShape() const { return m_src_shape; }
+      blitz::TinyVector<int,2> getTargetShape() const { return m_valid.shape(); }
+      const blitz::Array<bool,2>& getValidMask() const { return m_valid; }
+
+      /**
+        * @brief Applies the cached transformation to the given 2D image
+        */
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask) const;
+
+      /**
+        * @brief Applies the cached transformation to each color plane of the given 3D image
+        */
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask) const;
+
+    private:
+
+      void init(
+        const blitz::TinyVector<double,2>& src_center,
+        const blitz::TinyVector<int,2>& dst_shape,
+        const blitz::TinyVector<double,2>& dst_center,
+        const blitz::TinyVector<double,2>& scaling_factor,
+        const double rotation_angle
+      );
+
+      template <typename T, bool mask, typename U>
+      void processNoCheck(const T* src, const bool* src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask) const;
+
+      /**
+        * Attributes
+        */
+      blitz::TinyVector<int,2> m_src_shape;
+      // the offsets of the source pixels inside of the source image in row-major order for each target pixel;
+      // the neighbors are stored in the order upper left, upper right, lower left, lower right, skipping the ones outside of the source image
+      blitz::Array<std::ptrdiff_t,3> m_offsets;
+      // the bi-linear weights of these source pixels
+      blitz::Array<double,3> m_weights;
+      // the number of source pixels inside of the source image for each target pixel
+      blitz::Array<uint8_t,2> m_counts;
+      // the target pixels that only depend on pixels inside of the source image
+      blitz::Array<bool,2> m_valid;
+  };
+
+  template <typename T, bool mask, typename U>
+  inline void WarpPlan::processNoCheck(const T* src, const bool* src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask) const
+  {
+    const std::ptrdiff_t* offsets = m_offsets.data();
+    const double* weights = m_weights.data();
+    const bool* valid = m_valid.data();
+    const uint8_t* counts = m_counts.data();
+    for (int y = 0; y < dst.extent(0); ++y){
+      for (int x = 0; x < dst.extent(1); ++x, offsets += 4, weights += 4, ++valid, ++counts){
+        double res = 0.;
+        if (mask){
+          bool new_mask = *valid;
+          for (int i = 0; i < *counts; ++i){
+            if (src_mask[offsets[i]]){
+              res += weights[i] * src[offsets[i]];
+            } else if (weights[i] > 0.){
+              new_mask = false;
+            }
+          }
+          dst_mask(y,x) = new_mask;
+        } else if (*counts == 4){
+          res += weights[0] * src[offsets[0]];
+          res += weights[1] * src[offsets[1]];
+          res += weights[2] * src[offsets[2]];
+          res += weights[3] * src[offsets[3]];
+        } else {
+          // pixels outside of the source image are never accessed, as in bob::ip::base::transform
+          for (int i = 0; i < *counts; ++i)
+            res += weights[i] * src[offsets[i]];
+        }
+        dst(y,x) = _to_target<U>(res);
+      }
+    }
+  }
+
+  template <typename T, typename U>
+  inline void WarpPlan::process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertSameShape(src, m_src_shape);
+
+    // Check output
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameShape(dst, m_valid);
+
+    // the offsets are computed for row-major images
+    if (!bob::core::array::isCZeroBaseContiguous(src)){
+      blitz::Array<T,2> src_c(src.shape());
+      src_c = src;
+      process(src_c, dst);
+      return;
+    }
+
+    blitz::Array<bool,2> dst_mask;
+    processNoCheck<T,false>(src.data(), 0, dst, dst_mask);
+  }
+
+  template <typename T, typename U>
+  inline void WarpPlan::process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(src_mask);
+    bob::core::array::assertSameShape(src, m_src_shape);
+    bob::core::array::assertSameShape(src_mask, m_src_shape);
+
+    // Check output
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertZeroBase(dst_mask);
+    bob::core::array::assertSameShape(dst, m_valid);
+    bob::core::array::assertSameShape(dst_mask, m_valid);
+
+    // the offsets are computed for row-major images
+    if (!bob::core::array::isCZeroBaseContiguous(src) || !bob::core::array::isCZeroBaseContiguous(src_mask)){
+      blitz::Array<T,2> src_c(src.shape());
+      blitz::Array<bool,2> src_mask_c(src_mask.shape());
+      src_c = src;
+      src_mask_c = src_mask;
+      process(src_c, src_mask_c, dst, dst_mask);
+      return;
+    }
+
+    processNoCheck<T,true>(src.data(), src_mask.data(), dst, dst_mask);
+  }
+
+  template <typename T, typename U>
+  inline void WarpPlan::process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst) const
+  {
+    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    for (int p = 0; p < dst.extent(0); ++p){
+      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      // Process one plane
+      process(src_slice, dst_slice);
+    }
+  }
+
+  template <typename T, typename U>
+  inline void WarpPlan::process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask) const
+  {
+    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    bob::core::array::assertSameDimensionLength(src.extent(0), src_mask.extent(0));
+    bob::core::array::assertSameDimensionLength(src_mask.extent(0), dst_mask.extent(0));
+    for (int p = 0; p < dst.extent(0); ++p){
+      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
+      const blitz::Array<bool,2> src_mask_slice = src_mask(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<bool,2> dst_mask_slice = dst_mask(p, blitz::Range::all(), blitz::Range::all());
+      // Process one plane
+      process(src_slice, src_mask_slice, dst_slice, dst_mask_slice);
+    }
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_WARP_PLAN_H
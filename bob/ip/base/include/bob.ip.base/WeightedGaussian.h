@@ -10,10 +10,11 @@
 #ifndef BOB_IP_BASE_WEIGHTED_GAUSSIAN_H
 #define BOB_IP_BASE_WEIGHTED_GAUSSIAN_H
 
+#include <boost/format.hpp>
+#include <stdexcept>
 #include <bob.core/assert.h>
-#include <bob.core/cast.h>
-#include <bob.sp/conv.h>
 #include <bob.sp/extrapolate.h>
+#include <bob.ip.base/Convolution.h>
 
 namespace bob { namespace ip { namespace base {
 
@@ -89,6 +90,7 @@ namespace bob { namespace ip { namespace base {
       double getSigmaX() const { return m_sigma_x; }
       bob::sp::Extrapolation::BorderType getConvBorder() const { return m_conv_border; }
       const blitz::Array<double,2>& getUnweightedKernel() const { return m_kernel; }
+      int getThreads() const { return m_threads; }
 
       /**
         * @brief Setters
@@ -100,6 +102,7 @@ namespace bob { namespace ip { namespace base {
       void setSigmaX(const double sigma_x){ m_sigma_x = sigma_x; computeKernel(); }
       void setSigma(const blitz::TinyVector<double,2>& sigma) {m_sigma_y = sigma[0]; m_sigma_x = sigma[1]; computeKernel();}
       void setConvBorder(const bob::sp::Extrapolation::BorderType border_type){ m_conv_border = border_type; }
+      void setThreads(const int threads){ m_threads = threads; }
 
 
       /**
@@ -116,10 +119,24 @@ namespace bob { namespace ip { namespace base {
         */
       template <typename T>
       void filter(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst){
-        // Casts the input to double
-        blitz::Array<double,2> src_d = bob::core::array::cast<double>(src);
-        // Calls the specialized template function for double
-        filter_(src_d, dst);
+        // Checks input
+        bob::core::array::assertZeroBase(src);
+        bob::core::array::assertZeroBase(dst);
+        bob::core::array::assertSameShape(src, dst);
+        if(src.extent(0)<m_kernel.extent(0)) {
+          boost::format m("The convolutional kernel has the first dimension larger than the corresponding one of the array to process (%d > %d). Our convolution code does not allows. You could try to revert the order of the two arrays.");
+          m % src.extent(0) % m_kernel.extent(0);
+          throw std::runtime_error(m.str());
+        }
+        if(src.extent(1)<m_kernel.extent(1)) {
+          boost::format m("The convolutional kernel has the second dimension larger than the corresponding one of the array to process (%d > %d). Our convolution code does not allows. You could try to revert the order of the two arrays.");
+          m % src.extent(1) % m_kernel.extent(1);
+          throw std::runtime_error(m.str());
+        }
+
+        // Extrapolates src into the (contiguous) double buffer, which also performs the cast to double
+        _extrapolate(src, (int)m_radius_y, (int)m_radius_x, m_conv_border, m_src_extra);
+        filterExtrapolated(dst);
       }
 
       /**
@@ -139,9 +156,36 @@ namespace bob { namespace ip { namespace base {
         }
       }
 
+      /**
+        * @brief Computes the rows [begin, end) of the weighted Gaussian from precomputed buffers, which can be shared between several filters
+        * @param src_extra The (contiguous) input image extrapolated with getConvBorder() by at least the radius of this filter on each side
+        * @param src_integral The integral image of src_extra, including the zero border
+        * @param dst The 2D output blitz array; src_extra is centered on it
+        * @param begin The first row of dst to compute
+        * @param end The row after the last row of dst to compute
+        */
+      void filterRows(const blitz::Array<double,2>& src_extra, const blitz::Array<double,2>& src_integral, blitz::Array<double,2>& dst, const int begin, const int end) const;
+
+      /**
+        * @brief Computes the rows [begin, end) of the weighted Gaussian at every step-th pixel of an image from precomputed buffers
+        * @param src_extra The (contiguous) input image extrapolated with getConvBorder() by at least the radius of this filter on each side
+        * @param src_integral The integral image of src_extra, including the zero border
+        * @param shape The shape of the (not extrapolated) input image; src_extra is centered on it
+        * @param step The sampling step, in pixels
+        * @param dst The 2D output blitz array, where dst(i,j) is the result for pixel (i*step, j*step) of the image
+        * @param begin The first row of dst to compute
+        * @param end The row after the last row of dst to compute
+        */
+      void filterSamples(const blitz::Array<double,2>& src_extra, const blitz::Array<double,2>& src_integral, const blitz::TinyVector<int,2>& shape, const int step, blitz::Array<double,2>& dst, const int begin, const int end) const;
+
     private:
       void computeKernel();
 
+      /**
+        * @brief Computes the weighted Gaussian from the extrapolated image stored in m_src_extra
+        */
+      void filterExtrapolated(blitz::Array<double,2>& dst);
+
       /**
         * @brief Attributes
         */
@@ -152,7 +196,7 @@ namespace bob { namespace ip { namespace base {
       bob::sp::Extrapolation::BorderType m_conv_border;
 
       blitz::Array<double,2> m_kernel;
-      blitz::Array<double,2> m_kernel_weighted;
+      int m_threads;
 
       blitz::Array<double,2> m_src_extra;
       blitz::Array<double,2> m_src_integral;
@@ -0,0 +1,430 @@
+/**
+ * @date Sat Oct 17 21:06:43 CEST 2026
+ *
+ * @brief Binds the IntegralHistogram class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto IntegralHistogram_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".IntegralHistogram",
+  "Objects of this class compute the integral histogram of an image, from which the histograms of arbitrary rectangles of the image can be obtained",
+  "For each bin, the integral histogram contains the integral image of the pixels that fall into this bin. "
+  "After :py:func:`compute` was called, the histogram of any rectangle of the image is obtained with four lookups per bin, "
+  "so that the histograms of many overlapping rectangles can be computed much faster than with :py:func:`bob.ip.base.histogram`.\n\n"
+  "The counts are stored with 32 bit, which is exact for all rectangles with less than 2^32 pixels. "
+  "They can be stored either bin-major, i.e., one integral image per bin, or ``pixel_major``, i.e., the counts of all bins of one pixel are stored next to each other; "
+  "the latter is faster when many rectangles are queried."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Constructs a new integral histogram object",
+    "The object can be constructed from the number of bins, or copied from another IntegralHistogram object, including the computed integral histogram.",
+    true
+  )
+  .add_prototype("bins, [pixel_major]","")
+  .add_prototype("integral_histogram", "")
+  .add_parameter("bins", "int", "The number of bins of the histograms")
+  .add_parameter("pixel_major", "bool", "[default: ``False``] Store the counts of all bins of one pixel next to each other, instead of one integral image per bin")
+  .add_parameter("integral_histogram", ":py:class:`bob.ip.base.IntegralHistogram`", "The IntegralHistogram object to use for copy-construction")
+);
+
+
+static int PyBobIpBaseIntegralHistogram_init(PyBobIpBaseIntegralHistogramObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = IntegralHistogram_doc.kwlist(0);
+  char** kwlist2 = IntegralHistogram_doc.kwlist(1);
+
+  // get the number of command line arguments
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  PyObject* k = Py_BuildValue("s", kwlist2[0]);
+  auto k_ = make_safe(k);
+  if (nargs == 1 && ((args && PyTuple_Size(args) == 1 && PyBobIpBaseIntegralHistogram_Check(PyTuple_GET_ITEM(args,0))) || (kwargs && PyDict_Contains(kwargs, k)))){
+    // copy construct
+    PyBobIpBaseIntegralHistogramObject* other;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist2, &PyBobIpBaseIntegralHistogram_Type, &other)) return -1;
+
+    self->cxx.reset(new bob::ip::base::IntegralHistogram(*other->cxx));
+    return 0;
+  }
+
+  int bins;
+  PyObject* pixel_major = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|O!", kwlist1, &bins, &PyBool_Type, &pixel_major)){
+    IntegralHistogram_doc.print_usage();
+    return -1;
+  }
+  self->cxx.reset(new bob::ip::base::IntegralHistogram(bins, pixel_major && PyObject_IsTrue(pixel_major)));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create IntegralHistogram", -1)
+}
+
+static void PyBobIpBaseIntegralHistogram_delete(PyBobIpBaseIntegralHistogramObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseIntegralHistogram_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseIntegralHistogram_Type));
+}
+
+static PyObject* PyBobIpBaseIntegralHistogram_RichCompare(PyBobIpBaseIntegralHistogramObject* self, PyObject* other, int op) {
+  BOB_TRY
+
+  if (!PyBobIpBaseIntegralHistogram_Check(other)) {
+    PyErr_Format(PyExc_TypeError, "cannot compare `%s' with `%s'", Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+    return 0;
+  }
+  auto other_ = reinterpret_cast<PyBobIpBaseIntegralHistogramObject*>(other);
+  switch (op) {
+    case Py_EQ:
+      if (*self->cxx==*other_->cxx) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+    case Py_NE:
+      if (*self->cxx==*other_->cxx) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+    default:
+      Py_INCREF(Py_NotImplemented);
+      return Py_NotImplemented;
+  }
+  BOB_CATCH_MEMBER("cannot compare IntegralHistogram objects", 0)
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto bins = bob::extension::VariableDoc(
+  "bins",
+  "int",
+  "The number of bins of the histograms, with read and write access",
+  "Setting the number of bins discards the integral histogram that was computed before."
+);
+PyObject* PyBobIpBaseIntegralHistogram_getBins(PyBobIpBaseIntegralHistogramObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getBins());
+  BOB_CATCH_MEMBER("bins could not be read", 0)
+}
+int PyBobIpBaseIntegralHistogram_setBins(PyBobIpBaseIntegralHistogramObject* self, PyObject* value, void*){
+  BOB_TRY
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, bins.name());
+    return -1;
+  }
+  self->cxx->setBins(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("bins could not be set", -1)
+}
+
+static auto pixelMajor = bob::extension::VariableDoc(
+  "pixel_major",
+  "bool",
+  "Store the counts of all bins of one pixel next to each other, with read and write access",
+  "Changing the layout discards the integral histogram that was computed before."
+);
+PyObject* PyBobIpBaseIntegralHistogram_getPixelMajor(PyBobIpBaseIntegralHistogramObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getPixelMajor()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("pixel_major could not be read", 0)
+}
+int PyBobIpBaseIntegralHistogram_setPixelMajor(PyBobIpBaseIntegralHistogramObject* self, PyObject* value, void*){
+  BOB_TRY
+  int r = PyObject_IsTrue(value);
+  if (r < 0){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, pixelMajor.name());
+    return -1;
+  }
+  self->cxx->setPixelMajor(r>0);
+  return 0;
+  BOB_CATCH_MEMBER("pixel_major could not be set", -1)
+}
+
+static auto shape = bob::extension::VariableDoc(
+  "shape",
+  "(int, int)",
+  "The shape of the image, for which the integral histogram was computed, with read access only",
+  "If no integral histogram was computed yet, ``(0, 0)`` is returned."
+);
+PyObject* PyBobIpBaseIntegralHistogram_getShape(PyBobIpBaseIntegralHistogramObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("(ii)", self->cxx->getShape()[0], self->cxx->getShape()[1]);
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseIntegralHistogram_getseters[] = {
+    {
+      bins.name(),
+      (getter)PyBobIpBaseIntegralHistogram_getBins,
+      (setter)PyBobIpBaseIntegralHistogram_setBins,
+      bins.doc(),
+      0
+    },
+    {
+      pixelMajor.name(),
+      (getter)PyBobIpBaseIntegralHistogram_getPixelMajor,
+      (setter)PyBobIpBaseIntegralHistogram_setPixelMajor,
+      pixelMajor.doc(),
+      0
+    },
+    {
+      shape.name(),
+      (getter)PyBobIpBaseIntegralHistogram_getShape,
+      0,
+      shape.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto compute = bob::extension::FunctionDoc(
+  "compute",
+  "Computes the integral histogram of the given 2D/grayscale image",
+  "Without ``min_max``, each pixel value is its own bin, i.e., the image must be of an unsigned integral type and all pixel values must be lower than :py:attr:`bins`. "
+  "Otherwise, :py:attr:`bins` regular bins are defined between the provided minimum and maximum values, and all pixel values must be in this range.\n\n"
+  "Large images are processed with several threads, the results do not depend on the number of ``threads``.",
+  true
+)
+.add_prototype("src, [min_max], [threads]")
+.add_parameter("src", "array_like (2D)", "The source image")
+.add_parameter("min_max", "(scalar, scalar)", "[default: ``None``] The minimum value and the maximum value in the source image")
+.add_parameter("threads", "int", "[default: ``0``] The number of threads to use; if ``0``, all available cores are used")
+;
+
+template <typename T, char C>
+static bool compute_inner(PyBobIpBaseIntegralHistogramObject* self, PyBlitzArrayObject* src, PyObject* min_max, int threads){
+  if (!min_max){
+    self->cxx->compute(*PyBlitzArrayCxx_AsBlitz<T,2>(src), threads);
+    return true;
+  }
+  std::string format = (boost::format("%1%%1%") % C).str();
+  T min, max;
+  if (!PyArg_ParseTuple(min_max, format.c_str(), &min, &max)) return false;
+  self->cxx->compute(*PyBlitzArrayCxx_AsBlitz<T,2>(src), min, max, threads);
+  return true;
+}
+
+static PyObject* PyBobIpBaseIntegralHistogram_compute(PyBobIpBaseIntegralHistogramObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = compute.kwlist();
+
+  PyBlitzArrayObject* src;
+  PyObject* min_max = 0;
+  int threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|Oi", kwlist, &PyBlitzArray_Converter, &src, &min_max, &threads)) {
+    compute.print_usage();
+    return 0;
+  }
+
+  auto src_ = make_safe(src);
+  if (min_max == Py_None) min_max = 0;
+
+  if (src->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays", Py_TYPE(self)->tp_name);
+    compute.print_usage();
+    return 0;
+  }
+
+  bool res = true;
+  switch (src->type_num){
+    case NPY_UINT8:    res = compute_inner<uint8_t, 'B'>(self, src, min_max, threads); break;
+    case NPY_UINT16:   res = compute_inner<uint16_t, 'H'>(self, src, min_max, threads); break;
+    case NPY_UINT32:   res = compute_inner<uint32_t, 'I'>(self, src, min_max, threads); break;
+    case NPY_UINT64:   res = compute_inner<uint64_t, 'K'>(self, src, min_max, threads); break;
+    case NPY_INT8:     res = compute_inner<int8_t, 'b'>(self, src, min_max, threads); break;
+    case NPY_INT16:    res = compute_inner<int16_t, 'h'>(self, src, min_max, threads); break;
+    case NPY_INT32:    res = compute_inner<int32_t, 'i'>(self, src, min_max, threads); break;
+    case NPY_INT64:    res = compute_inner<int64_t, 'L'>(self, src, min_max, threads); break;
+    case NPY_FLOAT32:  res = compute_inner<float, 'f'>(self, src, min_max, threads); break;
+    case NPY_FLOAT64:  res = compute_inner<double, 'd'>(self, src, min_max, threads); break;
+    default:
+      compute.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' cannot compute the integral histogram of images of type %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(src->type_num));
+      return 0;
+  }
+  if (!res) return 0;
+
+  Py_RETURN_NONE;
+
+  BOB_CATCH_MEMBER("cannot compute the integral histogram", 0)
+}
+
+
+static auto histogram = bob::extension::FunctionDoc(
+  "histogram",
+  "Returns the histogram of the given rectangle of the image",
+  "The rectangle must lie inside the image, for which the integral histogram was computed; empty rectangles are allowed.",
+  true
+)
+.add_prototype("rectangle, [hist]", "hist")
+.add_parameter("rectangle", "(int, int, int, int)", "The rectangle as ``(top, left, height, width)``")
+.add_parameter("hist", "array_like (1D, uint64)", "[default: ``None``] If given, the histogram will be written to this array; must have :py:attr:`bins` elements")
+.add_return("hist", "array_like (1D, uint64)", "The histogram of the rectangle, which is the same as ``hist`` (if given)")
+;
+
+static PyObject* PyBobIpBaseIntegralHistogram_histogram(PyBobIpBaseIntegralHistogramObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = histogram.kwlist();
+
+  blitz::TinyVector<int,4> rect;
+  PyBlitzArrayObject* hist = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(iiii)|O&", kwlist, &rect[0], &rect[1], &rect[2], &rect[3], &PyBlitzArray_OutputConverter, &hist)) {
+    histogram.print_usage();
+    return 0;
+  }
+
+  auto hist_ = make_xsafe(hist);
+
+  if (hist){
+    if (hist->ndim != 1 || hist->type_num != NPY_UINT64){
+      PyErr_Format(PyExc_TypeError, "`%s' only writes histograms to 1D arrays of type uint64", Py_TYPE(self)->tp_name);
+      histogram.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t n[] = {self->cxx->getBins()};
+    hist = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 1, n);
+    hist_ = make_safe(hist);
+  }
+
+  self->cxx->histogram(rect[0], rect[1], rect[2], rect[3], *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(hist));
+  return PyBlitzArray_AsNumpyArray(hist, 0);
+
+  BOB_CATCH_MEMBER("cannot compute the histogram of the rectangle", 0)
+}
+
+
+static auto histograms = bob::extension::FunctionDoc(
+  "histograms",
+  "Returns the histograms of several rectangles of the image at once",
+  "The rectangles are given as a 2D array with one rectangle ``(top, left, height, width)`` per row, and all of them must lie inside the image, for which the integral histogram was computed. "
+  "Many rectangles are processed with several threads.",
+  true
+)
+.add_prototype("rectangles, [hists], [threads]", "hists")
+.add_parameter("rectangles", "array_like (2D, int32 or int64)", "The rectangles, one ``(top, left, height, width)`` per row")
+.add_parameter("hists", "array_like (2D, uint64)", "[default: ``None``] If given, the histograms will be written to this array; must have the shape ``(len(rectangles), bins)``")
+.add_parameter("threads", "int", "[default: ``0``] The number of threads to use; if ``0``, all available cores are used")
+.add_return("hists", "array_like (2D, uint64)", "The histograms of the rectangles, one per row, which is the same as ``hists`` (if given)")
+;
+
+static PyObject* PyBobIpBaseIntegralHistogram_histograms(PyBobIpBaseIntegralHistogramObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = histograms.kwlist();
+
+  PyBlitzArrayObject* rects,* hists = 0;
+  int threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&i", kwlist, &PyBlitzArray_Converter, &rects, &PyBlitzArray_OutputConverter, &hists, &threads)) {
+    histograms.print_usage();
+    return 0;
+  }
+
+  auto rects_ = make_safe(rects), hists_ = make_xsafe(hists);
+
+  if (rects->ndim != 2 || (rects->type_num != NPY_INT32 && rects->type_num != NPY_INT64)){
+    PyErr_Format(PyExc_TypeError, "`%s' requires the rectangles as 2D arrays of type int32 or int64", Py_TYPE(self)->tp_name);
+    histograms.print_usage();
+    return 0;
+  }
+
+  if (hists){
+    if (hists->ndim != 2 || hists->type_num != NPY_UINT64){
+      PyErr_Format(PyExc_TypeError, "`%s' only writes histograms to 2D arrays of type uint64", Py_TYPE(self)->tp_name);
+      histograms.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t n[] = {rects->shape[0], self->cxx->getBins()};
+    hists = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 2, n);
+    hists_ = make_safe(hists);
+  }
+
+  if (rects->type_num == NPY_INT32)
+    self->cxx->histograms(*PyBlitzArrayCxx_AsBlitz<int32_t,2>(rects), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(hists), threads);
+  else {
+    // rectangles given as int64 (the default integral type of numpy) are converted; values that do not fit into int32 cannot lie inside the image
+    const blitz::Array<int64_t,2> r64 = *PyBlitzArrayCxx_AsBlitz<int64_t,2>(rects);
+    blitz::Array<int32_t,2> r(r64.extent(0), r64.extent(1));
+    for (int i = 0; i < r64.extent(0); ++i)
+      for (int j = 0; j < r64.extent(1); ++j)
+        r(i,j) = static_cast<int32_t>(std::max<int64_t>(std::min<int64_t>(r64(i,j), std::numeric_limits<int32_t>::max()), std::numeric_limits<int32_t>::min()));
+    self->cxx->histograms(r, *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(hists), threads);
+  }
+  return PyBlitzArray_AsNumpyArray(hists, 0);
+
+  BOB_CATCH_MEMBER("cannot compute the histograms of the rectangles", 0)
+}
+
+
+static PyMethodDef PyBobIpBaseIntegralHistogram_methods[] = {
+  {
+    compute.name(),
+    (PyCFunction)PyBobIpBaseIntegralHistogram_compute,
+    METH_VARARGS|METH_KEYWORDS,
+    compute.doc()
+  },
+  {
+    histogram.name(),
+    (PyCFunction)PyBobIpBaseIntegralHistogram_histogram,
+    METH_VARARGS|METH_KEYWORDS,
+    histogram.doc()
+  },
+  {
+    histograms.name(),
+    (PyCFunction)PyBobIpBaseIntegralHistogram_histograms,
+    METH_VARARGS|METH_KEYWORDS,
+    histograms.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the IntegralHistogram type struct; will be initialized later
+PyTypeObject PyBobIpBaseIntegralHistogram_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseIntegralHistogram(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseIntegralHistogram_Type.tp_name = IntegralHistogram_doc.name();
+  PyBobIpBaseIntegralHistogram_Type.tp_basicsize = sizeof(PyBobIpBaseIntegralHistogramObject);
+  PyBobIpBaseIntegralHistogram_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseIntegralHistogram_Type.tp_doc = IntegralHistogram_doc.doc();
+
+  // set the functions
+  PyBobIpBaseIntegralHistogram_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseIntegralHistogram_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseIntegralHistogram_init);
+  PyBobIpBaseIntegralHistogram_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseIntegralHistogram_delete);
+  PyBobIpBaseIntegralHistogram_Type.tp_richcompare = reinterpret_cast<richcmpfunc>(PyBobIpBaseIntegralHistogram_RichCompare);
+  PyBobIpBaseIntegralHistogram_Type.tp_methods = PyBobIpBaseIntegralHistogram_methods;
+  PyBobIpBaseIntegralHistogram_Type.tp_getset = PyBobIpBaseIntegralHistogram_getseters;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseIntegralHistogram_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseIntegralHistogram_Type);
+  return PyModule_AddObject(module, "IntegralHistogram", (PyObject*)&PyBobIpBaseIntegralHistogram_Type) >= 0;
+}
@@ -35,6 +35,18 @@ static PyMethodDef module_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     s_rotatedOutputShape.doc()
   },
+  {
+    s_flip.name(),
+    (PyCFunction)PyBobIpBase_flip,
+    METH_VARARGS|METH_KEYWORDS,
+    s_flip.doc()
+  },
+  {
+    s_flop.name(),
+    (PyCFunction)PyBobIpBase_flop,
+    METH_VARARGS|METH_KEYWORDS,
+    s_flop.doc()
+  },
   {
     s_maxRectInMask.name(),
     (PyCFunction)PyBobIpBase_maxRectInMask,
@@ -77,6 +89,12 @@ static PyMethodDef module_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     s_integral.doc()
   },
+  {
+    s_tiltedIntegral.name(),
+    (PyCFunction)PyBobIpBase_tiltedIntegral,
+    METH_VARARGS|METH_KEYWORDS,
+    s_tiltedIntegral.doc()
+  },
   {
     s_histogram.name(),
     (PyCFunction)PyBobIpBase_histogram,
@@ -148,10 +166,13 @@ static PyObject* create_module (void) {
   if (PyModule_AddStringConstant(module, "__version__", BOB_EXT_MODULE_VERSION) < 0) return 0;
   if (!init_BobIpBaseGeomNorm(module)) return 0;
   if (!init_BobIpBaseFaceEyesNorm(module)) return 0;
+  if (!init_BobIpBaseWarpPlan(module)) return 0;
   if (!init_BobIpBaseLBP(module)) return 0;
   if (!init_BobIpBaseLBPTop(module)) return 0;
   if (!init_BobIpBaseDCTFeatures(module)) return 0;
   if (!init_BobIpBaseTanTriggs(module)) return 0;
+  if (!init_BobIpBaseCLAHE(module)) return 0;
+  if (!init_BobIpBaseIntegralHistogram(module)) return 0;
   if (!init_BobIpBaseGaussian(module)) return 0;
   if (!init_BobIpBaseMultiscaleRetinex(module)) return 0;
   if (!init_BobIpBaseWeightedGaussian(module)) return 0;
@@ -22,6 +22,8 @@
 #include <bob.ip.base/LBPTop.h>
 #include <bob.ip.base/DCTFeatures.h>
 #include <bob.ip.base/TanTriggs.h>
+#include <bob.ip.base/CLAHE.h>
+#include <bob.ip.base/IntegralHistogram.h>
 #include <bob.ip.base/Gaussian.h>
 #include <bob.ip.base/MultiscaleRetinex.h>
 #include <bob.ip.base/WeightedGaussian.h>
@@ -31,6 +33,7 @@
 #include <bob.ip.base/HOG.h>
 #include <bob.ip.base/GeomNorm.h>
 #include <bob.ip.base/FaceEyesNorm.h>
+#include <bob.ip.base/WarpPlan.h>
 #include <bob.ip.base/GLCM.h>
 #include <bob.ip.base/Wiener.h>
 
@@ -42,6 +45,31 @@ static inline int insert_item_string(PyObject* dict, PyObject* entries, const ch
   return PyDict_SetItemString(entries, key, v.get());
 }
 
+/// converts the given string to the memory layout of color images
+static inline bob::ip::base::ColorLayout color_layout(const std::string& o){
+  if (o == "planar") return bob::ip::base::LAYOUT_PLANAR;
+  if (o == "interleaved") return bob::ip::base::LAYOUT_INTERLEAVED;
+  throw std::runtime_error("The given color layout '" + o + "' is not known; choose one of ('planar', 'interleaved')");
+}
+
+/// converts the given string to the algorithm of Gaussian smoothing
+static inline bob::ip::base::GaussianAlgorithm gaussian_algorithm(const std::string& o){
+  if (o == "convolution") return bob::ip::base::GAUSSIAN_CONVOLUTION;
+  if (o == "recursive") return bob::ip::base::GAUSSIAN_RECURSIVE;
+  if (o == "automatic") return bob::ip::base::GAUSSIAN_AUTOMATIC;
+  throw std::runtime_error("The given Gaussian algorithm '" + o + "' is not known; choose one of ('convolution', 'recursive', 'automatic')");
+}
+
+/// converts the given algorithm of Gaussian smoothing to its string representation
+static inline const char* gaussian_algorithm(const bob::ip::base::GaussianAlgorithm o){
+  switch (o){
+    case bob::ip::base::GAUSSIAN_CONVOLUTION: return "convolution";
+    case bob::ip::base::GAUSSIAN_RECURSIVE: return "recursive";
+    case bob::ip::base::GAUSSIAN_AUTOMATIC: return "automatic";
+  }
+  throw std::runtime_error("The given Gaussian algorithm type is not known");
+}
+
 
 // GeomNorm
 typedef struct {
@@ -63,6 +91,16 @@ extern PyTypeObject PyBobIpBaseFaceEyesNorm_Type;
 bool init_BobIpBaseFaceEyesNorm(PyObject* module);
 int PyBobIpBaseFaceEyesNorm_Check(PyObject* o);
 
+// WarpPlan
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::WarpPlan> cxx;
+} PyBobIpBaseWarpPlanObject;
+
+extern PyTypeObject PyBobIpBaseWarpPlan_Type;
+bool init_BobIpBaseWarpPlan(PyObject* module);
+int PyBobIpBaseWarpPlan_Check(PyObject* o);
+
 // .. scaling
 PyObject* PyBobIpBase_scale(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_scale;
@@ -73,6 +111,10 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_rotate;
 PyObject* PyBobIpBase_rotatedOutputShape(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_rotatedOutputShape;
+PyObject* PyBobIpBase_flip(PyObject*, PyObject*, PyObject*);
+extern bob::extension::FunctionDoc s_flip;
+PyObject* PyBobIpBase_flop(PyObject*, PyObject*, PyObject*);
+extern bob::extension::FunctionDoc s_flop;
 
 // mask functions (in Affine.h)
 PyObject* PyBobIpBase_maxRectInMask(PyObject*, PyObject*, PyObject*);
@@ -122,6 +164,28 @@ bool init_BobIpBaseTanTriggs(PyObject* module);
 int PyBobIpBaseTanTriggs_Check(PyObject* o);
 
 
+// CLAHE
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::CLAHE> cxx;
+} PyBobIpBaseCLAHEObject;
+
+extern PyTypeObject PyBobIpBaseCLAHE_Type;
+bool init_BobIpBaseCLAHE(PyObject* module);
+int PyBobIpBaseCLAHE_Check(PyObject* o);
+
+
+// IntegralHistogram
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::IntegralHistogram> cxx;
+} PyBobIpBaseIntegralHistogramObject;
+
+extern PyTypeObject PyBobIpBaseIntegralHistogram_Type;
+bool init_BobIpBaseIntegralHistogram(PyObject* module);
+int PyBobIpBaseIntegralHistogram_Check(PyObject* o);
+
+
 // Gaussian
 typedef struct {
   PyObject_HEAD
@@ -294,6 +358,8 @@ extern bob::extension::FunctionDoc s_lbphsOutputShape;
 // integral
 PyObject* PyBobIpBase_integral(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_integral;
+PyObject* PyBobIpBase_tiltedIntegral(PyObject*, PyObject*, PyObject*);
+extern bob::extension::FunctionDoc s_tiltedIntegral;
 
 
 // histogram
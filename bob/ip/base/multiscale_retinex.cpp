@@ -24,13 +24,14 @@ static auto MultiscaleRetinex_doc = bob::extension::ClassDoc(
     ".. todo:: Add documentation for MultiscaleRetinex",
     true
   )
-  .add_prototype("[scales], [size_min], [size_step], [sigma], [border]","")
+  .add_prototype("[scales], [size_min], [size_step], [sigma], [border], [algorithm]","")
   .add_prototype("msrx", "")
   .add_parameter("scales", "int", "[default: 1] The number of scales (:py:class:`bob.ip.base.Gaussian`)")
   .add_parameter("size_min", "int", "[default: 1] The radius of the kernel of the smallest :py:class:`bob.ip.base.Gaussian`")
   .add_parameter("size_step", "int", "[default: 1] The step used to set the kernel size of other weighted Gaussians: ``size_s = 2 * (size_min + s * size_step) + 1``")
   .add_parameter("sigma", "double", "[default: 2.] The standard deviation of the kernel of the smallest weighted Gaussian; other sigmas: ``sigma_s = sigma * (size_min + s * size_step) / size_min``")
   .add_parameter("border", ":py:class:`bob.sp.BorderType`", "[default: ``bob.sp.BorderType.Mirror``] The extrapolation method used by the convolution at the border")
+  .add_parameter("algorithm", "str", "[default: ``'convolution'``] The algorithm used by the Gaussians of all scales, one of ``'convolution'``, ``'recursive'`` or ``'automatic'``; see :py:class:`bob.ip.base.Gaussian`")
   .add_parameter("msrx", ":py:class:`bob.ip.base.MultiscaleRetinex`", "The MultiscaleRetinex object to use for copy-construction")
 );
 
@@ -57,12 +58,14 @@ static int PyBobIpBaseMultiscaleRetinex_init(PyBobIpBaseMultiscaleRetinexObject*
   int scales = 1, size_min = 1, size_step = 1;
   double sigma = 2.;
   bob::sp::Extrapolation::BorderType border = bob::sp::Extrapolation::Mirror;
+  const char* algorithm = "convolution";
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iiidO&", kwlist1, &scales, &size_min, &size_step, &sigma, &PyBobSpExtrapolationBorder_Converter, &border)){
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iiidO&s", kwlist1, &scales, &size_min, &size_step, &sigma, &PyBobSpExtrapolationBorder_Converter, &border, &algorithm)){
     MultiscaleRetinex_doc.print_usage();
     return -1;
   }
   self->cxx.reset(new bob::ip::base::MultiscaleRetinex(scales, size_min, size_step, sigma, border));
+  self->cxx->setAlgorithm(gaussian_algorithm(algorithm));
   return 0;
 
   BOB_CATCH_MEMBER("cannot create MultiscaleRetinex", -1)
@@ -204,6 +207,54 @@ int PyBobIpBaseMultiscaleRetinex_setBorder(PyBobIpBaseMultiscaleRetinexObject* s
   BOB_CATCH_MEMBER("border could not be set", -1)
 }
 
+static auto reducedResolution = bob::extension::VariableDoc(
+  "reduced_resolution",
+  "bool",
+  "Should the large scales be computed at reduced resolution? (read and write access)",
+  "If enabled, the Gaussian of each scale whose kernel has a standard deviation of at least 4 pixels is computed on an image that is decimated with a Gaussian pyramid, and the result is bilinearly upsampled. "
+  "The number of decimation levels is chosen per scale such that the kernel still covers at least two pixels of the decimated image, which reduces the cost of these scales by a factor of 4 or more. "
+  "As the illumination is estimated from low frequencies only, the results differ only slightly from the full resolution results; by default, this mode is disabled."
+);
+PyObject* PyBobIpBaseMultiscaleRetinex_getReducedResolution(PyBobIpBaseMultiscaleRetinexObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getReducedResolution()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("reduced_resolution could not be read", 0)
+}
+int PyBobIpBaseMultiscaleRetinex_setReducedResolution(PyBobIpBaseMultiscaleRetinexObject* self, PyObject* value, void*){
+  BOB_TRY
+  int r = PyObject_IsTrue(value);
+  if (r < 0){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, reducedResolution.name());
+    return -1;
+  }
+  self->cxx->setReducedResolution(r>0);
+  return 0;
+  BOB_CATCH_MEMBER("reduced_resolution could not be set", -1)
+}
+
+static auto algorithm = bob::extension::VariableDoc(
+  "algorithm",
+  "str",
+  "The algorithm used by the Gaussians of all scales, one of ``'convolution'``, ``'recursive'`` or ``'automatic'``; with read and write access",
+  "With ``'recursive'``, the execution time of the large scales does not depend on their size, see :py:class:`bob.ip.base.Gaussian`."
+);
+PyObject* PyBobIpBaseMultiscaleRetinex_getAlgorithm(PyBobIpBaseMultiscaleRetinexObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("s", gaussian_algorithm(self->cxx->getAlgorithm()));
+  BOB_CATCH_MEMBER("algorithm could not be read", 0)
+}
+int PyBobIpBaseMultiscaleRetinex_setAlgorithm(PyBobIpBaseMultiscaleRetinexObject* self, PyObject* value, void*){
+  BOB_TRY
+  const char* a;
+  if (!PyArg_Parse(value, "s", &a)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a str", Py_TYPE(self)->tp_name, algorithm.name());
+    return -1;
+  }
+  self->cxx->setAlgorithm(gaussian_algorithm(a));
+  return 0;
+  BOB_CATCH_MEMBER("algorithm could not be set", -1)
+}
+
 static PyGetSetDef PyBobIpBaseMultiscaleRetinex_getseters[] = {
     {
       scales.name(),
@@ -240,6 +291,20 @@ static PyGetSetDef PyBobIpBaseMultiscaleRetinex_getseters[] = {
       border.doc(),
       0
     },
+    {
+      reducedResolution.name(),
+      (getter)PyBobIpBaseMultiscaleRetinex_getReducedResolution,
+      (setter)PyBobIpBaseMultiscaleRetinex_setReducedResolution,
+      reducedResolution.doc(),
+      0
+    },
+    {
+      algorithm.name(),
+      (getter)PyBobIpBaseMultiscaleRetinex_getAlgorithm,
+      (setter)PyBobIpBaseMultiscaleRetinex_setAlgorithm,
+      algorithm.doc(),
+      0
+    },
     {0}  /* Sentinel */
 };
 
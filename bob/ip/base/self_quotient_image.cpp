@@ -206,6 +206,53 @@ int PyBobIpBaseSelfQuotientImage_setBorder(PyBobIpBaseSelfQuotientImageObject* s
   BOB_CATCH_MEMBER("border could not be set", -1)
 }
 
+static auto threads = bob::extension::VariableDoc(
+  "threads",
+  "int",
+  "The number of threads that are used to process an image; with read and write access",
+  "The rows of the image are distributed over the given number of threads, each of which evaluates all scales for its rows; if ``0`` (the default), all available cores are used."
+);
+PyObject* PyBobIpBaseSelfQuotientImage_getThreads(PyBobIpBaseSelfQuotientImageObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getThreads());
+  BOB_CATCH_MEMBER("threads could not be read", 0)
+}
+int PyBobIpBaseSelfQuotientImage_setThreads(PyBobIpBaseSelfQuotientImageObject* self, PyObject* value, void*){
+  BOB_TRY
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, threads.name());
+    return -1;
+  }
+  self->cxx->setThreads(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("threads could not be set", -1)
+}
+
+static auto reducedResolution = bob::extension::VariableDoc(
+  "reduced_resolution",
+  "bool",
+  "Should the large scales be computed at reduced resolution? (read and write access)",
+  "If enabled, the weighted Gaussian of each scale whose kernel has a standard deviation of at least 4 pixels is evaluated only at every 2nd, 4th, ... pixel in both directions, and the result is bilinearly upsampled. "
+  "The decimation is chosen per scale such that the kernel still covers at least two sampling steps, which reduces the cost of these scales by a factor of 4 or more. "
+  "As the weighted Gaussian preserves edges, the results differ from the full resolution results close to strong edges; by default, this mode is disabled."
+);
+PyObject* PyBobIpBaseSelfQuotientImage_getReducedResolution(PyBobIpBaseSelfQuotientImageObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getReducedResolution()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("reduced_resolution could not be read", 0)
+}
+int PyBobIpBaseSelfQuotientImage_setReducedResolution(PyBobIpBaseSelfQuotientImageObject* self, PyObject* value, void*){
+  BOB_TRY
+  int r = PyObject_IsTrue(value);
+  if (r < 0){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, reducedResolution.name());
+    return -1;
+  }
+  self->cxx->setReducedResolution(r>0);
+  return 0;
+  BOB_CATCH_MEMBER("reduced_resolution could not be set", -1)
+}
+
 static PyGetSetDef PyBobIpBaseSelfQuotientImage_getseters[] = {
     {
       scales.name(),
@@ -242,6 +289,20 @@ static PyGetSetDef PyBobIpBaseSelfQuotientImage_getseters[] = {
       border.doc(),
       0
     },
+    {
+      reducedResolution.name(),
+      (getter)PyBobIpBaseSelfQuotientImage_getReducedResolution,
+      (setter)PyBobIpBaseSelfQuotientImage_setReducedResolution,
+      reducedResolution.doc(),
+      0
+    },
+    {
+      threads.name(),
+      (getter)PyBobIpBaseSelfQuotientImage_getThreads,
+      (setter)PyBobIpBaseSelfQuotientImage_setThreads,
+      threads.doc(),
+      0
+    },
     {0}  /* Sentinel */
 };
 
@@ -129,6 +129,34 @@ def test_extrapolate_random():
   assert numpy.allclose(image, fill_ref_image)
 
 
+def test_extrapolate_nearest():
+  # a mask that is not convex
+  mask = numpy.zeros((30, 40), numpy.bool)
+  mask[5:10, 5:35] = True
+  mask[5:25, 5:10] = True
+  mask[20:25, 25:38] = True
+  image = numpy.random.RandomState(7).randint(1, 255, mask.shape).astype(numpy.float64)
+  filled = image.copy()
+  bob.ip.base.extrapolate_mask(mask, filled, algorithm='nearest')
+  assert numpy.all(filled[mask] == image[mask])
+
+  # each pixel is filled with a value of one of the nearest valid pixels
+  valid = numpy.array(numpy.nonzero(mask)).T
+  for y, x in zip(*numpy.nonzero(~mask)):
+    distances = ((valid - (y, x))**2).sum(axis=1)
+    nearest = valid[distances == distances.min()]
+    assert filled[y, x] in image[nearest[:,0], nearest[:,1]]
+
+  # with random noise, the masked area is not touched, and values are taken from the valid pixels
+  filled = image.copy()
+  bob.ip.base.extrapolate_mask(mask, filled, random_sigma = 0., neighbors = 2, rng = bob.core.random.mt19937(42), algorithm='nearest')
+  assert numpy.all(filled[mask] == image[mask])
+  assert numpy.all(numpy.in1d(filled[~mask], image[mask]))
+
+  nose.tools.assert_raises(ValueError, bob.ip.base.extrapolate_mask, mask, filled, algorithm='unknown')
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.extrapolate_mask, numpy.zeros(mask.shape, numpy.bool), filled, algorithm='nearest')
+
+
 
 ###############################################
 ########## scaling ############################
@@ -203,6 +231,52 @@ def test_scale_non_round():
   assert numpy.allclose(scaled, 1.)
 
 
+def test_transform_interior():
+  # the interior and the border of the image are processed separately; check that both masked and unmasked versions agree
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("image.hdf5", "bob.ip.base"))
+  mask = numpy.ones(image.shape, numpy.bool)
+
+  for angle in (0., 10., -33., 90.):
+    shape = bob.ip.base.rotated_output_shape(image, angle)
+    rotated = numpy.ndarray(shape)
+    rotated_masked = numpy.ndarray(shape)
+    rotated_mask = numpy.ndarray(shape, numpy.bool)
+    bob.ip.base.rotate(image, rotated, angle)
+    bob.ip.base.rotate(image, mask, rotated_masked, rotated_mask, angle)
+    assert numpy.all(rotated[rotated_mask] == rotated_masked[rotated_mask])
+
+  # a constant image must stay constant in the valid region
+  constant = numpy.ones((285,193)) * 42.
+  scaled = bob.ip.base.scale(constant, 0.37)
+  assert numpy.allclose(scaled, 42.)
+
+
+def test_scale_area():
+  # large down-scaling factors first average blocks of pixels
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("image.hdf5", "bob.ip.base"))
+  image = image[:image.shape[0] // 8 * 8, :image.shape[1] // 8 * 8]
+  reduced = image.reshape(image.shape[0] // 8, 8, image.shape[1] // 8, 8).mean(axis=(1,3))
+  scaled = bob.ip.base.scale(image, 0.125, algorithm='area')
+  assert scaled.shape == reduced.shape
+  assert numpy.allclose(scaled, reduced)
+
+  # the remaining scale is handled with bi-linear interpolation
+  dst = numpy.ndarray((reduced.shape[0] * 9 // 10 + 1, reduced.shape[1] * 9 // 10 + 1))
+  bob.ip.base.scale(image, dst, algorithm='area')
+  ref = numpy.ndarray(dst.shape)
+  bob.ip.base.scale(reduced, ref)
+  assert numpy.allclose(dst, ref)
+
+  # a high-frequency pattern is averaged out, instead of producing aliasing
+  checkerboard = (numpy.indices((256,256)).sum(axis=0) % 2 * 255).astype(numpy.uint8)
+  assert numpy.allclose(bob.ip.base.scale(checkerboard, 1./8., algorithm='area'), 127.5)
+
+  # for small down-scaling factors, both algorithms are identical
+  assert numpy.all(bob.ip.base.scale(image, 0.7, algorithm='area') == bob.ip.base.scale(image, 0.7))
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.scale, image, 0.5, algorithm='unknown')
+
+
 
 ###############################################
 ########## rotating ###########################
@@ -241,6 +315,62 @@ def test_rotate_mask():
   raise SkipTest("This functionality is (yet) untested")
 
 
+def test_rotate_right_angle():
+  image = numpy.arange(35, dtype = numpy.float64).reshape((5,7))
+  for angle in (-270, -180, -90, 0, 90, 180, 270, 360, 450):
+    # rotations by multiples of 90 degrees are exact, and follow the orientation of numpy.rot90
+    rotated = bob.ip.base.rotate(image, angle)
+    assert (rotated == numpy.rot90(image, angle // 90)).all()
+    # the masks are rotated accordingly
+    mask = numpy.ones(image.shape, numpy.bool_)
+    mask[0,1] = False
+    rotated_mask = numpy.ndarray(rotated.shape, numpy.bool_)
+    bob.ip.base.rotate(image, mask, rotated, rotated_mask, angle)
+    assert (rotated == numpy.rot90(image, angle // 90)).all()
+    assert (rotated_mask == numpy.rot90(mask, angle // 90)).all()
+
+  # interleaved color images, converted to the dtype of dst
+  color = numpy.dstack((image, image + 100, image + 200)).astype(numpy.uint8)
+  rotated = bob.ip.base.rotate(color, 90, dtype = numpy.uint8, layout = 'interleaved')
+  assert rotated.dtype == numpy.uint8
+  assert (rotated == numpy.rot90(color)).all()
+
+  # square images can be rotated in place
+  square = numpy.arange(36, dtype = numpy.float64).reshape((6,6))
+  reference = numpy.rot90(square, 3)
+  bob.ip.base.rotate(square, square, -90)
+  assert (square == reference).all()
+
+
+def test_max_rect_in_mask():
+  mask = numpy.zeros((20, 30), numpy.bool)
+  mask[2:10, 5:25] = True
+  mask[4:18, 8:14] = True
+  assert bob.ip.base.max_rect_in_mask(mask) == (2, 5, 8, 20)
+  # several runs of true values in one row
+  mask[0:20, 27:30] = True
+  mask[2, 15] = False
+  assert bob.ip.base.max_rect_in_mask(mask) == (3, 5, 7, 20)
+  # the first of two rectangles with the same area is returned
+  mask = numpy.zeros((10, 10), numpy.bool)
+  mask[1:3, 5:8] = True
+  mask[5:8, 0:2] = True
+  assert bob.ip.base.max_rect_in_mask(mask) == (1, 5, 2, 3)
+  assert bob.ip.base.max_rect_in_mask(numpy.zeros((5, 5), numpy.bool)) == (0, 0, 0, 0)
+
+  # the mask of a rotated image
+  image = numpy.ones((120, 97))
+  shape = bob.ip.base.rotated_output_shape(image, 33.)
+  rotated, rotated_mask = numpy.ndarray(shape), numpy.ndarray(shape, numpy.bool)
+  bob.ip.base.rotate(image, numpy.ones(image.shape, numpy.bool), rotated, rotated_mask, 33.)
+  rect = bob.ip.base.max_rect_in_mask(rotated_mask)
+  assert numpy.all(rotated_mask[rect[0]:rect[0]+rect[2], rect[1]:rect[1]+rect[3]])
+
+  # bit-packed masks give the same result
+  assert bob.ip.base.max_rect_in_mask(numpy.packbits(rotated_mask, axis=1), rotated_mask.shape[1]) == rect
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.max_rect_in_mask, numpy.packbits(rotated_mask, axis=1), rotated_mask.shape[1] + 8)
+
+
 ###############################################
 ########## GeomNorm ###########################
 ###############################################
@@ -384,3 +514,198 @@ def test_face_eyes_norm():
   assert numpy.allclose(normalized, reference_image)
 
 
+
+def test_face_eyes_norm_batch():
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine"))
+  fen = bob.ip.base.FaceEyesNorm((40, 40), 20, (5/19.*40, 20))
+
+  right_eyes = numpy.array([(67,47), (60,40), (70.5,50.2)], numpy.float64)
+  left_eyes = numpy.array([(62,71), (60,75), (64.3,69.8)], numpy.float64)
+
+  # several faces in one image
+  processed = fen.extract_batch(test_image, right_eyes, left_eyes, threads = 2)
+  assert processed.shape == (3, 40, 40)
+  for i in range(3):
+    assert numpy.array_equal(processed[i], fen(test_image, tuple(right_eyes[i]), tuple(left_eyes[i])))
+
+  # one face per image, with masks
+  images = numpy.array([test_image, test_image[::-1], test_image * 0.5])
+  masks = images > 10
+  processed = numpy.ndarray((3, 40, 40))
+  processed_mask = numpy.ndarray((3, 40, 40), numpy.bool)
+  fen.extract_batch(images, masks, processed, processed_mask, right_eyes, left_eyes, threads = 3)
+  output = numpy.ndarray((40, 40))
+  output_mask = numpy.ndarray((40, 40), numpy.bool)
+  for i in range(3):
+    fen(images[i], masks[i], output, output_mask, tuple(right_eyes[i]), tuple(left_eyes[i]))
+    assert numpy.array_equal(processed[i], output)
+    assert numpy.array_equal(processed_mask[i], output_mask)
+
+  # the number of eye positions must fit
+  nose.tools.assert_raises(RuntimeError, fen.extract_batch, images, processed, right_eyes[:2], left_eyes[:2])
+
+
+def test_output_dtype():
+  # the geometric transformations can write uint8 and float32 images directly
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine"))
+  def _check(output, reference):
+    # integral outputs are rounded and saturated
+    if output.dtype == numpy.uint8:
+      assert numpy.array_equal(output, numpy.clip(numpy.floor(reference + 0.5), 0, 255))
+    else:
+      assert numpy.allclose(output, reference, rtol=1e-6)
+
+  fen = bob.ip.base.FaceEyesNorm((40, 40), 20, (5/19.*40, 20))
+  right_eyes = numpy.array([(67,47), (60,40)], numpy.float64)
+  left_eyes = numpy.array([(62,71), (60,75)], numpy.float64)
+  geom_norm = bob.ip.base.GeomNorm(-10., 0.65, (40, 40), (0, 0))
+
+  for dtype in (numpy.uint8, numpy.float32):
+    scaled = bob.ip.base.scale(test_image, 0.37, dtype=dtype)
+    assert scaled.dtype == dtype
+    _check(scaled, bob.ip.base.scale(test_image, 0.37))
+
+    rotated = bob.ip.base.rotate(test_image, 17., dtype=dtype)
+    assert rotated.dtype == dtype
+    _check(rotated, bob.ip.base.rotate(test_image, 17.))
+
+    processed = numpy.ndarray((40, 40), dtype)
+    reference = numpy.ndarray((40, 40))
+    geom_norm(test_image, processed, (54, 27))
+    geom_norm(test_image, reference, (54, 27))
+    _check(processed, reference)
+
+    face = fen(test_image, (67,47), (62,71), dtype=dtype)
+    assert face.dtype == dtype
+    _check(face, fen(test_image, (67,47), (62,71)))
+
+    faces = fen.extract_batch(test_image, right_eyes, left_eyes, dtype=dtype)
+    assert faces.dtype == dtype
+    _check(faces, fen.extract_batch(test_image, right_eyes, left_eyes))
+
+  # other output types are not supported
+  nose.tools.assert_raises(TypeError, bob.ip.base.scale, test_image, 0.5, dtype=numpy.int32)
+  nose.tools.assert_raises(TypeError, bob.ip.base.rotate, test_image, numpy.ndarray((10,10), numpy.int32), 10.)
+
+
+def test_color_layout():
+  # all color planes are transformed at once, both in planar and in interleaved layout
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine"))
+  planar = numpy.array((test_image, test_image[::-1], test_image * 0.5))
+  interleaved = planar.transpose(1,2,0).copy()
+
+  scaled = bob.ip.base.scale(planar, 0.37)
+  assert all(numpy.array_equal(scaled[i], bob.ip.base.scale(planar[i], 0.37)) for i in range(3))
+  assert numpy.array_equal(bob.ip.base.scale(interleaved, 0.37, layout='interleaved'), scaled.transpose(1,2,0))
+  assert numpy.array_equal(bob.ip.base.scale(interleaved, 0.2, algorithm='area', layout='interleaved'), bob.ip.base.scale(planar, 0.2, algorithm='area').transpose(1,2,0))
+
+  rotated = bob.ip.base.rotate(planar, 17., dtype=numpy.uint8)
+  assert all(numpy.array_equal(rotated[i], bob.ip.base.rotate(planar[i], 17., dtype=numpy.uint8)) for i in range(3))
+  assert numpy.array_equal(bob.ip.base.rotate(interleaved, 17., dtype=numpy.uint8, layout='interleaved'), rotated.transpose(1,2,0))
+
+  # masks are handled per color plane
+  mask = planar > 10
+  rotated = numpy.ndarray(rotated.shape)
+  rotated_mask = numpy.ndarray(rotated.shape, numpy.bool)
+  bob.ip.base.rotate(planar, mask, rotated, rotated_mask, -33.)
+  output = numpy.ndarray(rotated.shape[1:])
+  output_mask = numpy.ndarray(rotated.shape[1:], numpy.bool)
+  for i in range(3):
+    bob.ip.base.rotate(planar[i], mask[i], output, output_mask, -33.)
+    assert numpy.array_equal(rotated[i], output)
+    assert numpy.array_equal(rotated_mask[i], output_mask)
+
+  geom_norm = bob.ip.base.GeomNorm(-10., 0.65, (40, 40), (0, 0))
+  processed = numpy.ndarray((3, 40, 40))
+  geom_norm(planar, processed, (54, 27))
+  processed_interleaved = numpy.ndarray((40, 40, 3))
+  geom_norm(interleaved, processed_interleaved, (54, 27), layout='interleaved')
+  assert numpy.array_equal(processed_interleaved, processed.transpose(1,2,0))
+  output = numpy.ndarray((40, 40))
+  for i in range(3):
+    geom_norm(planar[i], output, (54, 27))
+    assert numpy.array_equal(processed[i], output)
+
+  fen = bob.ip.base.FaceEyesNorm((40, 40), 20, (5/19.*40, 20))
+  face = fen(planar, (67,47), (62,71))
+  assert all(numpy.array_equal(face[i], fen(planar[i], (67,47), (62,71))) for i in range(3))
+  assert numpy.array_equal(fen(interleaved, (67,47), (62,71), layout='interleaved'), face.transpose(1,2,0))
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.scale, planar, 0.5, layout='unknown')
+
+
+###############################################
+########## WarpPlan ###########################
+###############################################
+
+def test_warp_plan():
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r70.hdf5", "bob.ip.base", "data/affine"))
+  test_mask = test_image != 0
+
+  # the plan of a GeomNorm must reproduce its results exactly
+  geom_norm = bob.ip.base.GeomNorm(-70., 1.2, (160, 160), (80, 80))
+  plan = bob.ip.base.WarpPlan(geom_norm, test_image.shape, (64, 69))
+  assert plan.src_shape == test_image.shape
+  assert plan.crop_size == (160, 160)
+
+  processed = numpy.ndarray((160, 160))
+  geom_norm(test_image, processed, (64, 69))
+  assert numpy.array_equal(plan(test_image), processed)
+
+  # apply to several images of the same size
+  for factor in (0.5, 2.):
+    image = test_image * factor
+    geom_norm(image, processed, (64, 69))
+    assert numpy.array_equal(plan(image), processed)
+
+  # pixels outside of the image are never accessed
+  image = test_image.astype(numpy.float64)
+  image[0,0] = numpy.nan
+  geom_norm(image, processed, (64, 69))
+  planned = plan(image)
+  nans = numpy.isnan(processed)
+  assert numpy.sum(nans) < 4
+  assert numpy.array_equal(numpy.isnan(planned), nans)
+  assert numpy.array_equal(planned[~nans], processed[~nans])
+
+  # masked version
+  processed_mask = numpy.ndarray(processed.shape, numpy.bool)
+  planned = numpy.ndarray(processed.shape)
+  planned_mask = numpy.ndarray(processed.shape, numpy.bool)
+  geom_norm(test_image, test_mask, processed, processed_mask, (64, 69))
+  plan(test_image, test_mask, planned, planned_mask)
+  assert numpy.array_equal(planned, processed)
+  assert numpy.array_equal(planned_mask, processed_mask)
+
+  # the cached valid mask is the output mask for a full input mask
+  geom_norm(test_image, numpy.ones(test_image.shape, numpy.bool), processed, processed_mask, (64, 69))
+  assert numpy.array_equal(plan.valid_mask, processed_mask)
+
+  # the plan of a FaceEyesNorm
+  fen = bob.ip.base.FaceEyesNorm((40, 40), 20, (5/19.*40, 20))
+  right_eye, left_eye = (67,47), (62,71)
+  plan = bob.ip.base.WarpPlan(fen, test_image.shape, right_eye, left_eye)
+  assert numpy.array_equal(plan(test_image), fen(test_image, right_eye, left_eye))
+
+  # color images
+  color = numpy.array((test_image, test_image, test_image))
+  processed = plan(color)
+  assert processed.shape == (3, 40, 40)
+  assert all(numpy.array_equal(processed[i], processed[0]) for i in range(3))
+
+  # copy
+  assert numpy.array_equal(bob.ip.base.WarpPlan(plan)(test_image), processed[0])
+
+  # other output types are identical to the ones of FaceEyesNorm
+  for dtype in (numpy.uint8, numpy.float32):
+    face = fen(test_image, right_eye, left_eye, dtype=dtype)
+    planned = plan(test_image, dtype=dtype)
+    assert planned.dtype == dtype
+    assert numpy.array_equal(planned, face)
+    planned = numpy.ndarray((40, 40), dtype)
+    plan(test_image, planned)
+    assert numpy.array_equal(planned, face)
+  nose.tools.assert_raises(TypeError, plan, test_image, dtype=numpy.int32)
+
+  # wrong shape
+  nose.tools.assert_raises(RuntimeError, plan, test_image[1:])
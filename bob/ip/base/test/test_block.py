@@ -10,6 +10,7 @@
 """
 
 import numpy
+import nose.tools
 import bob.ip.base
 
 A_org    = numpy.array(range(1,17), 'float64').reshape((4,4))
@@ -36,3 +37,21 @@ def test_block():
   assert (B == A_ans_0_3D).all()
 
 
+def test_block_view():
+  # the view contains the same blocks as the copy
+  A = numpy.random.randint(0, 256, (13,17)).astype(numpy.uint8)
+  for size, overlap in (((2, 2), (0, 0)), ((4, 5), (3, 2)), ((8, 8), (7, 7))):
+    V = bob.ip.base.block(A, size, overlap, view = True)
+    assert V.shape == bob.ip.base.block_output_shape(A, size, overlap)
+    assert (V == bob.ip.base.block(A, size, overlap)).all()
+    # the view shares the memory with the input and cannot be modified
+    assert numpy.may_share_memory(V, A)
+    assert not V.flags.writeable
+
+  V = bob.ip.base.block(A_org, (2, 2), (0, 0), view = True)
+  assert (V == A_ans_0_4D).all()
+
+  # only new 4D views can be created
+  nose.tools.assert_raises(ValueError, bob.ip.base.block, A_org, (2, 2), (0, 0), flat = True, view = True)
+  nose.tools.assert_raises(ValueError, bob.ip.base.block, A_org, (2, 2), (0, 0), numpy.ndarray((2, 2, 2, 2)), view = True)
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.block, A_org, (5, 2), view = True)
@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# Sat Oct 17 20:51:26 CEST 2026
+#
+# Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+
+"""Tests the contrast limited adaptive histogram equalization
+"""
+
+import numpy
+import nose.tools
+import bob.ip.base
+
+def _clahe_reference(image, tiles, clip_limit):
+  # straightforward implementation: clipped tile histograms, and bi-linear blending between the tables of the tile centers
+  bins = 256 if image.dtype == numpy.uint8 else 65536
+  ty = [image.shape[0] * i // tiles[0] for i in range(tiles[0]+1)]
+  tx = [image.shape[1] * i // tiles[1] for i in range(tiles[1]+1)]
+  tables = numpy.ndarray((tiles[0], tiles[1], bins))
+  for i in range(tiles[0]):
+    for j in range(tiles[1]):
+      tile = image[ty[i]:ty[i+1], tx[j]:tx[j+1]]
+      hist = numpy.bincount(tile.flatten(), minlength=bins)
+      if clip_limit > 0.:
+        limit = max(int(clip_limit * tile.size / bins), 1)
+        clipped = numpy.sum(numpy.maximum(hist - limit, 0))
+        hist = numpy.minimum(hist, limit) + clipped // bins
+        residual = clipped % bins
+        if residual:
+          hist[0:bins:max(bins // residual, 1)][:residual] += 1
+      tables[i,j] = numpy.cumsum(hist) * (bins - 1.) / tile.size
+
+  def _weights(size, boundaries):
+    # the two tiles, whose centers surround each pixel, and the weight of the second one
+    centers = [(boundaries[i] + boundaries[i+1] - 1) / 2. for i in range(len(boundaries)-1)]
+    result = []
+    for p in range(size):
+      if p <= centers[0]: result.append((0, 0, 0.))
+      elif p >= centers[-1]: result.append((len(centers)-1, len(centers)-1, 0.))
+      else:
+        t = max(i for i in range(len(centers)) if centers[i] <= p)
+        result.append((t, t+1, (p - centers[t]) / (centers[t+1] - centers[t])))
+    return result
+
+  result = numpy.ndarray(image.shape, image.dtype)
+  for y, (y0, y1, wy) in enumerate(_weights(image.shape[0], ty)):
+    for x, (x0, x1, wx) in enumerate(_weights(image.shape[1], tx)):
+      v = image[y,x]
+      top = tables[y0,x0,v] + wx * (tables[y0,x1,v] - tables[y0,x0,v])
+      bottom = tables[y1,x0,v] + wx * (tables[y1,x1,v] - tables[y1,x0,v])
+      result[y,x] = int(top + wy * (bottom - top) + 0.5)
+  return result
+
+
+def test_parametrization():
+  op = bob.ip.base.CLAHE()
+  nose.tools.eq_(op.tiles, (8,8))
+  nose.tools.eq_(op.clip_limit, 2.)
+
+  op = bob.ip.base.CLAHE((4,6), 3.)
+  nose.tools.eq_(op.tiles, (4,6))
+  nose.tools.eq_(op.clip_limit, 3.)
+  op.tiles = (2,3)
+  op.clip_limit = 0.
+  nose.tools.eq_(op.tiles, (2,3))
+  nose.tools.eq_(op.clip_limit, 0.)
+
+  # copy construction and comparison
+  copy = bob.ip.base.CLAHE(op)
+  assert copy == op
+  copy.clip_limit = 1.
+  assert copy != op
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.CLAHE, (0,8))
+
+
+def test_processing():
+  random = numpy.random.RandomState(22)
+
+  # a single tile without clipping is a global histogram equalization
+  image = random.randint(0, 256, (60,80)).astype(numpy.uint8)
+  op = bob.ip.base.CLAHE((1,1), 0.)
+  result = op(image)
+  nose.tools.eq_(result.shape, image.shape)
+  nose.tools.eq_(result.dtype, numpy.uint8)
+  cdf = numpy.cumsum(numpy.bincount(image.flatten(), minlength=256))
+  assert (result == numpy.floor(cdf[image] * 255. / image.size + 0.5)).all()
+
+  # clipping: with 256 pixels and a clip limit of 2, each bin keeps at most 2 counts;
+  # the 2 * 126 clipped counts are spread over the bins 0 to 251, so that the cumulative histogram is 11 + 2 at value 10 and 201 + 4 at value 200
+  image = numpy.full((4,64), 10, numpy.uint8)
+  image[2:] = 200
+  result = bob.ip.base.CLAHE((1,1), 2.)(image)
+  assert (result[:2] == 13).all()   # 13 * 255 / 256 = 12.95
+  assert (result[2:] == 204).all()  # 205 * 255 / 256 = 204.2
+
+  # several tiles, with clipping and bi-linear blending between the tables of the surrounding tiles
+  low_contrast = random.randint(100, 121, (32,48)).astype(numpy.uint8)
+  image = random.randint(0, 256, (37,50)).astype(numpy.uint8)
+  for src, tiles, clip_limit in ((low_contrast, (2,2), 2.), (low_contrast, (2,2), 0.), (image, (3,4), 1.5), (image, (3,4), 4.)):
+    assert (bob.ip.base.CLAHE(tiles, clip_limit)(src) == _clahe_reference(src, tiles, clip_limit)).all()
+
+  # constant images are mapped to constant images
+  op = bob.ip.base.CLAHE((4,4))
+  result = op(numpy.full((40,48), 77, numpy.uint8))
+  assert (result == result[0,0]).all()
+
+  # the result does not depend on the number of threads
+  image = random.randint(0, 65536, (400,300)).astype(numpy.uint16)
+  op = bob.ip.base.CLAHE((5,7), 3.)
+  single = op.process(image, threads=1)
+  multi = numpy.ndarray(image.shape, numpy.uint16)
+  op.process(image, multi, threads=3)
+  assert (single == multi).all()
+
+  # wrong types and sizes
+  nose.tools.assert_raises(TypeError, op, image.astype(numpy.float64))
+  nose.tools.assert_raises(TypeError, op, image, numpy.ndarray(image.shape, numpy.uint8))
+  nose.tools.assert_raises(RuntimeError, op, numpy.ndarray((3,3), numpy.uint8))
@@ -9,6 +9,7 @@
 """
 
 import numpy
+import nose.tools
 import bob.ip.base
 
 A_org    = numpy.array(range(1,17), 'float64').reshape((4,4))
@@ -125,3 +126,39 @@ def test_3Doutput_and_2Doutput():
 
   
   
+
+
+def _dct_matrix(n):
+  # the orthonormal DCT-II
+  k, x = numpy.meshgrid(range(n), range(n), indexing='ij')
+  m = numpy.cos(numpy.pi * (2 * x + 1) * k / (2. * n)) * numpy.sqrt(2. / n)
+  m[0,:] /= numpy.sqrt(2.)
+  return m
+
+def test_pruned_dct():
+  # compare the pruned DCT with the full DCT of each block, for the common block sizes and others
+  numpy.random.seed(7)
+  data = numpy.random.random((41,53)) * 255.
+  for block, overlap in (((8,8), (0,0)), ((8,8), (4,2)), ((12,12), (6,6)), ((16,16), (0,0)), ((5,7), (1,3))):
+    h, w = block
+    full = []
+    for y in range(0, data.shape[0] - h + 1, h - overlap[0]):
+      for x in range(0, data.shape[1] - w + 1, w - overlap[1]):
+        b = data[y:y+h, x:x+w]
+        normalized = (b - b.mean()) / b.std()
+        full.append((_dct_matrix(h).dot(b).dot(_dct_matrix(w).T), _dct_matrix(h).dot(normalized).dot(_dct_matrix(w).T)))
+    for n in (4, 15, 16, 28):
+      for norm_block in (False, True):
+        # zigzag pattern
+        dst = bob.ip.base.DCTFeatures(n, block, overlap, norm_block)(data)
+        nose.tools.eq_(dst.shape, (len(full), n - norm_block))
+        for row, dct in zip(dst, full):
+          reference = numpy.ndarray((n,))
+          bob.ip.base.zigzag(dct[norm_block], reference)
+          assert numpy.allclose(row, reference[norm_block:], 1e-8, 1e-8)
+        # square pattern
+        s = int(numpy.sqrt(n))
+        if s * s == n:
+          dst = bob.ip.base.DCTFeatures(n, block, overlap, norm_block, False, True)(data)
+          for row, dct in zip(dst, full):
+            assert numpy.allclose(row, dct[norm_block][:s,:s].flatten()[norm_block:], 1e-8, 1e-8)
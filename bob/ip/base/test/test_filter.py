@@ -29,6 +29,47 @@ def test_median():
   dst = bob.ip.base.median(src, (1,1))
   assert numpy.allclose(ref, dst)
 
+
+def _median(src, radius):
+  # reference implementation of the median filter
+  height, width = src.shape[0] - 2*radius[0], src.shape[1] - 2*radius[1]
+  dst = numpy.ndarray((height, width), src.dtype)
+  for y in range(height):
+    for x in range(width):
+      dst[y,x] = numpy.sort(src[y:y+2*radius[0]+1, x:x+2*radius[1]+1], axis=None)[(2*radius[0]+1)*(2*radius[1]+1)//2]
+  return dst
+
+def test_median_algorithms():
+  # tests the different median filter algorithms for several radii and data types
+  random = numpy.random.RandomState(42)
+  for dtype, maximum in ((numpy.uint8, 256), (numpy.uint16, 65536), (numpy.float64, 1000)):
+    src = random.randint(0, maximum, (30,33)).astype(dtype)
+    for radius in ((1,1), (2,2), (0,3), (3,1), (4,4), (6,5)):
+      dst = bob.ip.base.median(src, radius)
+      nose.tools.eq_(dst.dtype, dtype)
+      assert (dst == _median(src, radius)).all()
+
+  # color images
+  src = random.randint(0, 256, (3,20,25)).astype(numpy.uint8)
+  dst = bob.ip.base.median(src, (3,3))
+  for p in range(3):
+    assert (dst[p] == _median(src[p], (3,3))).all()
+
+def _sobel(src, mode):
+  # reference implementation of the Sobel filters, extrapolating the image with numpy.pad in the given mode
+  kernel_y = numpy.array([[-1, -2, -1], [0, 0, 0], [1, 2, 1]])
+  kernel_x = kernel_y.T
+  height, width = src.shape
+  padded = numpy.pad(src.astype(numpy.float64), 1, mode)
+  dst = numpy.zeros((2, height, width))
+  for dy in range(3):
+    for dx in range(3):
+      # the convolution flips the kernels
+      window = padded[2-dy:2-dy+height, 2-dx:2-dx+width]
+      dst[0] += kernel_y[dy,dx] * window
+      dst[1] += kernel_x[dy,dx] * window
+  return dst
+
 def test_sobel():
   src = numpy.array([
       [0, 1, 2],
@@ -53,4 +94,24 @@ def test_sobel():
 
   assert numpy.allclose(dst, ref)
 
+  # integral images with integral output, and gradient magnitude and orientation
+  magnitude = numpy.ndarray(src.shape)
+  orientation = numpy.ndarray(src.shape)
+  dst = numpy.ndarray((2,3,3), numpy.int32)
+  bob.ip.base.sobel(src.astype(numpy.uint8), bob.sp.BorderType.Mirror, dst, magnitude, orientation)
+  assert (dst == ref).all()
+  assert numpy.allclose(magnitude, numpy.sqrt(ref[0]**2 + ref[1]**2))
+  assert numpy.allclose(orientation, numpy.arctan2(ref[0], ref[1]))
+
+  # all border types and data types of the source image are compared to the reference implementation
+  assert numpy.allclose(_sobel(src, 'symmetric'), ref)
+  image = numpy.random.RandomState(7).randint(0, 256, (20,25))
+  for border, mode in ((bob.sp.BorderType.Zero, 'constant'), (bob.sp.BorderType.NearestNeighbour, 'edge'), (bob.sp.BorderType.Circular, 'wrap'), (bob.sp.BorderType.Mirror, 'symmetric')):
+    ref = _sobel(image, mode)
+    assert numpy.allclose(bob.ip.base.sobel(image.astype(numpy.float64), border), ref)
+    assert numpy.allclose(bob.ip.base.sobel(image.astype(numpy.uint8), border), ref)
+    dst = numpy.ndarray((2,20,25), numpy.int32)
+    bob.ip.base.sobel(image.astype(numpy.uint16), border, dst)
+    assert (dst == ref).all()
+
 
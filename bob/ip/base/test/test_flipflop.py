@@ -45,3 +45,33 @@ def test_flop_3D():
   assert (B == A3_ans_flop).all()
   C = bob.ip.base.flop(A3_org)
   assert (C == A3_ans_flop).all()
+
+def test_flip_flop_in_place():
+  for dtype in (numpy.uint8, numpy.uint16, numpy.int32, numpy.float32, numpy.float64, numpy.bool_):
+    A = numpy.arange(3*5*7).reshape((3,5,7)).astype(dtype)
+    B = A.copy()
+    bob.ip.base.flip(B, B)
+    assert B.dtype == dtype
+    assert (B == A[:,::-1,:]).all()
+    B = A.copy()
+    bob.ip.base.flop(B, B)
+    assert (B == A[:,:,::-1]).all()
+    C = bob.ip.base.flop(A[0])
+    assert C.dtype == dtype
+    assert (C == A[0,:,::-1]).all()
+
+def test_flip_flop_numpy():
+  # types and dimensions that are not supported in C++ are flipped with numpy
+  A = numpy.arange(2*3*5*7).reshape((2,3,5,7))
+  for src in (A.astype(numpy.float16), A.astype(numpy.complex128), A[0].astype(numpy.float16)):
+    assert (bob.ip.base.flip(src) == src[...,::-1,:]).all()
+    assert (bob.ip.base.flop(src) == src[...,::-1]).all()
+  for src in (A, A.astype(numpy.float64)):
+    assert (bob.ip.base.flip(src) == src[:,:,::-1,:]).all()
+    assert (bob.ip.base.flop(src) == src[:,:,:,::-1]).all()
+  # destination of another type
+  B = numpy.ndarray((5,7), numpy.float64)
+  bob.ip.base.flip(A[0,0].astype(numpy.uint8), B)
+  assert (B == A[0,0,::-1,:]).all()
+  bob.ip.base.flop(A[0,0].astype(numpy.uint8), B)
+  assert (B == A[0,0,:,::-1]).all()
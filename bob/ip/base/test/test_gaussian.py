@@ -97,3 +97,48 @@ def test_comparison():
   assert op1 != op4
   assert op1 != op5
   assert op1 != op6
+
+
+def test_border_types():
+  # compare with a convolution of the image padded by numpy, including kernels that are larger than the image
+  def reference(image, gaussian, mode):
+    ky, kx = gaussian.kernel_y, gaussian.kernel_x
+    ry, rx = gaussian.radius
+    padded = numpy.pad(image.astype(numpy.float64), ((ry,ry), (rx,rx)), mode=mode)
+    tmp = sum(ky[k] * padded[k:k+image.shape[0], :] for k in range(len(ky)))
+    return sum(kx[k] * tmp[:, k:k+image.shape[1]] for k in range(len(kx)))
+
+  image = numpy.random.RandomState(42).randint(0, 65535, (7,11)).astype(numpy.uint16)
+  modes = {bob.sp.BorderType.Zero : 'constant', bob.sp.BorderType.NearestNeighbour : 'edge', bob.sp.BorderType.Circular : 'wrap', bob.sp.BorderType.Mirror : 'symmetric'}
+  for border, mode in modes.items():
+    for radius in ((1,2), (5,3), (9,15)):
+      gaussian = bob.ip.base.Gaussian((2.,3.), radius, border)
+      assert numpy.allclose(gaussian(image), reference(image, gaussian, mode))
+      # color images are filtered plane by plane
+      color = numpy.array([image, image[::-1]])
+      filtered = gaussian(color)
+      assert numpy.allclose(filtered[1], reference(image[::-1], gaussian, mode))
+
+
+def test_recursive():
+  image = numpy.random.RandomState(42).randint(0, 255, (40,60)).astype(numpy.uint8)
+  for border in (bob.sp.BorderType.Zero, bob.sp.BorderType.NearestNeighbour, bob.sp.BorderType.Circular, bob.sp.BorderType.Mirror):
+    for sigma in ((0.5, 1.), (3., 2.), (10., 25.)):
+      # the recursive approximation is close to a convolution with a kernel that is (almost) not truncated
+      convolution = bob.ip.base.Gaussian(sigma, (int(8*sigma[0]+1), int(8*sigma[1]+1)), border)
+      recursive = bob.ip.base.Gaussian(sigma, border=border, algorithm='recursive')
+      nose.tools.eq_(recursive.algorithm, 'recursive')
+      assert numpy.allclose(recursive(image), convolution(image), atol=0.1)
+
+  # the automatic algorithm uses the recursive approximation only for large sigmas
+  large = bob.ip.base.Gaussian((4.,5.), algorithm='automatic')
+  small = bob.ip.base.Gaussian((2.,5.), algorithm='automatic')
+  nose.tools.eq_(large.algorithm, 'automatic')
+  large_recursive = bob.ip.base.Gaussian((4.,5.), algorithm='recursive')
+  small_convolution = bob.ip.base.Gaussian((2.,5.))
+  assert (large(image) == large_recursive(image)).all()
+  assert (small(image) == small_convolution(image)).all()
+  assert large != large_recursive
+  large.algorithm = 'recursive'
+  assert large == large_recursive
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.Gaussian, (1.,1.), algorithm='unknown')
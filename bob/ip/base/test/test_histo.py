@@ -11,6 +11,7 @@
 import os
 import numpy
 import random
+import nose.tools
 
 import bob.io.base
 from bob.io.base.test_utils import datafile
@@ -154,6 +155,28 @@ def test_int32_histoPython():
   assert (histo_ref == histo2).all()
 
 
+def test_histogram_stack():
+  # Compare the histograms of large images and of 3D stacks with numpy
+  stack = numpy.random.randint(0, 256, (3, 400, 300)).astype(numpy.uint8)
+  histo_ref = numpy.bincount(stack.flatten(), minlength=256)
+  assert (bob.ip.base.histogram(stack) == histo_ref).all()
+  assert (bob.ip.base.histogram(stack[0]) == numpy.bincount(stack[0].flatten(), minlength=256)).all()
+  # non-contiguous images
+  assert (bob.ip.base.histogram(stack[:,:,::2]) == numpy.bincount(stack[:,:,::2].flatten(), minlength=256)).all()
+
+  # ranged histograms
+  values = numpy.random.random((3, 400, 300))
+  histo = bob.ip.base.histogram(values, (0., 1.), 10)
+  assert (histo == numpy.bincount(numpy.minimum((values.flatten() / 0.1).astype(int), 9), minlength=10)).all()
+  assert (bob.ip.base.histogram(values[1], (0., 1.), 1) == [values[1].size]).all()
+
+  # values out of range
+  stack[2,399,299] = 200
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.histogram, stack, 100)
+  values[1,200,100] = 1.5
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.histogram, values, (0., 1.), 10)
+
+
 def test_histogram_equalization():
   # Test that the histogram equalization function works as expected
   x = numpy.array(
@@ -186,3 +209,14 @@ def test_histogram_equalization():
     dtype = numpy.uint8)
 
   assert (x - y2_ref == 0).all()
+
+  # the largest value is mapped to the maximum of the range
+  x = numpy.array([[1, 4, 3], [5, 2, 2]], dtype = numpy.uint8)
+  bob.ip.base.histogram_equalization(x)
+  assert (x == numpy.array([[42, 212, 170], [255, 127, 127]], dtype = numpy.uint8)).all()
+
+  # black images stay black
+  x = numpy.zeros((4,5), dtype = numpy.uint8)
+  y = numpy.ones((4,5), dtype = numpy.uint16)
+  bob.ip.base.histogram_equalization(x, y)
+  assert (y == 0).all()
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# Sat Oct 17 19:02:11 CEST 2026
+#
+# Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+
+"""Tests the integral and the tilted integral images
+"""
+
+import numpy
+import nose.tools
+import bob.ip.base
+
+def test_integral():
+  # small images and images that are large enough to be processed in parallel
+  for shape in ((5,7), (600,500)):
+    src = numpy.random.randint(0, 256, shape).astype(numpy.uint8)
+    reference = numpy.cumsum(numpy.cumsum(src.astype(numpy.float64), 0), 1)
+    square = numpy.cumsum(numpy.cumsum(src.astype(numpy.float64)**2, 0), 1)
+
+    # the squared sums of the large image do not fit into 32 bit
+    for dtype in (numpy.float64, numpy.uint64, numpy.int32 if src.size < 1000 else numpy.int64):
+      for threads in (0, 1, 3):
+        dst = numpy.ndarray(shape, dtype)
+        sqr = numpy.ndarray(shape, dtype)
+        bob.ip.base.integral(src, dst, sqr, threads=threads)
+        assert (dst == reference.astype(dtype)).all()
+        assert (sqr == square.astype(dtype)).all()
+
+    # zero border
+    dst = numpy.ndarray((shape[0]+1, shape[1]+1), numpy.float64)
+    bob.ip.base.integral(src, dst, add_zero_border=True, threads=2)
+    assert (dst[0,:] == 0).all() and (dst[:,0] == 0).all()
+    assert (dst[1:,1:] == reference).all()
+
+    # floating point images
+    src = numpy.random.random(shape)
+    single = numpy.ndarray(shape, numpy.float64)
+    bob.ip.base.integral(src, single, threads=1)
+    multi = numpy.ndarray(shape, numpy.float64)
+    bob.ip.base.integral(src, multi, threads=3)
+    assert (single == multi).all()
+    assert numpy.allclose(single, numpy.cumsum(numpy.cumsum(src, 0), 1))
+
+
+def _tilted_integral(src):
+  # computes the tilted integral image by its definition
+  height, width = src.shape
+  dst = numpy.zeros((height+1, width+1))
+  for Y in range(height+1):
+    for X in range(width+1):
+      for y in range(Y):
+        left, right = max(X-1-(Y-y-1), 0), min(X-1+(Y-y-1), width-1)
+        if left <= right:
+          dst[Y,X] += src[y, left:right+1].sum()
+  return dst
+
+
+def test_tilted_integral():
+  src = numpy.random.randint(0, 100, (9,11)).astype(numpy.uint8)
+  dst = numpy.ndarray((10,12), numpy.int32)
+  bob.ip.base.tilted_integral(src, dst)
+  assert (dst == _tilted_integral(src)).all()
+
+  # sum of a rotated rectangle
+  y, x, w, h = 1, 4, 3, 2
+  rect = sum(int(src[yy,xx]) for yy in range(src.shape[0]) for xx in range(src.shape[1]) if 0 <= (yy-y)+(xx-x) < 2*w and 0 <= (yy-y)-(xx-x) < 2*h)
+  nose.tools.eq_(dst[y+w+h, x-h+w+1] - dst[y+w, x+w+1] - dst[y+h, x-h+1] + dst[y, x+1], rect)
+
+  # wrong shape
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.tilted_integral, src, numpy.ndarray((9,11), numpy.int32))
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# Sat Oct 17 21:48:09 CEST 2026
+#
+# Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+
+"""Tests the integral histogram
+"""
+
+import numpy
+import nose.tools
+import bob.ip.base
+
+def _random_rectangles(shape, count):
+  top = numpy.random.randint(0, shape[0]+1, count)
+  left = numpy.random.randint(0, shape[1]+1, count)
+  height = [numpy.random.randint(0, shape[0]-t+1) for t in top]
+  width = [numpy.random.randint(0, shape[1]-l+1) for l in left]
+  return numpy.array([top, left, height, width]).T
+
+
+def test_parametrization():
+  ih = bob.ip.base.IntegralHistogram(59)
+  nose.tools.eq_(ih.bins, 59)
+  nose.tools.eq_(ih.pixel_major, False)
+  nose.tools.eq_(ih.shape, (0,0))
+  ih.pixel_major = True
+  ih.bins = 10
+  nose.tools.eq_(ih.bins, 10)
+  nose.tools.eq_(ih.pixel_major, True)
+
+  # copy construction and comparison, including the computed integral histogram
+  ih.compute(numpy.random.randint(0, 10, (20,30)).astype(numpy.uint8))
+  nose.tools.eq_(ih.shape, (20,30))
+  copy = bob.ip.base.IntegralHistogram(ih)
+  assert copy == ih
+  copy.compute(numpy.random.randint(0, 10, (20,30)).astype(numpy.uint8))
+  assert copy != ih
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.IntegralHistogram, 0)
+
+
+def test_histograms():
+  image = numpy.random.randint(0, 59, (63,87)).astype(numpy.uint16)
+  values = numpy.random.random((63,87)) * 10. - 5.
+  rectangles = _random_rectangles(image.shape, 200)
+
+  for pixel_major in (False, True):
+    for threads in (1, 3):
+      ih = bob.ip.base.IntegralHistogram(59, pixel_major)
+      ih.compute(image, threads=threads)
+
+      # single rectangles
+      for rect in rectangles[:20]:
+        t, l, h, w = rect
+        reference = bob.ip.base.histogram(numpy.ascontiguousarray(image[t:t+h, l:l+w]), 59) if h and w else numpy.zeros(59)
+        assert (ih.histogram(tuple(rect)) == reference).all()
+
+      # the whole image
+      assert (ih.histogram((0, 0) + image.shape) == bob.ip.base.histogram(image, 59)).all()
+
+      # batched rectangles
+      hists = ih.histograms(rectangles, threads=threads)
+      nose.tools.eq_(hists.shape, (200,59))
+      for rect, hist in zip(rectangles, hists):
+        t, l, h, w = rect
+        assert (hist == numpy.bincount(image[t:t+h, l:l+w].flatten(), minlength=59)).all()
+      output = numpy.ndarray((200,59), numpy.uint64)
+      ih.histograms(rectangles.astype(numpy.int32), output, threads)
+      assert (output == hists).all()
+
+      # ranged bins
+      ih = bob.ip.base.IntegralHistogram(20, pixel_major)
+      ih.compute(values, (-5., 5.), threads=threads)
+      for rect, hist in zip(rectangles, ih.histograms(rectangles)):
+        t, l, h, w = rect
+        assert (hist == numpy.histogram(values[t:t+h, l:l+w], 20, (-5., 5.))[0]).all()
+
+  # errors
+  ih = bob.ip.base.IntegralHistogram(10)
+  nose.tools.assert_raises(RuntimeError, ih.histogram, (0,0,1,1))
+  nose.tools.assert_raises(RuntimeError, ih.compute, image)
+  ih.bins = 59
+  ih.compute(image)
+  nose.tools.assert_raises(RuntimeError, ih.histogram, (1,1,63,1))
+  nose.tools.assert_raises(RuntimeError, ih.histogram, (-1,0,1,1))
+  nose.tools.assert_raises(RuntimeError, ih.histograms, numpy.array([[0,0,1,1],[0,80,1,10]]))
+  nose.tools.assert_raises(TypeError, ih.histograms, rectangles.astype(numpy.float64))
+  nose.tools.assert_raises(RuntimeError, ih.compute, values)
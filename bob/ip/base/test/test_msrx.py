@@ -58,6 +58,51 @@ def test_processing():
   a_out2 = op(a_float64)
   assert numpy.allclose(a_out2, a_sqi_ref, eps, eps)
 
+def _illuminated_image():
+  # smooth illumination pattern with a gradient and some noise
+  y, x = numpy.mgrid[0:120, 0:160]
+  noise = numpy.random.RandomState(1).normal(0., 5., (120,160))
+  return numpy.clip(100. + 60. * numpy.sin(x/9.) * numpy.cos(y/13.) + 0.5 * x + noise, 0., 255.)
+
+def test_reduced_resolution():
+  # The reduced resolution mode smooths the large scales on a Gaussian pyramid
+  # With the output values being in the order of 0.1, the error of this approximation is:
+  # - on average about 0.003 (relative error of 3%)
+  # - at most about 0.05, mainly at the image borders
+  image = _illuminated_image()
+  op = bob.ip.base.MultiscaleRetinex(3,10,10,5.)
+  nose.tools.eq_(op.reduced_resolution, False)
+  exact = op(image)
+  op.reduced_resolution = True
+  nose.tools.eq_(op.reduced_resolution, True)
+  reduced = op(image)
+  difference = numpy.abs(reduced - exact)
+  assert numpy.mean(difference) < 0.01
+  assert numpy.max(difference) < 0.1
+  # small scales are not affected
+  op = bob.ip.base.MultiscaleRetinex(1,1,1,2.)
+  exact = op(image)
+  op.reduced_resolution = True
+  assert numpy.allclose(op(image), exact)
+
+def test_recursive():
+  # All scales use the given algorithm of the Gaussian
+  image = _illuminated_image()
+  op = bob.ip.base.MultiscaleRetinex(3,10,10,5., algorithm='recursive')
+  nose.tools.eq_(op.algorithm, 'recursive')
+  reference = numpy.zeros(image.shape)
+  for s in range(3):
+    size = 10 + s * 10
+    sigma = 5. * size / 10
+    gaussian = bob.ip.base.Gaussian((sigma, sigma), (size, size), bob.sp.BorderType.Mirror, algorithm='recursive')
+    reference += numpy.log(1. + image) - numpy.log(1. + gaussian(image))
+  assert numpy.allclose(op(image), reference / 3.)
+  assert op == bob.ip.base.MultiscaleRetinex(op)
+  assert op != bob.ip.base.MultiscaleRetinex(3,10,10,5.)
+  op.algorithm = 'convolution'
+  assert op == bob.ip.base.MultiscaleRetinex(3,10,10,5.)
+  nose.tools.assert_raises(RuntimeError, setattr, op, 'algorithm', 'unknown')
+
 def test_comparison():
 
   # Comparisons tests
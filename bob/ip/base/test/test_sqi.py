@@ -60,6 +60,40 @@ def test_processing():
   assert numpy.allclose(a_out2, a_sqi_ref, eps, eps)
 
 
+def test_multiscale():
+  # The multi-scale SQI must be identical to averaging the single scales computed by the weighted Gaussian
+  image = numpy.random.RandomState(3).randint(0, 256, (40,50)).astype(numpy.uint8)
+  for border in (bob.sp.BorderType.Mirror, bob.sp.BorderType.Zero, bob.sp.BorderType.Circular):
+    op = bob.ip.base.SelfQuotientImage(3,2,3,1.,border)
+    nose.tools.eq_(op.threads, 0)
+    reference = numpy.zeros(image.shape)
+    for s in range(3):
+      size = 2 + 3*s
+      wg = bob.ip.base.WeightedGaussian((size/2., size/2.), (size, size), border)
+      reference += numpy.log(image + 1.) - numpy.log(wg(image) + 1.)
+    reference /= 3.
+    assert numpy.allclose(op(image), reference, 1e-10, 1e-10)
+    op.threads = 3
+    assert numpy.allclose(op(image), reference, 1e-10, 1e-10)
+
+
+def test_reduced_resolution():
+  # The reduced resolution mode evaluates the weighted Gaussian of a large scale exactly at every 2nd (4th, ...) pixel,
+  # and interpolates bi-linearly in between; hence, the result at these samples is identical to the full resolution one
+  image = numpy.random.RandomState(5).randint(0, 256, (120,160)).astype(numpy.float64)
+  # the size and sigma of the scale, and the distance between the samples
+  for size, sigma, step in ((5, 2., 1), (15, 6., 2), (25, 10., 4)):
+    op = bob.ip.base.SelfQuotientImage(1,size,1,sigma)
+    nose.tools.eq_(op.reduced_resolution, False)
+    exact = op(image)
+    op.reduced_resolution = True
+    nose.tools.eq_(op.reduced_resolution, True)
+    reduced = op(image)
+    assert numpy.allclose(reduced[::step,::step], exact[::step,::step], 1e-10, 1e-10)
+    if step > 1:
+      assert not numpy.allclose(reduced, exact)
+
+
 def test_comparison():
   # Comparisons tests
   op1 = bob.ip.base.SelfQuotientImage(1,1,1,0.5)
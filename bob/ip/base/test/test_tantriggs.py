@@ -107,6 +107,44 @@ def test_processing():
   assert numpy.mean(numpy.abs(normalized.astype(numpy.float64) - reference_image.astype(numpy.float64))) / 255. < 6e-2
 
 
+def _tan_triggs(image, tt, mode):
+  # reference implementation using the dense DoG kernel
+  gamma = numpy.power(image.astype(numpy.float64), tt.gamma)
+  r = tt.radius
+  padded = numpy.pad(gamma, r, mode)
+  dog = numpy.zeros(image.shape)
+  for y in range(2*r+1):
+    for x in range(2*r+1):
+      dog += tt.kernel[y,x] * padded[y:y+image.shape[0], x:x+image.shape[1]]
+  dog /= numpy.mean(numpy.abs(dog) ** tt.alpha) ** (1./tt.alpha)
+  dog /= numpy.mean(numpy.minimum(tt.threshold ** tt.alpha, numpy.abs(dog) ** tt.alpha)) ** (1./tt.alpha)
+  return tt.threshold * numpy.tanh(dog / tt.threshold)
+
+def test_separable_dog():
+  # The separable implementation of the DoG filter must give the same results as the dense kernel
+  image = numpy.random.RandomState(5).randint(0, 256, (30,40)).astype(numpy.uint8)
+  for border, mode in ((bob.sp.BorderType.Zero, 'constant'), (bob.sp.BorderType.NearestNeighbour, 'edge'), (bob.sp.BorderType.Circular, 'wrap'), (bob.sp.BorderType.Mirror, 'symmetric')):
+    tt = bob.ip.base.TanTriggs(0.2, 1., 2., 4, 10., 0.1, border)
+    kernel = tt.kernel
+    nose.tools.eq_(kernel.shape, (9,9))
+    assert abs(numpy.sum(kernel)) < 1e-12
+    assert numpy.allclose(tt(image), _tan_triggs(image, tt, mode), 1e-8, 1e-8)
+
+
+def test_lookup_table():
+  # Integral images are transformed with lookup tables, which must give the same results as the floating point images
+  random = numpy.random.RandomState(7)
+  for image in (random.randint(0, 256, (40,50)).astype(numpy.uint8), random.randint(0, 65536, (300,300)).astype(numpy.uint16), random.randint(0, 65536, (10,12)).astype(numpy.uint16)):
+    nose.tools.eq_(bob.ip.base.gamma_correction(image, 0.3).tolist(), bob.ip.base.gamma_correction(image.astype(numpy.float64), 0.3).tolist())
+
+  # the tables are rebuilt when the parameters change
+  image = random.randint(0, 256, (30,40)).astype(numpy.uint8)
+  tt = bob.ip.base.TanTriggs(0.2, 1., 2., 4, 10., 0.1)
+  for gamma in (0.2, 0.5, 0.):
+    tt.gamma = gamma
+    assert numpy.allclose(tt(image), tt(image.astype(numpy.float64)), 1e-12, 1e-12)
+
+
 def test_comparison():
   # Comparisons tests
   op1 = bob.ip.base.TanTriggs(0.2,1.,2.,2,10.,0.1)
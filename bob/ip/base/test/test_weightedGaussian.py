@@ -54,6 +54,21 @@ def test_processing():
   assert numpy.allclose(a_out2, a_ref, eps, eps)
 
 
+def test_threads():
+  # the result must not depend on the number of threads
+  image = numpy.random.RandomState(7).randint(0, 256, (200,300)).astype(numpy.uint8)
+  op = bob.ip.base.WeightedGaussian((2., 3.), (5, 7))
+  nose.tools.eq_(op.threads, 0)
+  op.threads = 1
+  nose.tools.eq_(op.threads, 1)
+  single = op(image)
+  op.threads = 4
+  multi = op(image)
+  assert numpy.array_equal(single, multi)
+  # copy construction keeps the number of threads
+  nose.tools.eq_(bob.ip.base.WeightedGaussian(op).threads, 4)
+
+
 def _normalize(image):
   a = numpy.min(image)
   b = numpy.max(image)
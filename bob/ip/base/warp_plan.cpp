@@ -0,0 +1,374 @@
+/**
+ * @date Sat Oct 17 10:12:43 CEST 2026
+ *
+ * @brief Binds the WarpPlan class to python
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto WarpPlan_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".WarpPlan",
+  "Objects of this class cache a geometric normalization, so that it can be applied to many images of the same size",
+  "For each pixel of the normalized image, the positions of the four source pixels and their bi-linear interpolation weights are computed once. "
+  "Afterward, the normalization is applied to any image of size :py:attr:`src_shape` without recomputing the geometry. "
+  "The results are identical to the ones of :py:meth:`bob.ip.base.GeomNorm.process` and :py:meth:`bob.ip.base.FaceEyesNorm.extract`.\n\n"
+  "This is useful when the same normalization is applied over and over again, e.g., for fixed cameras or video streams."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Constructs a WarpPlan object",
+    "The plan can be computed from a :py:class:`bob.ip.base.GeomNorm` and a transformation center, or from a :py:class:`bob.ip.base.FaceEyesNorm` and the eye positions in the source image. "
+    "In both cases, the shape of the source images needs to be specified.",
+    true
+  )
+  .add_prototype("geom_norm, src_shape, center", "")
+  .add_prototype("face_eyes_norm, src_shape, right_eye, left_eye", "")
+  .add_prototype("other", "")
+  .add_parameter("geom_norm", ":py:class:`bob.ip.base.GeomNorm`", "The geometric normalization that should be cached")
+  .add_parameter("face_eyes_norm", ":py:class:`bob.ip.base.FaceEyesNorm`", "The face normalization that should be cached")
+  .add_parameter("src_shape", "(int, int)", "The shape of the images that the plan will be applied to")
+  .add_parameter("center", "(float, float)", "The transformation center in the source image; see :py:meth:`bob.ip.base.GeomNorm.process`")
+  .add_parameter("right_eye", "(float, float)", "The position of the right eye (or another landmark) in source image coordinates")
+  .add_parameter("left_eye", "(float, float)", "The position of the left eye (or another landmark) in source image coordinates")
+  .add_parameter("other", ":py:class:`WarpPlan`", "Another WarpPlan object to copy")
+);
+
+
+static int PyBobIpBaseWarpPlan_init(PyBobIpBaseWarpPlanObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = WarpPlan_doc.kwlist(0);
+  char** kwlist2 = WarpPlan_doc.kwlist(1);
+  char** kwlist3 = WarpPlan_doc.kwlist(2);
+
+  // get the number of command line arguments
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  switch (nargs){
+    case 1:{
+      // copy constructor
+      PyBobIpBaseWarpPlanObject* warpPlan;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist3, &PyBobIpBaseWarpPlan_Type, &warpPlan)){
+        WarpPlan_doc.print_usage();
+        return -1;
+      }
+      self->cxx.reset(new bob::ip::base::WarpPlan(*warpPlan->cxx));
+      return 0;
+    }
+    case 3:{
+      // from GeomNorm
+      PyBobIpBaseGeomNormObject* geomNorm;
+      blitz::TinyVector<int,2> shape;
+      blitz::TinyVector<double,2> center;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!(ii)(dd)", kwlist1, &PyBobIpBaseGeomNorm_Type, &geomNorm, &shape[0], &shape[1], &center[0], &center[1])){
+        WarpPlan_doc.print_usage();
+        return -1;
+      }
+      self->cxx.reset(new bob::ip::base::WarpPlan(*geomNorm->cxx, shape, center));
+      return 0;
+    }
+    case 4:{
+      // from FaceEyesNorm
+      PyBobIpBaseFaceEyesNormObject* faceEyesNorm;
+      blitz::TinyVector<int,2> shape;
+      blitz::TinyVector<double,2> right, left;
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!(ii)(dd)(dd)", kwlist2, &PyBobIpBaseFaceEyesNorm_Type, &faceEyesNorm, &shape[0], &shape[1], &right[0], &right[1], &left[0], &left[1])){
+        WarpPlan_doc.print_usage();
+        return -1;
+      }
+      self->cxx.reset(new bob::ip::base::WarpPlan(*faceEyesNorm->cxx, shape, right, left));
+      return 0;
+    }
+    default:
+      WarpPlan_doc.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' got an unsupported number of parameters", Py_TYPE(self)->tp_name);
+      return -1;
+  }
+
+  BOB_CATCH_MEMBER("cannot create WarpPlan object", -1)
+}
+
+static void PyBobIpBaseWarpPlan_delete(PyBobIpBaseWarpPlanObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseWarpPlan_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseWarpPlan_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto srcShape = bob::extension::VariableDoc(
+  "src_shape",
+  "(int, int)",
+  "The shape of the images that this plan can be applied to, read access only"
+);
+PyObject* PyBobIpBaseWarpPlan_getSrcShape(PyBobIpBaseWarpPlanObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getSourceShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("src_shape could not be read", 0)
+}
+
+static auto cropSize = bob::extension::VariableDoc(
+  "crop_size",
+  "(int, int)",
+  "The size of the processed image, read access only"
+);
+PyObject* PyBobIpBaseWarpPlan_getCropSize(PyBobIpBaseWarpPlanObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getTargetShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("crop_size could not be read", 0)
+}
+
+static auto validMask = bob::extension::VariableDoc(
+  "valid_mask",
+  "array_like (2D, bool)",
+  "The pixels of the processed image that are interpolated from pixels inside of the source image only, read access only",
+  "This is identical to the ``output_mask`` that is computed by :py:meth:`process` when the ``input_mask`` is all ``True``."
+);
+PyObject* PyBobIpBaseWarpPlan_getValidMask(PyBobIpBaseWarpPlanObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getValidMask());
+  BOB_CATCH_MEMBER("valid_mask could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseWarpPlan_getseters[] = {
+    {
+      srcShape.name(),
+      (getter)PyBobIpBaseWarpPlan_getSrcShape,
+      0,
+      srcShape.doc(),
+      0
+    },
+    {
+      cropSize.name(),
+      (getter)PyBobIpBaseWarpPlan_getCropSize,
+      0,
+      cropSize.doc(),
+      0
+    },
+    {
+      validMask.name(),
+      (getter)PyBobIpBaseWarpPlan_getValidMask,
+      0,
+      validMask.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto process = bob::extension::FunctionDoc(
+  "process",
+  "This function applies the cached geometric normalization to the given image",
+  "The ``output`` image can be of type numpy.uint8, numpy.float32 or numpy.float64; for numpy.uint8, the interpolated values are rounded and saturated. "
+  "When the ``output`` is returned, its type can be selected with the ``dtype`` parameter, which can only be given as a keyword argument.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("input, [dtype]", "output")
+.add_prototype("input, output")
+.add_prototype("input, input_mask, output, output_mask")
+.add_parameter("input", "array_like (2D or 3D)", "The input image, which must be of size :py:attr:`src_shape`")
+.add_parameter("output", "array_like (2D or 3D, uint8, float32 or float64)", "The output image, which must be of size :py:attr:`crop_size`")
+.add_parameter("input_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
+.add_parameter("output_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``output``")
+.add_parameter("dtype", ":py:class:`numpy.dtype`", "[Default: ``numpy.float64``] The data type of the returned ``output`` image; one of ``numpy.uint8``, ``numpy.float32`` or ``numpy.float64``")
+.add_return("output", "array_like (2D or 3D)", "The resulting normalized image, which is of size :py:attr:`crop_size`")
+;
+
+template <typename T, typename U, int D>
+static void process_inner(PyBobIpBaseWarpPlanObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask){
+  if (input_mask && output_mask){
+    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask));
+  } else {
+    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,D>(output));
+  }
+}
+
+template <typename T, int D>
+static void process_inner(PyBobIpBaseWarpPlanObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask){
+  switch (output->type_num){
+    case NPY_UINT8:   process_inner<T,uint8_t,D>(self, input, input_mask, output, output_mask); break;
+    case NPY_FLOAT32: process_inner<T,float,D>(self, input, input_mask, output, output_mask); break;
+    default:          process_inner<T,double,D>(self, input, input_mask, output, output_mask); break;
+  }
+}
+
+static PyObject* PyBobIpBaseWarpPlan_process(PyBobIpBaseWarpPlanObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist1 = process.kwlist(0);
+  char** kwlist2 = process.kwlist(1);
+  char** kwlist3 = process.kwlist(2);
+
+  // get the number of command line arguments, without the optional data type
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (kwargs && PyDict_GetItemString(kwargs, "dtype")) --nargs;
+
+  PyBlitzArrayObject* input = 0,* input_mask = 0,* output = 0,* output_mask = 0;
+  int type_num = NPY_FLOAT64;
+
+  switch (nargs){
+    case 1:{
+      // with input only
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&", kwlist1, &PyBlitzArray_Converter, &input, &PyBlitzArray_TypenumConverter, &type_num)){
+        process.print_usage();
+        return 0;
+      }
+      break;
+    }
+    case 2:{
+      // with input and output
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&", kwlist2, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output)){
+        process.print_usage();
+        return 0;
+      }
+      break;
+    }
+    case 4:{
+      // with mask
+      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_OutputConverter, &output_mask)){
+        process.print_usage();
+        return 0;
+      }
+      break;
+    }
+    default:{
+      process.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' process called with wrong number of parameters", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } // switch
+
+  auto input_ = make_safe(input), output_ = make_xsafe(output);
+  auto input_mask_ = make_xsafe(input_mask), output_mask_ = make_xsafe(output_mask);
+
+  if (input->ndim != 2 && input->ndim != 3){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D or 3D arrays", Py_TYPE(self)->tp_name);
+    process.print_usage();
+    return 0;
+  }
+
+  if (output){
+    // check that data type is correct and dimensions fit
+    if (output->ndim != input->ndim){
+      PyErr_Format(PyExc_TypeError, "`%s' processes only input and output arrays with the same number of dimensions", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+    if (output->type_num != NPY_UINT8 && output->type_num != NPY_FLOAT32 && output->type_num != NPY_FLOAT64){
+      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type uint8, float32 or float64", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+  } else {
+    if (type_num != NPY_UINT8 && type_num != NPY_FLOAT32 && type_num != NPY_FLOAT64){
+      PyErr_Format(PyExc_TypeError, "'%s': the 'dtype' must be uint8, float32 or float64", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+    // create output in the desired dimensions
+    auto shape = self->cxx->getTargetShape();
+    if (input->ndim == 2){
+      Py_ssize_t n[] = {shape[0], shape[1]};
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 2, n));
+    } else {
+      Py_ssize_t n[] = {input->shape[0], shape[0], shape[1]};
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
+    }
+    output_ = make_safe(output);
+  }
+
+  if (input_mask && output_mask){
+    if (input_mask->ndim != input->ndim || output_mask->ndim != output->ndim){
+      PyErr_Format(PyExc_TypeError, "`%s' masks must have the same shape as the input matrix", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+    if (input_mask->type_num != NPY_BOOL || output_mask->type_num != NPY_BOOL){
+      PyErr_Format(PyExc_TypeError, "`%s' masks must be of boolean type", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+  }
+
+  // finally, process the data
+  switch (input->type_num){
+    case NPY_UINT8:   if (input->ndim == 2) process_inner<uint8_t,2>(self, input, input_mask, output, output_mask);  else process_inner<uint8_t,3>(self, input, input_mask, output, output_mask); break;
+    case NPY_UINT16:  if (input->ndim == 2) process_inner<uint16_t,2>(self, input, input_mask, output, output_mask); else process_inner<uint16_t,3>(self, input, input_mask, output, output_mask); break;
+    case NPY_FLOAT64: if (input->ndim == 2) process_inner<double,2>(self, input, input_mask, output, output_mask);   else process_inner<double,3>(self, input, input_mask, output, output_mask); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      process.print_usage();
+      return 0;
+  }
+
+  if (nargs == 1){
+    return PyBlitzArray_AsNumpyArray(output,0);
+  }
+
+  Py_RETURN_NONE;
+
+  BOB_CATCH_MEMBER("cannot process image", 0)
+}
+
+static PyMethodDef PyBobIpBaseWarpPlan_methods[] = {
+  {
+    process.name(),
+    (PyCFunction)PyBobIpBaseWarpPlan_process,
+    METH_VARARGS|METH_KEYWORDS,
+    process.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the WarpPlan type struct; will be initialized later
+PyTypeObject PyBobIpBaseWarpPlan_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseWarpPlan(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseWarpPlan_Type.tp_name = WarpPlan_doc.name();
+  PyBobIpBaseWarpPlan_Type.tp_basicsize = sizeof(PyBobIpBaseWarpPlanObject);
+  PyBobIpBaseWarpPlan_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseWarpPlan_Type.tp_doc = WarpPlan_doc.doc();
+
+  // set the functions
+  PyBobIpBaseWarpPlan_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseWarpPlan_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseWarpPlan_init);
+  PyBobIpBaseWarpPlan_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseWarpPlan_delete);
+  PyBobIpBaseWarpPlan_Type.tp_methods = PyBobIpBaseWarpPlan_methods;
+  PyBobIpBaseWarpPlan_Type.tp_getset = PyBobIpBaseWarpPlan_getseters;
+  PyBobIpBaseWarpPlan_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseWarpPlan_process);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseWarpPlan_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseWarpPlan_Type);
+  return PyModule_AddObject(module, "WarpPlan", (PyObject*)&PyBobIpBaseWarpPlan_Type) >= 0;
+}
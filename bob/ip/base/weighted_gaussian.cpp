@@ -171,6 +171,30 @@ int PyBobIpBaseWeightedGaussian_setBorder(PyBobIpBaseWeightedGaussianObject* sel
   BOB_CATCH_MEMBER("border could not be set", -1)
 }
 
+static auto threads = bob::extension::VariableDoc(
+  "threads",
+  "int",
+  "The number of threads that are used to filter an image, with read and write access",
+  "The rows of the image are distributed over the given number of threads; if ``0`` (the default), all available cores are used. "
+  "Small images are always processed in a single thread."
+);
+PyObject* PyBobIpBaseWeightedGaussian_getThreads(PyBobIpBaseWeightedGaussianObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getThreads());
+  BOB_CATCH_MEMBER("threads could not be read", 0)
+}
+int PyBobIpBaseWeightedGaussian_setThreads(PyBobIpBaseWeightedGaussianObject* self, PyObject* value, void*){
+  BOB_TRY
+  int t;
+  if (!PyArg_Parse(value, "i", &t)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an integer", Py_TYPE(self)->tp_name, threads.name());
+    return -1;
+  }
+  self->cxx->setThreads(t);
+  return 0;
+  BOB_CATCH_MEMBER("threads could not be set", -1)
+}
+
 static PyGetSetDef PyBobIpBaseWeightedGaussian_getseters[] = {
     {
       sigma.name(),
@@ -193,6 +217,13 @@ static PyGetSetDef PyBobIpBaseWeightedGaussian_getseters[] = {
       border.doc(),
       0
     },
+    {
+      threads.name(),
+      (getter)PyBobIpBaseWeightedGaussian_getThreads,
+      (setter)PyBobIpBaseWeightedGaussian_setThreads,
+      threads.doc(),
+      0
+    },
     {0}  /* Sentinel */
 };
 
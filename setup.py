@@ -18,7 +18,7 @@ version = open("version.txt").read().rstrip()
 
 import os
 packages = ['boost']
-boost_modules = ['system']
+boost_modules = ['system', 'thread']
 
 class vl:
 
@@ -116,11 +116,14 @@ setup(
         [
           "bob/ip/base/cpp/GeomNorm.cpp",
           "bob/ip/base/cpp/FaceEyesNorm.cpp",
+          "bob/ip/base/cpp/WarpPlan.cpp",
           "bob/ip/base/cpp/Affine.cpp",
           "bob/ip/base/cpp/LBP.cpp",
           "bob/ip/base/cpp/LBPTop.cpp",
           "bob/ip/base/cpp/DCTFeatures.cpp",
           "bob/ip/base/cpp/TanTriggs.cpp",
+          "bob/ip/base/cpp/CLAHE.cpp",
+          "bob/ip/base/cpp/IntegralHistogram.cpp",
           "bob/ip/base/cpp/Gaussian.cpp",
           "bob/ip/base/cpp/MultiscaleRetinex.cpp",
           "bob/ip/base/cpp/WeightedGaussian.cpp",
@@ -146,11 +149,14 @@ setup(
           "bob/ip/base/auxiliary.cpp",
           "bob/ip/base/geom_norm.cpp",
           "bob/ip/base/face_eyes_norm.cpp",
+          "bob/ip/base/warp_plan.cpp",
           "bob/ip/base/affine.cpp",
           "bob/ip/base/lbp.cpp",
           "bob/ip/base/lbp_top.cpp",
           "bob/ip/base/dct_features.cpp",
           "bob/ip/base/tan_triggs.cpp",
+          "bob/ip/base/clahe.cpp",
+          "bob/ip/base/integral_histogram.cpp",
           "bob/ip/base/gaussian.cpp",
           "bob/ip/base/multiscale_retinex.cpp",
           "bob/ip/base/weighted_gaussian.cpp",